@@ -2,11 +2,23 @@
 //umbrella
 
 #include "Candy/Core/CSVWriter.hpp"
+#include "Candy/Core/CSVIndex.hpp"
 #include "Candy/Core/CANKernelTypes.hpp"
 #include "Candy/Core/Frame/FrameIterator.hpp"
 #include "Candy/Core/Frame/FramePacket.hpp"
+#include "Candy/Core/Frame/FramePacketEncoder.hpp"
+#include "Candy/Core/Frame/FramePacketPool.hpp"
+#include "Candy/Core/Frame/CANIdIndex.hpp"
+#include "Candy/Core/Frame/FrameRing.hpp"
+#include "Candy/Core/Frame/PacketFraming.hpp"
+#include "Candy/Core/Link/UDPPacketLink.hpp"
+#include "Candy/Core/Source/SocketCANSource.hpp"
+#include "Candy/Core/Source/CSVFrameReader.hpp"
 #include "Candy/Core/CANHelpers.hpp"
 #include "Candy/Core/Signal/SignalCodec.hpp"
+#include "Candy/Core/Signal/SignalBatch.hpp"
+#include "Candy/Core/Signal/DecodeTable.hpp"
+#include "Candy/Core/Signal/StaticSignalCodec.hpp"
 #include "Candy/Core/Signal/NumericValue.hpp"
 #include "Candy/Core/CANIOHelperTypes.hpp"
 
@@ -17,6 +29,7 @@
 #include "Candy/DBCInterpreters/DBC/DBCInterpreterConcepts.hpp"
 #include "Candy/DBCInterpreters/MotecGenerator.hpp"
 #include "Candy/DBCInterpreters/LoggingTranscoder.hpp"
+#include "Candy/DBCInterpreters/CodecGenerator.hpp"
 #include "Candy/DBCInterpreters/V2C/TranslatedMultiplexer.hpp"
 #include "Candy/DBCInterpreters/V2C/TranslatedMessage.hpp"
 #include "Candy/DBCInterpreters/V2C/TranslatedSignal.hpp"
@@ -26,6 +39,10 @@
 #include "Candy/DBCInterpreters/File/FileTranscoderConcepts.hpp"
 #include "Candy/DBCInterpreters/SQLTranscoder.hpp"
 #include "Candy/DBCInterpreters/CSVTranscoder.hpp"
+#include "Candy/DBCInterpreters/ColumnarTranscoder.hpp"
+#include "Candy/DBCInterpreters/ArrowTranscoder.hpp"
+#include "Candy/DBCInterpreters/MDFTranscoder.hpp"
+#include "Candy/DBCInterpreters/MotecTranscoder.hpp"
 #include "Candy/DBCInterpreters/V2CTranscoder.hpp"
 
 #endif // CANDY_BUILD_CORE_ONLY
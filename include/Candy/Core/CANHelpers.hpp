@@ -1,5 +1,7 @@
 #pragma once 
 
+#include <algorithm>
+#include <cstring>
 #include <random>
 
 #include "Candy/Core/CANKernelTypes.hpp"
@@ -31,6 +33,32 @@ namespace Candy {
         return frame;
     }
 
+    // classic frame in the dual-use CANFlexibleFrame layout: CANFD_FDF clear,
+    // payload zero padded to CANFD_MAX_DLEN
+    inline CANFlexibleFrame widen_frame(const CANFrame& frame) {
+        CANFlexibleFrame wide {};
+        wide.can_id = frame.can_id;
+        wide.length = std::min<uint8_t>(frame.len, CAN_MAX_DLEN);
+        wide.__res0 = frame.__res0;
+        std::memcpy(wide.data, frame.data, CAN_MAX_DLEN);
+        return wide;
+    }
+
+    // the first CAN_MAX_DLEN bytes of a dual-use CANFlexibleFrame as a classic frame
+    inline CANFrame narrow_frame(const CANFlexibleFrame& frame) {
+        CANFrame narrow {};
+        std::memcpy(&narrow, &frame, sizeof(CANFrame));
+        narrow.len = std::min<uint8_t>(frame.length, CAN_MAX_DLEN);
+        narrow.__pad = 0;
+        return narrow;
+    }
+
+    // zeroes the bytes past the frame's length so decodes never see stale data
+    inline void clear_padding(CANFlexibleFrame& frame) {
+        size_t len = std::min<size_t>(frame.length, CANFD_MAX_DLEN);
+        std::memset(frame.data + len, 0, CANFD_MAX_DLEN - len);
+    }
+
     inline std::string transmit_file(const std::string& dbc_path) {
         FILE* file = fopen(dbc_path.c_str(), "rb");
         if (!file) return "";
@@ -22,6 +22,11 @@ namespace Candy {
             static_cast<Derived&>(*this).receive_raw_message(sample);
         }
 
+        // only instantiated for receivers that also take CAN FD frames
+        void receive_raw_message_vrtl(const std::pair<CANTime, CANFlexibleFrame>& sample) {
+            static_cast<Derived&>(*this).receive_raw_message(sample);
+        }
+
         CANReceivable() {
             static_assert(IsCANReceivable<Derived>, "Derived must satisfy IsCANReceivable concept");
         }
@@ -66,9 +66,10 @@ namespace Candy {
         Unit unit;
         std::optional<unsigned> mux_val;
         bool is_multiplexer = false;
-        NumericValueType value_type = NumericValueType::f64;
+        // from SIG_VALTYPE_; without one DecodeTable reads the signal as an integer
+        std::optional<NumericValueType> value_type;
         
-        SignalDefinition() : name{}, codec{}, numeric_value{}, min_val(0.0), max_val(0.0), unit{}, mux_val{}, is_multiplexer(false), value_type(NumericValueType::f64) {}
+        SignalDefinition() : name{}, codec{}, numeric_value{}, min_val(0.0), max_val(0.0), unit{}, mux_val{}, is_multiplexer(false), value_type{} {}
         
         std::string_view get_name() const {
             return std::string_view(name.data(), strnlen(name.data(), name.size()));
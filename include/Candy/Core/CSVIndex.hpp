@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+
+namespace Candy {
+
+    // One block of CSV rows holding can_id, as a byte range of the CSV file
+    // and the time span of those rows. A block may also hold other ids.
+    struct CSVIndexEntry {
+        uint64_t offset;
+        uint32_t length;
+        canid_t can_id;
+        int64_t first_ms;
+        int64_t last_ms;
+    };
+
+    static_assert(sizeof(CSVIndexEntry) == 32);
+
+    // can_id of the entry closing each append(), spanning the blocks it
+    // indexed; no frame has every flag bit set
+    constexpr canid_t csv_index_block_end = 0xFFFFFFFF;
+
+    // Appends fixed-size CSVIndexEntry records to "<csv path>.idx". The
+    // offsets are only meaningful once the CSV itself has been flushed.
+    class CSVIndexWriter {
+    public:
+        static std::optional<CSVIndexWriter> create(const std::string& csv_path) {
+            std::string path = csv_path + ".idx";
+            FILE* f = fopen(path.c_str(), "wb");
+            if (!f) {
+                printf("CSVIndexWriter: Failed to open file %s for writing.\n", path.c_str());
+                return std::nullopt;
+            }
+            return CSVIndexWriter(f);
+        }
+
+        ~CSVIndexWriter() {
+            if (file) fclose(file);
+        }
+
+        CSVIndexWriter(const CSVIndexWriter&) = delete;
+        CSVIndexWriter& operator=(const CSVIndexWriter&) = delete;
+
+        CSVIndexWriter(CSVIndexWriter&& other) : file(other.file) {
+            other.file = nullptr;
+        }
+
+        CSVIndexWriter& operator=(CSVIndexWriter&& other) {
+            if (this != &other) {
+                if (file) fclose(file);
+                file = other.file;
+                other.file = nullptr;
+            }
+            return *this;
+        }
+
+        bool append(std::span<const CSVIndexEntry> entries) {
+            if (!file) return false;
+            if (entries.empty()) return true;
+
+            CSVIndexEntry block_end = entries.front();
+            uint64_t end = 0;
+            for (const CSVIndexEntry& entry : entries) {
+                block_end.offset = std::min(block_end.offset, entry.offset);
+                block_end.first_ms = std::min(block_end.first_ms, entry.first_ms);
+                block_end.last_ms = std::max(block_end.last_ms, entry.last_ms);
+                end = std::max(end, entry.offset + entry.length);
+            }
+            block_end.length = static_cast<uint32_t>(end - block_end.offset);
+            block_end.can_id = csv_index_block_end;
+
+            return fwrite(entries.data(), sizeof(CSVIndexEntry), entries.size(), file) == entries.size() &&
+                   fwrite(&block_end, sizeof(CSVIndexEntry), 1, file) == 1;
+        }
+
+        bool flush() {
+            if (!file) return false;
+            return fflush(file) == 0;
+        }
+
+    private:
+        explicit CSVIndexWriter(FILE* f) : file(f) {}
+
+        FILE* file;
+    };
+
+    // The entries of "<csv path>.idx" for can_id overlapping [start_ms, end_ms],
+    // in file order. nullopt when the CSV has no index, or a stale one: a torn
+    // record, or closed blocks that don't end exactly at csv_size, the CSV's length.
+    inline std::optional<std::vector<CSVIndexEntry>> read_csv_index(const std::string& csv_path, uint64_t csv_size,
+                                                                    canid_t can_id, int64_t start_ms, int64_t end_ms) {
+        std::string path = csv_path + ".idx";
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) return std::nullopt;
+
+        std::vector<CSVIndexEntry> matches;
+        std::vector<CSVIndexEntry> chunk(4096);
+        uint64_t indexed_end = 0;
+        while (size_t count = fread(chunk.data(), sizeof(CSVIndexEntry), chunk.size(), f)) {
+            for (size_t i = 0; i < count; ++i) {
+                const CSVIndexEntry& entry = chunk[i];
+                if (entry.can_id == csv_index_block_end)
+                    indexed_end = std::max(indexed_end, entry.offset + entry.length);
+                else if (entry.can_id == can_id && entry.last_ms >= start_ms && entry.first_ms <= end_ms)
+                    matches.push_back(entry);
+            }
+        }
+
+        // fread stops short of a torn trailing record without reading it
+        const bool torn = fgetc(f) != EOF;
+        fclose(f);
+        if (torn || indexed_end != csv_size) return std::nullopt;
+        return matches;
+    }
+
+}
@@ -1,9 +1,15 @@
 #pragma once 
 
 #include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <memory>
 #include <optional>
+#include <span>
 #include <stdio.h>
 #include <string_view>
 #include <array>
@@ -16,6 +22,9 @@ namespace Candy {
         std::array<const char*, T> headers;
     };
 
+    // Rows are formatted into an internal buffer that goes out in one fwrite
+    // when it fills or on flush(); the typed field overloads format in place.
+    // A failed write is latched and reported by the next flush() or close().
     template <size_t T>
     class CSVWriter {
     public:
@@ -45,6 +54,7 @@ namespace Candy {
         
         ~CSVWriter() {
             if (file) {
+                drain();
                 fclose(file);
             }
         }
@@ -57,18 +67,29 @@ namespace Candy {
         CSVWriter(CSVWriter&& other) :
             file(other.file), 
             csv_header(other.csv_header),
-            first_field(other.first_field) 
+            first_field(other.first_field),
+            buffer(std::move(other.buffer)),
+            used(other.used),
+            write_failed(other.write_failed)
         {
             other.file = nullptr;
+            other.used = 0;
         }
         
         CSVWriter& operator=(CSVWriter&& other) {
             if (this != &other) {
-                if (file) fclose(file);
+                if (file) {
+                    drain();
+                    fclose(file);
+                }
                 file = other.file;
                 csv_header = other.csv_header;
                 first_field = other.first_field;
+                buffer = std::move(other.buffer);
+                used = other.used;
+                write_failed = other.write_failed;
                 other.file = nullptr;
+                other.used = 0;
             }
             return *this;
         }
@@ -77,12 +98,11 @@ namespace Candy {
             if (!file) return false;
             
             for (size_t i = 0; i < T; ++i) {
-                if (i > 0) {
-                    if (fputc(',', file) == EOF) return false;
-                }
+                if (i > 0) put(',');
                 if (!write_escaped(csv_header.headers[i])) return false;
             }
-            return fputc('\n', file) != EOF;
+            put('\n');
+            return true;
         }
         
         bool start_row() {
@@ -92,24 +112,91 @@ namespace Candy {
         }
         
         bool field(std::string_view sv) {
-            if (!file) return false;
-            
-            if (!first_field) {
-                if (fputc(',', file) == EOF) return false;
-            }
-            first_field = false;
-            
+            if (!begin_field()) return false;
             return write_escaped(sv);
         }
+
+        bool field(const char* str) {
+            return field(std::string_view(str));
+        }
+
+        template <std::integral Int>
+        bool field(Int value) {
+            if (!begin_field()) return false;
+            char* out = reserve(max_number_chars);
+            used = std::to_chars(out, out + max_number_chars, value).ptr - buffer.get();
+            return true;
+        }
+
+        // shortest text that reads back as the same double
+        bool field(double value) {
+            if (!begin_field()) return false;
+            char* out = reserve(max_number_chars);
+            used = std::to_chars(out, out + max_number_chars, value).ptr - buffer.get();
+            return true;
+        }
+
+        // fixed notation, as printf("%.*f")
+        bool field(double value, int precision) {
+            if (!begin_field()) return false;
+            // %f of a large double runs to hundreds of digits
+            char digits[max_fixed_chars];
+            auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, precision);
+            if (result.ec != std::errc()) return false;
+            put(std::string_view(digits, result.ptr - digits));
+            return true;
+        }
+
+        // milliseconds since the clock's epoch
+        template <typename Clock, typename Duration>
+        bool field(std::chrono::time_point<Clock, Duration> timestamp) {
+            return field(static_cast<int64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count()));
+        }
+
+        // upper-case hex bytes separated by spaces, "0A FF 10"
+        bool hex_field(std::span<const uint8_t> bytes) {
+            if (!begin_field()) return false;
+            if (bytes.empty()) return true;
+
+            static constexpr char digits[] = "0123456789ABCDEF";
+            char* out = reserve(bytes.size() * 3);
+            for (size_t i = 0; i < bytes.size(); ++i) {
+                if (i > 0) *out++ = ' ';
+                *out++ = digits[bytes[i] >> 4];
+                *out++ = digits[bytes[i] & 0xF];
+            }
+            used = out - buffer.get();
+            return true;
+        }
         
         bool end_row() {
             if (!file) return false;
-            return fputc('\n', file) != EOF;
+            put('\n');
+            return true;
         }
         
+        // false if any write since the file was opened failed
         bool flush() {
             if (!file) return false;
-            return fflush(file) == 0;
+            drain();
+            if (fflush(file) != 0) write_failed = true;
+            return !write_failed;
+        }
+
+        bool close() {
+            if (!file) return false;
+            drain();
+            if (fclose(file) != 0) write_failed = true;
+            file = nullptr;
+            return !write_failed;
+        }
+
+        // byte offset of the next row, counting rows not yet flushed
+        long tell() const {
+            if (!file) return -1;
+            long pos = ftell(file);
+            return pos < 0 ? pos : pos + static_cast<long>(used);
         }
 
         const CSVHeader<T>& get_header() const {
@@ -117,11 +204,51 @@ namespace Candy {
         }
 
     private:
+        static constexpr size_t buffer_size = 1 << 16;
+        // enough for any integer or shortest double
+        static constexpr size_t max_number_chars = 32;
+        static constexpr size_t max_fixed_chars = 512;
+
         explicit CSVWriter(FILE* f, const CSVHeader<T>& h) : 
             file(f), 
             csv_header(h),
-            first_field(true) 
+            first_field(true),
+            buffer(std::make_unique<char[]>(buffer_size))
         {}
+
+        bool begin_field() {
+            if (!file) return false;
+            if (!first_field) put(',');
+            first_field = false;
+            return true;
+        }
+
+        // room for n more bytes (n <= buffer_size), writing out the buffer if needed
+        char* reserve(size_t n) {
+            if (used + n > buffer_size) drain();
+            return buffer.get() + used;
+        }
+
+        void drain() {
+            if (used == 0) return;
+            if (fwrite(buffer.get(), 1, used, file) != used) write_failed = true;
+            used = 0;
+        }
+
+        void put(char c) {
+            *reserve(1) = c;
+            ++used;
+        }
+
+        void put(std::string_view sv) {
+            if (sv.size() > buffer_size) {
+                drain();
+                if (fwrite(sv.data(), 1, sv.size(), file) != sv.size()) write_failed = true;
+                return;
+            }
+            std::memcpy(reserve(sv.size()), sv.data(), sv.size());
+            used += sv.size();
+        }
         
         bool write_escaped(std::string_view sv) {
             if (!file) return false;
@@ -135,26 +262,28 @@ namespace Candy {
             }
             
             if (needs_quotes) {
-                if (fputc('"', file) == EOF) return false;
+                put('"');
                 
                 for (char c : sv) {
-                    if (c == '"') {
-                        if (fputs("\"\"", file) == EOF) return false;
-                    } else {
-                        if (fputc(c, file) == EOF) return false;
-                    }
+                    if (c == '"') put("\"\"");
+                    else put(c);
                 }
                 
-                return fputc('"', file) != EOF;
+                put('"');
+                return true;
             }
             
-            return fwrite(sv.data(), 1, sv.size(), file) == sv.size();
+            put(sv);
+            return true;
         }
 
         private:
         FILE* file;
         CSVHeader<T> csv_header;
         bool first_field;
+        std::unique_ptr<char[]> buffer;
+        size_t used = 0;
+        bool write_failed = false;
     };
     
 }
\ No newline at end of file
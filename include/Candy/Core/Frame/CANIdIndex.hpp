@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+
+namespace Candy {
+
+    // can_id -> slot dispatch, built once after the DBC is loaded.
+    // Standard 11-bit ids index a dense array directly; everything else
+    // (29-bit ids with CAN_EFF_FLAG) goes through a hash-and-displace
+    // perfect hash, so a lookup is at most two hashes and one compare.
+    class CANIdIndex {
+    public:
+        static constexpr uint32_t npos = UINT32_MAX;
+
+        void build(std::span<const std::pair<canid_t, uint32_t>> entries);
+        void clear();
+
+        uint32_t find(canid_t can_id) const {
+            if (can_id < _standard.size())
+                return _standard[can_id];
+            if (_keys.empty())
+                return npos;
+
+            const uint32_t bucket = hash(can_id, 0) & _bucket_mask;
+            const uint32_t slot = hash(can_id, _seeds[bucket]) & _slot_mask;
+            return _keys[slot] == can_id ? _values[slot] : npos;
+        }
+
+        size_t size() const { return _size; }
+
+    private:
+        std::vector<uint32_t> _standard;
+
+        // perfect hash over the remaining ids
+        std::vector<uint32_t> _seeds;
+        std::vector<canid_t> _keys;
+        std::vector<uint32_t> _values;
+        uint32_t _bucket_mask = 0;
+        uint32_t _slot_mask = 0;
+        size_t _size = 0;
+
+        static uint32_t hash(canid_t can_id, uint32_t seed) {
+            uint64_t x = can_id ^ (static_cast<uint64_t>(seed) * 0x9E3779B97F4A7C15ull);
+            x ^= x >> 33;
+            x *= 0xFF51AFD7ED558CCDull;
+            x ^= x >> 33;
+            return static_cast<uint32_t>(x);
+        }
+
+        bool build_hashed(std::span<const std::pair<canid_t, uint32_t>> entries, size_t slot_count);
+    };
+
+}
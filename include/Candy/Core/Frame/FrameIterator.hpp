@@ -7,6 +7,7 @@
 #include "Candy/Core/CANKernelTypes.hpp"
 
 #include "FramePacket.hpp"
+#include "FramePacketEncoder.hpp"
 
 namespace Candy {
     class FrameIteratorSentinel{};
@@ -17,15 +18,26 @@ namespace Candy {
         std::span<const uint8_t> payload_data;
         size_t current_offset = 0;
 
+        // v2 records only decode in order, so the current one is kept
+        bool delta_encoded = false;
+        size_t delta_record_size = 0;
+        int32_t delta_millis = 0;
+        CANFlexibleFrame delta_frame {};
+        FrameRecordHistory delta_history;
+
     public:
         explicit FrameIterator(const FramePacket& fp);
         ~FrameIterator();
 
         bool operator==(const FrameIteratorSentinel&) const;
-        std::pair<CANTime, CANFrame> operator*();
+        // classic records come back widened, with CANFD_FDF clear
+        std::pair<CANTime, CANFlexibleFrame> operator*();
         FrameIterator& operator++();
         
     private:
+        size_t record_size() const;
+        void decode_delta_record();
+
         template<typename IntType>
         IntType transmit_at_offset(size_t offset) const;
     };
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <span>
+#include <cstddef>
 #include <cstring>
 
 #include "Candy/Core/CANKernelTypes.hpp"
@@ -18,6 +19,29 @@ namespace Candy {
         return cf.__res0 & 0x1;
     }
 
+    inline void use_non_muxed(CANFlexibleFrame& ff, bool use) {
+        if (use) ff.__res0 |= 0x1;
+        else ff.__res0 &= ~0x1;
+    }
+
+    inline bool use_non_muxed(const CANFlexibleFrame& ff) {
+        return ff.__res0 & 0x1;
+    }
+
+    // Packet records are an int32 millisecond offset followed by either a
+    // 16 byte CANFrame or, when CANFD_FDF is set in the flags byte, the 8 byte
+    // CANFlexibleFrame header plus `length` payload bytes.
+    inline constexpr size_t frame_header_size = offsetof(CANFlexibleFrame, data);
+
+    // the u16 at the head of every packet; v2 records are laid out in FramePacketEncoder.hpp
+    enum class FramePacketFormat : uint16_t {
+        v1 = 100,
+        v2 = 200
+    };
+
+    // what prepare() reserves; a buffer this size holds a typical publish period
+    inline constexpr size_t packet_reserve_bytes = 32 * 1024;
+
     class FramePacket {
         using base = std::vector<uint8_t>;
         base _buff;
@@ -31,8 +55,10 @@ namespace Candy {
         FramePacket(const FramePacket&) = delete;
         FramePacket& operator=(const FramePacket&) = delete;
 
-        void prepare(uint32_t utc);
+        // clears the packet and writes the header, keeping the buffer's capacity
+        void prepare(uint32_t utc, FramePacketFormat format = FramePacketFormat::v1);
         uint32_t utc() const;
+        FramePacketFormat format() const;
 
         bool is_empty() const;
         size_t byte_size() const;
@@ -45,6 +71,8 @@ namespace Candy {
         std::span<const uint8_t> payload() const; // Data after header (UTC + version)
 
         void append(CANFrame frame);
+        void append(const CANFlexibleFrame& frame);
+        void append(std::span<const uint8_t> bytes);
 
         template <typename IntType>
         void append(IntType val);
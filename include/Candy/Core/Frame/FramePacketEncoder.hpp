@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/Frame/FramePacket.hpp"
+
+namespace Candy {
+
+    // v2 records follow the same 6 byte header as v1:
+    //
+    //   varint  zigzag delta of the millisecond offset from the previous record
+    //   varint  zigzag delta of can_id from the previous record
+    //   u8      CANFD_BRS/ESI/FDF, plus the frame_record_* bits below
+    //   u8      payload length
+    //   bytes   the payload, or when sparse, a bitmask of its nonzero bytes
+    //           followed by just those bytes
+    //
+    // An xor payload holds the difference from the previous record with the
+    // same can_id. Deltas restart with every packet, so each packet decodes
+    // on its own.
+    inline constexpr uint8_t frame_record_non_muxed = 0x10;
+    inline constexpr uint8_t frame_record_sparse = 0x20;
+    inline constexpr uint8_t frame_record_xor = 0x40;
+
+    // two 5 byte varints, flags, length and a raw CAN FD payload
+    inline constexpr size_t max_frame_record_size = 5 + 5 + 2 + CANFD_MAX_DLEN;
+
+    // Per-packet state the v2 deltas are taken against, kept alike by the
+    // encoder and decoder.
+    class FrameRecordHistory {
+        struct Last {
+            canid_t can_id;
+            std::array<uint8_t, CANFD_MAX_DLEN> data;
+        };
+        std::vector<Last> _last;
+
+    public:
+        int32_t millis = 0;
+        canid_t can_id = 0;
+
+        void clear();
+        // previous payload of can_id, zero padded; nullptr before its first record
+        const uint8_t* find(canid_t can_id) const;
+        void remember(canid_t can_id, const uint8_t* data, size_t len);
+    };
+
+    // Writes records into FramePackets in either format. A V2CTranscoder
+    // owns one and starts every packet through begin().
+    class FramePacketEncoder {
+        FramePacketFormat _format;
+        bool _xor_payloads;
+        FrameRecordHistory _history;
+
+    public:
+        explicit FramePacketEncoder(FramePacketFormat format = FramePacketFormat::v1, bool xor_payloads = true);
+
+        FramePacketFormat format() const { return _format; }
+
+        void begin(FramePacket& fp, uint32_t utc);
+        // classic frames are stored as such unless CANFD_FDF is set
+        void append(FramePacket& fp, int32_t millis, const CANFlexibleFrame& frame);
+    };
+
+    // Decodes the v2 record at the front of bytes. Returns its size, or 0
+    // when it is truncated or malformed.
+    size_t decode_frame_record(std::span<const uint8_t> bytes, FrameRecordHistory& history,
+                               int32_t& millis, CANFlexibleFrame& frame);
+
+}
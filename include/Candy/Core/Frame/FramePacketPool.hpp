@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Candy/Core/Frame/FramePacket.hpp"
+
+namespace Candy {
+
+    struct FramePacketPoolStats {
+        uint64_t acquired = 0;
+        // acquisitions served by a recycled buffer
+        uint64_t reused = 0;
+        // acquisitions that had to allocate a new buffer
+        uint64_t allocated = 0;
+        uint64_t recycled = 0;
+        // recycled buffers freed because the pool was already full
+        uint64_t dropped = 0;
+    };
+
+    // Free list of FramePacket buffers. A packet handed back through
+    // recycle() keeps its capacity, so once every buffer in flight has
+    // come back around, acquire() no longer touches the heap. Not
+    // thread-safe; recycle on the thread that acquires.
+    class FramePacketPool {
+        std::vector<std::vector<uint8_t>> _free;
+        size_t _capacity;
+        size_t _buffer_bytes;
+        FramePacketPoolStats _stats;
+
+    public:
+        explicit FramePacketPool(size_t capacity = 4, size_t buffer_bytes = packet_reserve_bytes);
+
+        FramePacketPool(FramePacketPool&&) = default;
+        FramePacketPool& operator=(FramePacketPool&&) = default;
+        FramePacketPool(const FramePacketPool&) = delete;
+        FramePacketPool& operator=(const FramePacketPool&) = delete;
+
+        // an empty packet with at least buffer_bytes reserved
+        FramePacket acquire();
+        void recycle(FramePacket&& packet);
+        void recycle(std::vector<uint8_t> buff);
+
+        // buffers kept for reuse; shrinking frees the surplus
+        void set_capacity(size_t capacity);
+        size_t capacity() const { return _capacity; }
+        size_t available() const { return _free.size(); }
+
+        const FramePacketPoolStats& stats() const { return _stats; }
+    };
+
+}
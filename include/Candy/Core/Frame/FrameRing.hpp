@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/CANIO.hpp"
+
+namespace Candy {
+
+    // Bounded single-producer/single-consumer ring of timestamped frames.
+    // The capture thread pushes, one consumer thread drains into a
+    // transcoder; neither side locks, and a full ring drops the new frame
+    // and counts it instead of blocking capture. Indices live on separate
+    // cache lines, each side keeping a cached copy of the other's index.
+    template <typename Frame>
+    class FrameRing {
+    public:
+        using sample_type = std::pair<CANTime, Frame>;
+
+        // capacity is rounded up to a power of two
+        explicit FrameRing(size_t capacity);
+
+        FrameRing(const FrameRing&) = delete;
+        FrameRing& operator=(const FrameRing&) = delete;
+
+        // ---- producer ----
+
+        bool try_push(const sample_type& sample) {
+            const size_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail - _producer_head == _capacity) {
+                _producer_head = _head.load(std::memory_order_acquire);
+                if (tail - _producer_head == _capacity) {
+                    _overflowed.store(_overflowed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+            _slots[tail & _mask] = sample;
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // pushes what fits and counts the rest as overflowed
+        size_t try_push(std::span<const sample_type> samples);
+
+        // ---- consumer ----
+
+        bool try_pop(sample_type& out) {
+            const size_t head = _head.load(std::memory_order_relaxed);
+            if (head == _consumer_tail) {
+                _consumer_tail = _tail.load(std::memory_order_acquire);
+                if (head == _consumer_tail)
+                    return false;
+            }
+            out = _slots[head & _mask];
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // calls fn(const sample_type&) for up to max_count queued samples, in
+        // place, and releases their slots afterwards. Returns how many it consumed.
+        template <typename Fn>
+        size_t consume(Fn&& fn, size_t max_count = SIZE_MAX) {
+            const size_t head = _head.load(std::memory_order_relaxed);
+            _consumer_tail = _tail.load(std::memory_order_acquire);
+
+            size_t count = std::min(_consumer_tail - head, max_count);
+            for (size_t i = 0; i < count; ++i)
+                fn(_slots[(head + i) & _mask]);
+
+            _head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+        // feeds up to max_count queued samples to a transcoder
+        template <typename Derived>
+        size_t drain_to(CANReceivable<Derived>& sink, size_t max_count = SIZE_MAX) {
+            return consume([&](const sample_type& sample) { sink.receive_raw_message_vrtl(sample); }, max_count);
+        }
+
+        // ---- either side ----
+
+        size_t capacity() const { return _capacity; }
+        // a snapshot; the other side may have moved on by the time it returns
+        size_t size() const {
+            const size_t head = _head.load(std::memory_order_acquire);
+            return _tail.load(std::memory_order_acquire) - head;
+        }
+        bool empty() const { return size() == 0; }
+
+        // samples accepted / rejected because the ring was full
+        uint64_t pushed() const { return _tail.load(std::memory_order_relaxed); }
+        uint64_t overflowed() const { return _overflowed.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr size_t cache_line = 64;
+
+        size_t _capacity;
+        size_t _mask;
+        std::unique_ptr<sample_type[]> _slots;
+
+        // written by the consumer
+        alignas(cache_line) std::atomic<size_t> _head{0};
+        size_t _consumer_tail = 0;
+
+        // written by the producer
+        alignas(cache_line) std::atomic<size_t> _tail{0};
+        size_t _producer_head = 0;
+        std::atomic<uint64_t> _overflowed{0};
+    };
+
+    extern template class FrameRing<CANFrame>;
+    extern template class FrameRing<CANFlexibleFrame>;
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Candy/Core/Frame/FramePacket.hpp"
+
+#if defined(CANDY_HAS_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace Candy {
+
+    // Wire format for FramePackets on a byte stream. Each packet goes out as a
+    // 20 byte little-endian header followed by its (possibly compressed) bytes:
+    //
+    //   0  magic 'C' 'Y'
+    //   2  u8  version
+    //   3  u8  PacketCompression of the body
+    //   4  u32 sequence number, +1 per packet
+    //   8  u32 body size
+    //   12 u32 FramePacket size once decompressed
+    //   16 u32 CRC-32C of bytes 0..15 and the body
+    //
+    // A receiver that loses sync (bad magic, size or CRC) scans forward for
+    // the next header, so one corrupt packet costs only itself.
+    enum class PacketCompression : uint8_t {
+        none = 0,
+        lz4 = 1,
+        zstd = 2
+    };
+
+    inline constexpr size_t packet_header_size = 20;
+    inline constexpr uint8_t packet_version = 1;
+    // the largest packet a framer sends; larger sizes are read as a corrupt header
+    inline constexpr size_t max_packet_size = 16 * 1024 * 1024;
+
+    uint32_t crc32c(std::span<const uint8_t> bytes, uint32_t crc = 0);
+
+    // whether this build links the codec
+    bool compression_available(PacketCompression compression);
+
+    class PacketFramer {
+        PacketCompression _compression = PacketCompression::none;
+        int _level = 0;
+        uint32_t _sequence = 0;
+        std::vector<uint8_t> _frame;
+
+#if defined(CANDY_HAS_ZSTD)
+        std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> _zstd{nullptr, ZSTD_freeCCtx};
+#endif
+
+        PacketFramer(PacketCompression compression, int level);
+
+    public:
+        // level is the codec's own (LZ4 acceleration, zstd level); 0 picks its default
+        static std::optional<PacketFramer> create(PacketCompression compression = PacketCompression::none, int level = 0);
+
+        // Header and body for the next packet, valid until the next call. A body
+        // that does not shrink under compression is sent as is. Empty if the
+        // packet is larger than max_packet_size.
+        std::span<const uint8_t> frame(const FramePacket& packet);
+        std::span<const uint8_t> frame(std::span<const uint8_t> packet_bytes);
+
+        uint32_t next_sequence() const { return _sequence; }
+        PacketCompression compression() const { return _compression; }
+    };
+
+    // Checks and decodes one frame that fills `frame` exactly, such as a
+    // datagram, and sets `sequence`; nullopt if it is corrupt.
+    std::optional<FramePacket> unframe_packet(std::span<const uint8_t> frame, uint32_t& sequence);
+
+    struct PacketLinkStats {
+        uint64_t packets = 0;
+        // sequence numbers skipped between received packets
+        uint64_t lost = 0;
+        uint64_t crc_errors = 0;
+        // bodies that failed to decompress, or used a codec this build lacks
+        uint64_t decode_errors = 0;
+        // bytes skipped while looking for a header
+        uint64_t skipped_bytes = 0;
+    };
+
+    // Reassembles packets from a byte stream fed in arbitrary pieces.
+    class PacketDeframer {
+        std::vector<uint8_t> _buff;
+        size_t _read = 0;
+        size_t _max_size;
+        std::optional<uint32_t> _last_sequence;
+        PacketLinkStats _stats;
+
+    public:
+        // Headers claiming more than max_size bytes are read as corrupt. A corrupt
+        // size within it holds the stream until that many bytes arrive, so set it
+        // to the largest packet the sender makes.
+        explicit PacketDeframer(size_t max_size = max_packet_size);
+
+        void feed(std::span<const uint8_t> bytes);
+
+        // The next intact packet, ready for FrameIterator, or nullopt until more
+        // bytes arrive. Corrupt packets are counted and skipped.
+        std::optional<FramePacket> next();
+
+        std::optional<uint32_t> last_sequence() const { return _last_sequence; }
+        const PacketLinkStats& stats() const { return _stats; }
+
+    private:
+        void skip(size_t bytes);
+        void compact();
+    };
+
+}
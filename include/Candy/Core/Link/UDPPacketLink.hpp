@@ -0,0 +1,144 @@
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <netinet/in.h>
+
+#include "Candy/Core/Frame/FramePacket.hpp"
+#include "Candy/Core/Frame/PacketFraming.hpp"
+
+namespace Candy {
+
+    struct UDPLinkOptions {
+        // how long a packet is worth recovering; older ones are dropped, not retransmitted
+        std::chrono::milliseconds deadline{200};
+        // how often the receiver asks again for a packet that is still missing
+        std::chrono::milliseconds nack_interval{20};
+        // packets the sender keeps for retransmission
+        size_t history = 256;
+        // fraction of outgoing datagrams to throw away, for exercising loss recovery
+        double simulated_loss = 0.0;
+        uint32_t simulated_loss_seed = 1;
+    };
+
+    struct UDPLinkStats {
+        uint64_t packets = 0;
+        // datagrams sent again in answer to a NACK
+        uint64_t retransmits = 0;
+        // packets delivered by a retransmit
+        uint64_t recovered = 0;
+        // packets given up on at the deadline
+        uint64_t lost = 0;
+        // repeats, and retransmits that came after the deadline
+        uint64_t duplicates = 0;
+        uint64_t corrupt = 0;
+        uint64_t nacks = 0;
+        // times the sender started its sequence numbers over
+        uint64_t restarts = 0;
+    };
+
+    // Sends each FramePacket as one PacketFramer datagram. Recent datagrams
+    // are kept so the receiver can NACK the ones it missed; a NACK that
+    // arrives past the deadline is ignored, since newer data has already
+    // gone out. Nothing waits on an acknowledgement.
+    class UDPPacketSender {
+        int _fd = -1;
+        UDPLinkOptions _options;
+        PacketFramer _framer;
+        UDPLinkStats _stats;
+
+        struct Sent {
+            uint32_t sequence = 0;
+            std::chrono::steady_clock::time_point at;
+            std::vector<uint8_t> datagram;
+        };
+        // by sequence % history
+        std::vector<Sent> _history;
+        std::minstd_rand _loss;
+
+        UDPPacketSender(int fd, UDPLinkOptions options, PacketFramer framer);
+
+    public:
+        // a socket connected to host:port
+        static std::optional<UDPPacketSender> create(std::string_view host, uint16_t port, UDPLinkOptions options = {},
+                                                     PacketCompression compression = PacketCompression::none);
+
+        UDPPacketSender(UDPPacketSender&& other) noexcept;
+        UDPPacketSender& operator=(UDPPacketSender&& other) noexcept;
+        UDPPacketSender(const UDPPacketSender&) = delete;
+        UDPPacketSender& operator=(const UDPPacketSender&) = delete;
+        ~UDPPacketSender();
+
+        bool send(const FramePacket& packet);
+        // answers the NACKs that have arrived, without blocking; call between sends
+        size_t poll();
+
+        const UDPLinkStats& stats() const { return _stats; }
+        int native_handle() const { return _fd; }
+
+    private:
+        bool transmit(std::span<const uint8_t> datagram);
+    };
+
+    // Receives PacketFramer datagrams and delivers packets as they arrive,
+    // without holding newer ones back for a gap. Missing sequence numbers
+    // are NACKed every nack_interval until the deadline, then counted lost;
+    // a retransmit that turns up later than that is dropped. A sender that
+    // restarts, seen as a new source address or a sequence number further
+    // back than its history, is followed from its new sequence numbers.
+    class UDPPacketReceiver {
+        int _fd = -1;
+        UDPLinkOptions _options;
+        UDPLinkStats _stats;
+
+        sockaddr_in _peer {};
+        bool _has_peer = false;
+        std::optional<uint32_t> _highest;
+
+        struct Missing {
+            std::chrono::steady_clock::time_point since;
+            std::chrono::steady_clock::time_point last_nack;
+        };
+        // by sequence number
+        std::map<uint32_t, Missing> _missing;
+        std::vector<uint8_t> _datagram;
+        std::minstd_rand _loss;
+
+        UDPPacketReceiver(int fd, UDPLinkOptions options);
+
+    public:
+        // a socket bound to port on every interface; 0 picks a free port
+        static std::optional<UDPPacketReceiver> create(uint16_t port, UDPLinkOptions options = {});
+
+        UDPPacketReceiver(UDPPacketReceiver&& other) noexcept;
+        UDPPacketReceiver& operator=(UDPPacketReceiver&& other) noexcept;
+        UDPPacketReceiver(const UDPPacketReceiver&) = delete;
+        UDPPacketReceiver& operator=(const UDPPacketReceiver&) = delete;
+        ~UDPPacketReceiver();
+
+        // Waits up to timeout_ms (-1 blocks) for the next packet, sending any
+        // NACKs that are due meanwhile. nullopt on timeout.
+        std::optional<FramePacket> receive(int timeout_ms = -1);
+
+        uint16_t port() const;
+        const UDPLinkStats& stats() const { return _stats; }
+        int native_handle() const { return _fd; }
+
+    private:
+        std::optional<FramePacket> accept(std::span<const uint8_t> datagram, const sockaddr_in& from);
+        void send_nacks();
+    };
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/CANIOHelperTypes.hpp"
+#include "Candy/Core/Frame/CANIdIndex.hpp"
+#include "Candy/Core/Signal/SignalCodec.hpp"
+#include "Candy/Core/Signal/NumericValue.hpp"
+
+namespace Candy {
+
+    // Per-message record of a DecodeTable. Its signals are the table
+    // columns [first_signal, first_signal + signal_count). payload_size is
+    // how many payload bytes decoding it reads; above CAN_MAX_DLEN its
+    // frames must be decoded from a CANFlexibleFrame.
+    struct DecodeMessage {
+        uint32_t first_signal = 0;
+        uint32_t signal_count = 0;
+        SignalLayout mux;
+        bool has_mux = false;
+        uint8_t payload_size = CAN_MAX_DLEN;
+    };
+
+    // Compiled, structure-of-arrays form of the parsed MessageDefinitions.
+    // Everything the decode path reads (layout, factor/offset, mux value,
+    // value type) sits in contiguous arrays indexed by signal; names and
+    // units live in a side table that only writers touch.
+    class DecodeTable {
+        static constexpr int64_t no_mux = -1;
+
+        CANIdIndex _index;
+        std::vector<canid_t> _ids;
+        std::vector<DecodeMessage> _messages;
+
+        // hot, one entry per signal
+        std::vector<SignalLayout> _layouts;
+        std::vector<double> _factors;
+        std::vector<double> _offsets;
+        std::vector<int64_t> _mux_vals;
+        std::vector<NumericValueType> _value_types;
+
+        // cold
+        std::vector<std::string> _message_names;
+        std::vector<std::string> _signal_names;
+        std::vector<std::string> _units;
+
+    public:
+        // adds or replaces can_id's message; signals without a codec are skipped.
+        // find() only sees messages added before the last build_index().
+        void add(canid_t can_id, const MessageDefinition& msg_def);
+        void build_index();
+        void clear();
+
+        std::optional<uint32_t> find(canid_t can_id) const {
+            uint32_t slot = _index.find(can_id);
+            if (slot == CANIdIndex::npos) return std::nullopt;
+            return slot;
+        }
+
+        size_t message_count() const { return _messages.size(); }
+        // can_id of each slot
+        std::span<const canid_t> ids() const { return _ids; }
+        size_t signal_count() const { return _layouts.size(); }
+
+        const DecodeMessage& message(uint32_t slot) const { return _messages[slot]; }
+        std::string_view message_name(uint32_t slot) const { return _message_names[slot]; }
+
+        // empty for ids not in the DBC
+        std::string_view find_message_name(canid_t can_id) const {
+            auto slot = find(can_id);
+            return slot ? message_name(*slot) : std::string_view("");
+        }
+
+        const SignalLayout& layout(uint32_t sig) const { return _layouts[sig]; }
+        double factor(uint32_t sig) const { return _factors[sig]; }
+        double offset(uint32_t sig) const { return _offsets[sig]; }
+        NumericValueType value_type(uint32_t sig) const { return _value_types[sig]; }
+
+        std::optional<uint64_t> mux_val(uint32_t sig) const {
+            if (_mux_vals[sig] == no_mux) return std::nullopt;
+            return static_cast<uint64_t>(_mux_vals[sig]);
+        }
+
+        bool is_active(uint32_t sig, std::optional<uint64_t> mux) const {
+            return _mux_vals[sig] == no_mux || (mux && static_cast<int64_t>(*mux) == _mux_vals[sig]);
+        }
+
+        std::string_view signal_name(uint32_t sig) const { return _signal_names[sig]; }
+        std::string_view unit(uint32_t sig) const { return _units[sig]; }
+    };
+
+}
@@ -3,6 +3,7 @@
 #include <optional>
 #include <concepts>
 #include <cstdint>
+#include <span>
 
 namespace Candy {
 
@@ -20,12 +21,19 @@ namespace Candy {
     public:
         NumericValue(double scale_factor, double offset_value);
 
+        double get_factor() const { return factor; }
+        double get_offset() const { return offset; }
+
         std::optional<double> convert(uint64_t raw_value, NumericValueType type) const;
+        bool convert(std::span<const uint64_t> raw_values, NumericValueType type, double* out) const;
 
     private:
         template <typename T>
         requires std::convertible_to<T, double>
         double convert_raw_to_numeric(T value) const;
+
+        template <typename T>
+        void convert_column(std::span<const uint64_t> raw_values, double* out) const;
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/Signal/SignalCodec.hpp"
+#include "Candy/Core/Signal/DecodeTable.hpp"
+
+namespace Candy {
+
+    // Decodes one signal from `count` payloads laid out `stride` bytes apart.
+    // Byte order and sign are resolved once per call, not once per frame;
+    // AVX2 (when built with CANDY_ENABLE_AVX2) and NEON handle the bulk.
+    void decode_batch(const SignalLayout& layout, const uint8_t* data, size_t stride, size_t count, uint64_t* out);
+
+    // Layouts of several signals in one payload, as parallel arrays so a
+    // frame's signals decode side by side: AVX2 and NEON gather one lane
+    // per signal. Wide (9-byte) signals don't fit a lane and are refused.
+    class SignalLayoutPack {
+        std::vector<int64_t> _byte_offsets;
+        std::vector<uint64_t> _shifts;
+        std::vector<uint64_t> _masks;
+        std::vector<uint64_t> _sign_bits;
+        // all ones for Motorola lanes, so byte swaps can be blended in
+        std::vector<uint64_t> _big_endian;
+
+    public:
+        bool add(const SignalLayout& layout);
+        void clear();
+        size_t size() const { return _masks.size(); }
+
+        // out[i] is lane i's raw value, as SignalCodec would decode it
+        void decode(const uint8_t* data, uint64_t* out) const;
+        // writes each raw[i] into its lane's bits, leaving the other bits of data alone
+        void encode(const uint64_t* raw, uint8_t* data) const;
+
+    private:
+        size_t decode_simd(const uint8_t* data, uint64_t* out) const;
+    };
+
+    // Column-major decode buffer for every signal of one message over a run
+    // of frames. Storage is reused between calls, so steady state does not allocate.
+    class ColumnBuffer {
+        size_t _rows = 0;
+        size_t _columns = 0;
+        uint32_t _first_signal = 0;
+        std::vector<uint64_t> _raw;
+        std::vector<double> _values;
+        std::vector<uint64_t> _mux;
+        bool _has_mux = false;
+
+    public:
+        // decodes the message in `slot` of `table`
+        void decode(const DecodeTable& table, uint32_t slot, std::span<const std::pair<CANTime, CANFrame>> samples);
+        void decode(const DecodeTable& table, uint32_t slot, std::span<const std::pair<CANTime, CANFlexibleFrame>> samples);
+        void decode(const DecodeTable& table, uint32_t slot, std::span<const CANFrame> frames);
+        // payloads `stride` bytes apart, e.g. inside a caller's own records
+        void decode(const DecodeTable& table, uint32_t slot, const uint8_t* data, size_t stride, size_t count);
+
+        size_t rows() const { return _rows; }
+        size_t columns() const { return _columns; }
+
+        // table signal index of a column
+        uint32_t signal(size_t column) const { return _first_signal + static_cast<uint32_t>(column); }
+
+        std::span<const uint64_t> raw(size_t column) const {
+            return { _raw.data() + column * _rows, _rows };
+        }
+
+        std::span<const double> values(size_t column) const {
+            return { _values.data() + column * _rows, _rows };
+        }
+
+        std::optional<uint64_t> mux(size_t row) const {
+            if (!_has_mux) return std::nullopt;
+            return _mux[row];
+        }
+    };
+
+}
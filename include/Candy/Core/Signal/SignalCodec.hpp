@@ -1,10 +1,59 @@
 #pragma once
 
 #include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <span>
+#include <utility>
+
+#include "Candy/Core/CANKernelTypes.hpp"
 
 namespace Candy {
 
+  // Precomputed extraction for one signal: load 8 bytes at byte_offset,
+  // swap for Motorola order, shift, mask and sign extend. Signals that
+  // straddle 9 bytes are flagged wide; for those byte_offset is the first
+  // byte and shift the bit position within the 9-byte window.
+  struct SignalLayout {
+    uint64_t mask = 0;
+    uint64_t sign_bit = 0;
+    uint8_t byte_offset = 0;
+    uint8_t shift = 0;
+    bool big_endian = false;
+    bool wide = false;
+  };
+
+  // sb/bs/bo/st follow the DBC SG_ fields: start bit, size, '0' Motorola / '1' Intel, '+'/'-'
+  constexpr SignalLayout make_signal_layout(unsigned sb, unsigned bs, char bo, char st) {
+    SignalLayout layout;
+    layout.big_endian = bo == '0';
+
+    // bit index of the signal's lsb counted from the start of the payload,
+    // msb-first for Motorola so both orders reduce to a byte window
+    unsigned first_byte = sb / 8;
+    unsigned lsb_bit = layout.big_endian ? 8 * first_byte + (7 - sb % 8) + bs - 1 : sb + bs - 1;
+    unsigned last_byte = lsb_bit / 8;
+    unsigned window = last_byte >= 8 ? last_byte - 7 : 0;
+
+    layout.wide = last_byte - first_byte >= 8;
+    if (layout.wide) {
+      layout.byte_offset = static_cast<uint8_t>(first_byte);
+      layout.shift = static_cast<uint8_t>(layout.big_endian ? 71 - (lsb_bit - 8 * first_byte) : sb % 8);
+    }
+    else {
+      layout.byte_offset = static_cast<uint8_t>(window);
+      layout.shift = static_cast<uint8_t>(layout.big_endian ? 63 - (lsb_bit - 8 * window) : sb - 8 * window);
+    }
+    layout.mask = bs >= 64 ? ~0ull : (1ull << bs) - 1;
+    layout.sign_bit = (st == '-' && bs > 0) ? 1ull << (bs - 1) : 0;
+    return layout;
+  }
+
+  // payload bytes a decode with this layout reads, counted from byte 0
+  constexpr unsigned payload_extent(const SignalLayout& layout) {
+    return layout.byte_offset + (layout.wide ? 9u : 8u);
+  }
+
   class SignalCodec {
     using order = std::endian;
 
@@ -12,6 +61,7 @@ namespace Candy {
     order _byte_order;
     char _sign_type;
     unsigned _byte_pos, _bit_pos, _last_bit_pos, _nbytes;
+    SignalLayout _layout;
 
   public:
     SignalCodec(unsigned sb, unsigned bs, char bo, char st);
@@ -19,6 +69,16 @@ namespace Candy {
     uint64_t operator()(const uint8_t* data) const;
     void operator()(uint64_t raw, void* buffer) const;
 
+    // decodes `count` payloads laid out `stride` bytes apart into out[0..count)
+    void decode_batch(const uint8_t* data, size_t stride, size_t count, uint64_t* out) const;
+    void decode_batch(std::span<const CANFrame> frames, uint64_t* out) const;
+    void decode_batch(std::span<const std::pair<CANTime, CANFrame>> samples, uint64_t* out) const;
+    void decode_batch(std::span<const std::pair<CANTime, CANFlexibleFrame>> samples, uint64_t* out) const;
+
     char sign_type() const;
+    const SignalLayout& layout() const;
+
+  private:
+    uint64_t decode_wide(const uint8_t* data) const;
   };
-}
\ No newline at end of file
+}
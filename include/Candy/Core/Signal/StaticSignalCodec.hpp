@@ -0,0 +1,83 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "Candy/Core/Signal/SignalCodec.hpp"
+#include "Candy/Core/Signal/NumericValue.hpp"
+
+namespace Candy {
+
+  // SignalCodec with the layout fixed at compile time. Byte order, sign and
+  // window are template constants, so decode is a load, a shift and a mask
+  // with no branches. Instances are emitted by candy_codegen for a known DBC.
+  template <unsigned StartBit, unsigned BitSize, char ByteOrder, char Sign>
+  struct StaticSignalCodec {
+    static constexpr SignalLayout layout = make_signal_layout(StartBit, BitSize, ByteOrder, Sign);
+
+    static_assert(BitSize > 0 && BitSize <= 64, "signal size must be in [1, 64]");
+
+    static uint64_t decode(const uint8_t* data) {
+      uint64_t v;
+      if constexpr (layout.wide)
+        v = load_wide(data);
+      else
+        v = (load(data + layout.byte_offset) >> layout.shift) & layout.mask;
+
+      if constexpr (layout.sign_bit != 0)
+        v = (v ^ layout.sign_bit) - layout.sign_bit;
+      return v;
+    }
+
+    uint64_t operator()(const uint8_t* data) const { return decode(data); }
+
+  private:
+    static uint64_t load(const uint8_t* p) {
+      uint64_t v;
+      std::memcpy(&v, p, sizeof(v));
+      if constexpr ((ByteOrder == '0') == (std::endian::native == std::endian::little))
+        v = std::byteswap(v);
+      return v;
+    }
+
+    // signal spans 9 bytes starting at byte_offset
+    static uint64_t load_wide(const uint8_t* data) {
+      const uint64_t lo = load(data + layout.byte_offset);
+      const uint64_t hi = data[layout.byte_offset + 8];
+
+      if constexpr (ByteOrder == '0')
+        return ((lo << (8 - layout.shift)) | (hi >> layout.shift)) & layout.mask;
+      else
+        return ((lo >> layout.shift) | (hi << (64 - layout.shift))) & layout.mask;
+    }
+  };
+
+  struct StaticSignalInfo {
+    std::string_view name;
+    std::string_view unit;
+    double factor;
+    double offset;
+  };
+
+  // A generated signal: its codec plus the constants NumericValue would hold at runtime.
+  template <typename Codec, NumericValueType Type>
+  struct StaticSignal : StaticSignalInfo {
+    static constexpr NumericValueType value_type = Type;
+
+    static uint64_t raw(const uint8_t* data) { return Codec::decode(data); }
+
+    constexpr double value(uint64_t raw_value) const {
+      if constexpr (Type == NumericValueType::i64)
+        return static_cast<double>(std::bit_cast<int64_t>(raw_value)) * factor + offset;
+      else if constexpr (Type == NumericValueType::u64)
+        return static_cast<double>(raw_value) * factor + offset;
+      else if constexpr (Type == NumericValueType::f32)
+        return static_cast<double>(std::bit_cast<float>(static_cast<uint32_t>(raw_value))) * factor + offset;
+      else
+        return std::bit_cast<double>(raw_value) * factor + offset;
+    }
+  };
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+// mmap
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/CANHelpers.hpp"
+#include "Candy/Core/CANIO.hpp"
+
+namespace Candy {
+
+    // Read-only view of a frames.csv written by CSVTranscoder. The file is
+    // mmapped and rows are tokenized in place, so iterating allocates nothing.
+    // Rows come back as in FrameIterator: CANFlexibleFrame, with CANFD_FDF
+    // set for payloads longer than 8 bytes. Malformed rows are skipped.
+    class CSVFrameReader {
+        const char* _data = nullptr;
+        size_t _size = 0;
+        // start of the first row, past a header line if there is one
+        size_t _first_row = 0;
+
+        CSVFrameReader(const char* data, size_t size);
+
+    public:
+        using sample_type = std::pair<CANTime, CANFlexibleFrame>;
+
+        static std::optional<CSVFrameReader> create(const std::string& path);
+
+        CSVFrameReader(CSVFrameReader&& other) noexcept;
+        CSVFrameReader& operator=(CSVFrameReader&& other) noexcept;
+        CSVFrameReader(const CSVFrameReader&) = delete;
+        CSVFrameReader& operator=(const CSVFrameReader&) = delete;
+        ~CSVFrameReader();
+
+        class iterator {
+            const char* _pos = nullptr;
+            const char* _end = nullptr;
+            sample_type _sample {};
+
+            void advance();
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = sample_type;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+            iterator(const char* pos, const char* end) : _pos(pos), _end(end) { advance(); }
+
+            const sample_type& operator*() const { return _sample; }
+            const sample_type* operator->() const { return &_sample; }
+            iterator& operator++() { advance(); return *this; }
+            void operator++(int) { advance(); }
+
+            bool operator==(std::default_sentinel_t) const { return _pos == nullptr; }
+        };
+
+        iterator begin() const { return iterator(_data + _first_row, _data + _size); }
+        std::default_sentinel_t end() const { return std::default_sentinel; }
+
+        // rows starting in [offset, offset + length), e.g. a CSVIndexEntry block
+        iterator rows(size_t offset, size_t length) const;
+
+        // pushes every row into a transcoder: classic frames as CANFrame, CAN FD as CANFlexibleFrame
+        template <typename Derived>
+        size_t replay_to(CANReceivable<Derived>& sink) const {
+            size_t count = 0;
+            for (const sample_type& sample : *this) {
+                if (sample.second.flags & CANFD_FDF)
+                    sink.receive_raw_message_vrtl(sample);
+                else
+                    sink.receive_raw_message_vrtl(std::pair<CANTime, CANFrame>{ sample.first, narrow_frame(sample.second) });
+                ++count;
+            }
+            return count;
+        }
+
+        size_t size_bytes() const { return _size; }
+    };
+
+}
+
+#endif // __unix__ || __APPLE__
@@ -0,0 +1,94 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/CANHelpers.hpp"
+#include "Candy/Core/CANIO.hpp"
+
+namespace Candy {
+
+    struct SocketCANOptions {
+        // frames read per recvmmsg call
+        size_t batch_size = 64;
+        // accept CAN FD frames (CAN_RAW_FD_FRAMES); classic frames still arrive as CANFrame
+        bool fd_frames = true;
+        // stamp with the controller's clock when the driver provides one;
+        // it is not necessarily on the system_clock epoch
+        bool hardware_timestamps = false;
+    };
+
+    // Raw SocketCAN reader. Frames are pulled `batch_size` at a time with a
+    // single recvmmsg and stamped from SO_TIMESTAMPING, so a busy bus costs
+    // one syscall per batch instead of one per frame.
+    class SocketCANSource {
+        int _fd = -1;
+        SocketCANOptions _options;
+
+        std::vector<std::pair<CANTime, CANFlexibleFrame>> _samples;
+        std::vector<mmsghdr> _msgs;
+        std::vector<iovec> _iovs;
+        std::vector<uint8_t> _control;
+        uint32_t _dropped = 0;
+
+        SocketCANSource(int fd, SocketCANOptions options);
+
+    public:
+        // Opens and binds a raw CAN socket on `interface_name`. With ids, the
+        // kernel drops every frame that is not one of them (up to
+        // CAN_RAW_FILTER_MAX ids; past that nothing is filtered).
+        static std::optional<SocketCANSource> create(std::string_view interface_name,
+                                                     std::span<const canid_t> ids = {},
+                                                     SocketCANOptions options = {});
+
+        SocketCANSource(SocketCANSource&& other) noexcept;
+        SocketCANSource& operator=(SocketCANSource&& other) noexcept;
+        SocketCANSource(const SocketCANSource&) = delete;
+        SocketCANSource& operator=(const SocketCANSource&) = delete;
+        ~SocketCANSource();
+
+        // Waits up to timeout_ms (-1 blocks) for frames and returns one batch.
+        // CAN FD frames have CANFD_FDF set. The span is valid until the next call.
+        std::span<const std::pair<CANTime, CANFlexibleFrame>> receive_batch(int timeout_ms = -1);
+
+        // calls fn(const std::pair<CANTime, CANFlexibleFrame>&) for one batch
+        template <typename Fn>
+        size_t read(Fn&& fn, int timeout_ms = -1) {
+            auto batch = receive_batch(timeout_ms);
+            for (const auto& sample : batch)
+                fn(sample);
+            return batch.size();
+        }
+
+        // pushes one batch into a transcoder: classic frames as CANFrame, CAN FD as CANFlexibleFrame
+        template <typename Derived>
+        size_t forward_to(CANReceivable<Derived>& sink, int timeout_ms = -1) {
+            return read([&](const auto& sample) {
+                if (sample.second.flags & CANFD_FDF)
+                    sink.receive_raw_message_vrtl(sample);
+                else
+                    sink.receive_raw_message_vrtl(std::pair<CANTime, CANFrame>{ sample.first, narrow_frame(sample.second) });
+            }, timeout_ms);
+        }
+
+        // frames the kernel dropped on this socket's queue (SO_RXQ_OVFL)
+        uint32_t dropped() const { return _dropped; }
+        int native_handle() const { return _fd; }
+
+        // exact-match filters for ids, keeping the EFF bit significant
+        static std::vector<CANFilter> filters_for(std::span<const canid_t> ids);
+    };
+
+}
+
+#endif // __linux__
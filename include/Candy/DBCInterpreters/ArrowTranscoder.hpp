@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/CANIOHelperTypes.hpp"
+#include "Candy/Core/CANHelpers.hpp"
+#include "Candy/Core/Signal/SignalBatch.hpp"
+#include "Candy/DBCInterpreters/File/FileTranscoder.hpp"
+
+namespace Candy {
+
+    // Writes decoded signals as an Apache Arrow IPC stream (pyarrow.ipc.open_stream,
+    // polars.read_ipc_stream), with the columns of decoded_frames.csv:
+    //
+    //   timestamp     timestamp[ns, UTC]
+    //   can_id        uint32
+    //   message_name  dictionary<int32, utf8>
+    //   signal_name   dictionary<int32, utf8>
+    //   signal_value  float64
+    //   raw_value     uint64
+    //   unit          dictionary<int32, utf8>
+    //   mux_value     uint64, null for messages without a multiplexer
+    //
+    // Frames whose multiplexer selects no signal have no rows. Record
+    // batches hold batch_size rows. The dictionaries are the DBC's
+    // message and signal tables, sent once before the first batch. The
+    // stream is written without any Arrow library; raw frames are not kept.
+    class ArrowTranscoder final : public FileTranscoder<ArrowTranscoder> {
+    public:
+        ~ArrowTranscoder();
+
+        ArrowTranscoder(ArrowTranscoder&& other) noexcept;
+        ArrowTranscoder& operator=(ArrowTranscoder&& other) noexcept;
+
+        ArrowTranscoder(const ArrowTranscoder&) = delete;
+        ArrowTranscoder& operator=(const ArrowTranscoder&) = delete;
+
+        static std::optional<ArrowTranscoder> create(const std::string& path, size_t batch_size = 65536);
+
+        //CANIO methods
+        void receive_message(const CANMessage& message);
+        void receive_raw_message(std::pair<CANTime, CANFrame> sample);
+        void receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample);
+        void receive_metadata(const CANDataStreamMetadata& metadata);
+
+        // read back from the stream; messages carry their signals but no payload
+        std::vector<CANMessage> transmit_messages(canid_t can_id);
+        std::vector<CANMessage> transmit_messages_in_range(canid_t can_id, CANTime start, CANTime end);
+        const CANDataStreamMetadata& transmit_metadata();
+
+        //transcoder methods
+        void batch_frame(std::pair<CANTime, CANFrame> sample);
+        void batch_frame(const std::pair<CANTime, CANFlexibleFrame>& sample);
+        void batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg);
+        void batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>& sample, const DecodeMessage& msg);
+        void flush_frames_batch();
+        void flush_decoded_signals_batch();
+        void flush_all_batches();
+        void store_message_metadata(canid_t message_id, const std::string& message_name, size_t message_size);
+
+    private:
+        ArrowTranscoder(FILE* file, std::string path, size_t batch_size);
+
+        // one entry per output row
+        struct RowColumns {
+            std::vector<int64_t> timestamp;
+            std::vector<uint32_t> can_id;
+            std::vector<int32_t> message;
+            std::vector<int32_t> signal;
+            std::vector<double> value;
+            std::vector<uint64_t> raw;
+            std::vector<uint64_t> mux;
+            std::vector<uint8_t> mux_valid;
+
+            size_t size() const { return timestamp.size(); }
+            void clear();
+        };
+
+        std::unique_ptr<FILE, int (*)(FILE*)> file{nullptr, fclose};
+        std::string path;
+        bool dictionaries_written = false;
+
+        // frames of known messages, decoded column-wise per message at flush;
+        // CAN FD frames and messages with signals past byte 8 go to the fd batch
+        std::vector<std::pair<CANTime, CANFrame>> decoded_signals_batch;
+        std::vector<std::pair<CANTime, CANFlexibleFrame>> decoded_fd_signals_batch;
+        ColumnBuffer decoded_columns;
+        RowColumns rows;
+
+        template <typename Frame>
+        void decode_rows(std::vector<std::pair<CANTime, Frame>>& batch);
+        void write_dictionaries();
+        void write_record_batch(size_t first, size_t count);
+        void write_full_record_batches();
+        bool write_message(const std::vector<uint8_t>& metadata, const std::vector<uint8_t>& body);
+    };
+
+}
@@ -1,15 +1,35 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <string_view>
 
 #include "Candy/Core/CANKernelTypes.hpp"
 #include "Candy/Core/CANIOHelperTypes.hpp"
+#include "Candy/Core/CANHelpers.hpp"
 #include "Candy/Core/CSVWriter.hpp"
+#include "Candy/Core/CSVIndex.hpp"
+#include "Candy/Core/Signal/SignalBatch.hpp"
 #include "Candy/DBCInterpreters/File/FileTranscoder.hpp"
 
 namespace Candy {
 
+    // Off by default: batches are formatted and flushed on the ingest thread.
+    // Enabled, a full batch is swapped out to a writer thread while ingest
+    // fills a recycled buffer, so at most max_pending + 2 batches are alive.
+    struct CSVAsyncFlush {
+        enum class Policy {
+            block, // ingest waits for the writer to catch up
+            drop   // the full batch is discarded and counted
+        };
+
+        bool enabled = false;
+        // full batches queued behind the one being written
+        size_t max_pending = 1;
+        Policy policy = Policy::block;
+    };
+
     class CSVTranscoder final : public FileTranscoder<CSVTranscoder> {
     public:
         
@@ -24,12 +44,17 @@ namespace Candy {
                       size_t batch_size, CSVWriter<3> messages_csv,
                       CSVWriter<5> frames_csv,
                       CSVWriter<8> decoded_frames_csv,
-                      CSVWriter<7> metadata_csv);
+                      CSVWriter<7> metadata_csv,
+                      CSVIndexWriter frames_index,
+                      CSVIndexWriter decoded_frames_index,
+                      CSVAsyncFlush async_flush = {});
 
-        static std::optional<CSVTranscoder> create(std::string_view base_path, size_t batch_size = 1000);
+        static std::optional<CSVTranscoder> create(std::string_view base_path, size_t batch_size = 1000,
+                                                   CSVAsyncFlush async_flush = {});
         //CANReceivable methods 
         void receive_message(const CANMessage& message);
         void receive_raw_message(std::pair<CANTime, CANFrame> sample);
+        void receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample);
         void receive_metadata(const CANDataStreamMetadata& metadata);
 
         std::vector<CANMessage> transmit_messages(canid_t can_id);
@@ -38,37 +63,66 @@ namespace Candy {
 
         //transcoder methods 
         void batch_frame(std::pair<CANTime, CANFrame> sample);
-        void batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const MessageDefinition& msg_def);
+        void batch_frame(const std::pair<CANTime, CANFlexibleFrame>& sample);
+        void batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg);
+        void batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>& sample, const DecodeMessage& msg);
         void flush_frames_batch();
         void flush_decoded_signals_batch();
         void flush_all_batches();
         void store_message_metadata(canid_t message_id, const std::string& message_name, size_t message_size);
+
+        // frames and decoded signal rows discarded by CSVAsyncFlush::Policy::drop
+        uint64_t dropped_frames() const { return dropped_frame_count; }
+        uint64_t dropped_decoded_rows() const { return dropped_decoded_row_count; }
         
     private:
+        struct AsyncWriter;
+        struct async_stopped_t {};
+
+        CSVTranscoder(async_stopped_t, CSVTranscoder&& other) noexcept;
+
         std::string base_path;
 
         CSVWriter<3> messages_csv;
         CSVWriter<5> frames_csv;
         CSVWriter<8> decoded_frames_csv;
         CSVWriter<7> metadata_csv;
+        // byte ranges of each flushed block per can_id, so range queries seek
+        // straight to the blocks they need
+        CSVIndexWriter frames_index;
+        CSVIndexWriter decoded_frames_index;
+        std::vector<CSVIndexEntry> index_entries;
         
         std::unordered_map<std::string, bool> headers_written;
-        std::vector<std::pair<CANTime, CANFrame>> frames_batch;
-        // Use struct instead of tuple to avoid std::string in tuple
-        struct DecodedSignalBatchEntry {
-            CANTime timestamp;
-            canid_t can_id;
-            MessageName message_name;
-            SignalName signal_name;
-            double signal_value;
-            uint64_t raw_value;
-            Unit unit;
-            std::optional<uint64_t> mux_value;
-        };
-        std::vector<DecodedSignalBatchEntry> decoded_signals_batch;
+        // classic frames are widened so rows keep arrival order
+        std::vector<std::pair<CANTime, CANFlexibleFrame>> frames_batch;
+        // frames of known messages, decoded column-wise per message at flush;
+        // CAN FD frames and messages with signals past byte 8 go to the fd batch
+        std::vector<std::pair<CANTime, CANFrame>> decoded_signals_batch;
+        std::vector<std::pair<CANTime, CANFlexibleFrame>> decoded_fd_signals_batch;
+        ColumnBuffer decoded_columns;
+
+        CSVAsyncFlush async_flush;
+        std::unique_ptr<AsyncWriter> async_writer;
+        uint64_t dropped_frame_count = 0;
+        uint64_t dropped_decoded_row_count = 0;
+
+        void write_frames(std::vector<std::pair<CANTime, CANFlexibleFrame>>& batch);
+        template <typename Frame>
+        void write_decoded_signals(std::vector<std::pair<CANTime, Frame>>& batch);
+        void flush_full_batches();
+        template <typename Frame>
+        uint64_t count_decoded_rows(const std::vector<std::pair<CANTime, Frame>>& batch) const;
+        void index_row(canid_t can_id, int64_t timestamp_ms);
+        template <typename Fn>
+        void for_each_row(const std::string& path, canid_t can_id, int64_t start_ms, int64_t end_ms, Fn&& fn);
 
-        //csv methods
-        std::string format_hex_data(const uint8_t* data, size_t len);
+        // async mode; the writer thread only ever touches the batch it was handed,
+        // decoded_columns, index_entries and the frames/decoded writers
+        void hand_off_batches();
+        void run_async_writer();
+        void wait_for_async_writer();
+        async_stopped_t stop_async_writer();
 
         //CANIO methods
         std::vector<std::string> parse_csv_line(const std::string& line);
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Candy/DBCInterpreters/DBC/DBCInterpreter.hpp"
+#include "Candy/Core/Signal/NumericValue.hpp"
+
+namespace Candy {
+
+    // Turns a fixed DBC into a header of StaticSignalCodec instances and a
+    // switch-on-can_id decode function. Driven by candy_codegen at build time.
+    class CodecGenerator : public DBCInterpreter<CodecGenerator> {
+        struct GenSignal {
+            std::string name;
+            unsigned start_bit;
+            unsigned size;
+            char byte_order;
+            char sign;
+            double factor;
+            double offset;
+            std::string unit;
+            std::optional<unsigned> mux_val;
+            NumericValueType value_type;
+        };
+
+        struct GenMessage {
+            std::string name;
+            size_t size = 0;
+            std::optional<GenSignal> multiplexer;
+            std::vector<GenSignal> signals;
+        };
+
+        // ordered so the generated header is stable across runs
+        std::map<uint32_t, GenMessage> _msgs;
+
+    public:
+        std::string generate(const std::string& name_space, const std::string& source_name) const;
+
+        size_t message_count() const { return _msgs.size(); }
+
+        // ---- Interpreter methods ----
+
+        void sg(
+            uint32_t message_id,
+            std::optional<unsigned> sg_mux_switch_val,
+            const std::string& sg_name,
+            unsigned sg_start_bit,
+            unsigned sg_size,
+            char sg_byte_order,
+            char sg_sign,
+            double sg_factor,
+            double sg_offset,
+            double sg_min,
+            double sg_max,
+            const std::string& sg_unit,
+            const std::vector<size_t>& rec_ords
+        );
+
+        void sg_mux(
+            uint32_t message_id,
+            const std::string& sg_name,
+            unsigned sg_start_bit,
+            unsigned sg_size,
+            char sg_byte_order,
+            char sg_sign,
+            const std::string& sg_unit,
+            const std::vector<size_t>& rec_ords
+        );
+
+        void bo(
+            uint32_t message_id,
+            const std::string& msg_name,
+            size_t msg_size,
+            size_t transmitter_ord
+        );
+
+        void sig_valtype(
+            unsigned message_id,
+            const std::string& sig_name,
+            unsigned sig_ext_val_type
+        );
+    };
+
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/CANIOHelperTypes.hpp"
+#include "Candy/Core/CANHelpers.hpp"
+#include "Candy/Core/Signal/SignalBatch.hpp"
+#include "Candy/DBCInterpreters/File/FileTranscoder.hpp"
+
+namespace Candy {
+
+    // One column chunk of a columnar session: the rows of one column of one
+    // can_id from a single flushed batch, as a byte range of the file.
+    // Times are CANTime ticks.
+    struct ColumnChunk {
+        static constexpr uint32_t frames_column = UINT32_MAX;
+        static constexpr uint32_t mux_column = UINT32_MAX - 1;
+
+        uint64_t offset;
+        uint32_t length;
+        uint32_t rows;
+        canid_t can_id;
+        // DecodeTable signal index, or frames_column / mux_column
+        uint32_t column;
+        int64_t first_time;
+        int64_t last_time;
+    };
+
+    static_assert(sizeof(ColumnChunk) == 40);
+
+    // Writes a session as one file of per-column chunks: each flush sorts the
+    // batch by can_id and appends, per id, a chunk of raw frames, one of mux
+    // values and one per decoded signal. Timestamps are delta-of-delta
+    // varints; raw signal values are zigzag delta varints, or XOR-with-previous
+    // for IEEE float signals. The chunk list, the signal and message tables and
+    // the stream metadata go in a footer written on close, so a closed session
+    // can be reopened with open() and read one column at a time.
+    class ColumnarTranscoder final : public FileTranscoder<ColumnarTranscoder> {
+    public:
+        ~ColumnarTranscoder();
+
+        ColumnarTranscoder(ColumnarTranscoder&& other) noexcept;
+        ColumnarTranscoder& operator=(ColumnarTranscoder&& other) noexcept;
+
+        ColumnarTranscoder(const ColumnarTranscoder&) = delete;
+        ColumnarTranscoder& operator=(const ColumnarTranscoder&) = delete;
+
+        // truncates path and starts a new session
+        static std::optional<ColumnarTranscoder> create(const std::string& path, size_t batch_size = 10000);
+        // a closed session, read-only: receive_* calls are ignored
+        static std::optional<ColumnarTranscoder> open(const std::string& path);
+
+        //CANIO methods
+        void receive_message(const CANMessage& message);
+        void receive_raw_message(std::pair<CANTime, CANFrame> sample);
+        void receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample);
+        void receive_metadata(const CANDataStreamMetadata& metadata);
+
+        std::vector<CANMessage> transmit_messages(canid_t can_id);
+        std::vector<CANMessage> transmit_messages_in_range(canid_t can_id, CANTime start, CANTime end);
+        const CANDataStreamMetadata& transmit_metadata();
+
+        // one signal's (time, value) rows, reading only that signal's chunks
+        std::vector<std::pair<CANTime, double>> transmit_signal(canid_t can_id, std::string_view signal_name,
+                                                                CANTime start, CANTime end);
+
+        //transcoder methods
+        void batch_frame(std::pair<CANTime, CANFrame> sample);
+        void batch_frame(const std::pair<CANTime, CANFlexibleFrame>& sample);
+        void batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg);
+        void batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>& sample, const DecodeMessage& msg);
+        // frames and signals of an id are written together, so either flush writes the whole batch
+        void flush_frames_batch();
+        void flush_decoded_signals_batch();
+        void flush_all_batches();
+        void store_message_metadata(canid_t message_id, const std::string& message_name, size_t message_size);
+
+        std::span<const ColumnChunk> chunks() const { return session_chunks; }
+
+    private:
+        enum class ValueEncoding : uint8_t {
+            delta, // zigzag varint of raw - previous raw
+            xor_float // varint of raw ^ previous raw, trailing zeros stripped
+        };
+
+        struct SessionSignal {
+            uint32_t id;
+            canid_t can_id;
+            std::optional<uint64_t> mux_val;
+            double factor;
+            double offset;
+            NumericValueType value_type;
+            ValueEncoding encoding;
+            std::string name;
+            std::string unit;
+        };
+
+        struct SessionMessage {
+            canid_t can_id;
+            size_t size;
+            std::string name;
+        };
+
+        ColumnarTranscoder(FILE* file, std::string path, size_t batch_size, bool writable);
+
+        std::unique_ptr<FILE, int (*)(FILE*)> file{nullptr, fclose};
+        std::string path;
+        bool writable;
+        uint64_t file_end = 0;
+
+        std::vector<SessionMessage> session_messages;
+        // written with the footer; signals are taken from decode_table before the first flush
+        std::vector<SessionSignal> session_signals;
+        std::vector<ColumnChunk> session_chunks;
+
+        // classic frames are widened so a batch sorts as one array
+        std::vector<std::pair<CANTime, CANFlexibleFrame>> frames_batch;
+        ColumnBuffer decoded_columns;
+        // the chunk being encoded
+        std::vector<uint8_t> chunk_buffer;
+        std::vector<int64_t> chunk_times;
+        std::vector<uint64_t> chunk_raw;
+
+        void store_signals();
+        void write_batch();
+        void append_chunk(canid_t can_id, uint32_t column);
+        void write_footer();
+        bool load_footer();
+        bool read_chunk(const ColumnChunk& chunk, std::vector<uint8_t>& out);
+        const SessionSignal* find_signal(uint32_t id) const;
+        std::string_view find_message_name(canid_t can_id) const;
+    };
+
+}
@@ -2,10 +2,12 @@
 
 #include <cstddef>
 #include <optional>
+#include <span>
 #include <vector>
 #include <unordered_map>
 
 #include "Candy/Core/CANIOHelperTypes.hpp"
+#include "Candy/Core/Signal/DecodeTable.hpp"
 #include "Candy/DBCInterpreters/File/FileTranscoderConcepts.hpp"
 #include "Candy/DBCInterpreters/DBC/DBCInterpreter.hpp"
 #include "Candy/DBCInterpreters/DBC/DBCInterpreterConcepts.hpp"
@@ -34,7 +36,9 @@ namespace Candy {
         }
 
     protected:
+        // staging for DBC callbacks, compiled into decode_table and released by parse_dbc
         std::unordered_map<canid_t, MessageDefinition> messages;
+        DecodeTable decode_table;
         size_t batch_size;
         size_t frames_batch_count;
         size_t decoded_signals_batch_count;
@@ -50,8 +54,8 @@ namespace Candy {
             static_cast<Derived&>(*this).batch_frame(sample);
         }
 
-        void batch_decoded_signals_vrtl(std::pair<CANTime, CANFrame> sample, const MessageDefinition& msg_def) {
-            static_cast<Derived&>(*this).batch_decoded_signals(sample, msg_def);
+        void batch_decoded_signals_vrtl(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg) {
+            static_cast<Derived&>(*this).batch_decoded_signals(sample, msg);
         }
 
         void flush_frames_batch_vrtl() {
@@ -67,6 +71,15 @@ namespace Candy {
         }
 
     public:
+        // parses the DBC, then compiles its messages into decode_table
+        bool parse_dbc(std::string_view dbc_src);
+
+        // ids of the parsed messages, e.g. for SocketCANSource filters
+        std::span<const canid_t> message_ids() const { return decode_table.ids(); }
+
+        // the DBC as compiled by parse_dbc
+        const DecodeTable& table() const { return decode_table; }
+
         //DBC methods 
         void sg(canid_t message_id, std::optional<unsigned> mux_val, const std::string& signal_name,
             unsigned start_bit, unsigned bit_size, char byte_order, char sign_type,
@@ -84,9 +97,17 @@ namespace Candy {
 
     class SQLTranscoder;
     class CSVTranscoder;
+    class ColumnarTranscoder;
+    class ArrowTranscoder;
+    class MDFTranscoder;
+    class MotecTranscoder;
 
     extern template class FileTranscoder<CSVTranscoder>;
     extern template class FileTranscoder<SQLTranscoder>;
+    extern template class FileTranscoder<ColumnarTranscoder>;
+    extern template class FileTranscoder<ArrowTranscoder>;
+    extern template class FileTranscoder<MDFTranscoder>;
+    extern template class FileTranscoder<MotecTranscoder>;
 
 }
 
@@ -5,6 +5,7 @@
 #include "Candy/Core/CANIO.hpp"
 #include "Candy/Core/CANKernelTypes.hpp"
 #include "Candy/Core/CANIOHelperTypes.hpp"
+#include "Candy/Core/Signal/DecodeTable.hpp"
 
 namespace Candy {
 
@@ -14,8 +15,8 @@ namespace Candy {
     };
 
     template <typename T>
-    concept HasBatchDecodedSignals = requires(T t, std::pair<CANTime, CANFrame> sample, const MessageDefinition& msg_def) {
-        { t.batch_decoded_signals(sample, msg_def) } -> std::same_as<void>;
+    concept HasBatchDecodedSignals = requires(T t, std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg) {
+        { t.batch_decoded_signals(sample, msg) } -> std::same_as<void>;
     };
 
     template <typename T>
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/CANIOHelperTypes.hpp"
+#include "Candy/Core/CANHelpers.hpp"
+#include "Candy/Core/Signal/SignalBatch.hpp"
+#include "Candy/DBCInterpreters/File/FileTranscoder.hpp"
+
+namespace Candy {
+
+    // Writes a session as an ASAM MDF 4.10 file. Raw frames go to the bus
+    // logging channel groups CAN_DataFrame (classic) and CAN_DataFrame with
+    // 64 data bytes (CAN FD); each DBC message gets its own channel group
+    // with a channel per signal, typed by the signal's value type and
+    // converted by a linear rule built from its factor and offset. Signals
+    // a multiplexer leaves out are marked by invalidation bits.
+    //
+    // Each flush appends one DT block per channel group and links it
+    // through a new DL block, then updates the cycle counts, so the file
+    // is readable while it grows. It is marked unfinalized until closed.
+    class MDFTranscoder final : public FileTranscoder<MDFTranscoder> {
+    public:
+        ~MDFTranscoder();
+
+        MDFTranscoder(MDFTranscoder&& other) noexcept;
+        MDFTranscoder& operator=(MDFTranscoder&& other) noexcept;
+
+        MDFTranscoder(const MDFTranscoder&) = delete;
+        MDFTranscoder& operator=(const MDFTranscoder&) = delete;
+
+        static std::optional<MDFTranscoder> create(const std::string& path, size_t batch_size = 10000);
+
+        //CANIO methods
+        void receive_message(const CANMessage& message);
+        void receive_raw_message(std::pair<CANTime, CANFrame> sample);
+        void receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample);
+        void receive_metadata(const CANDataStreamMetadata& metadata);
+
+        // read back from the raw frame groups and decoded again
+        std::vector<CANMessage> transmit_messages(canid_t can_id);
+        std::vector<CANMessage> transmit_messages_in_range(canid_t can_id, CANTime start, CANTime end);
+        const CANDataStreamMetadata& transmit_metadata();
+
+        //transcoder methods
+        void batch_frame(std::pair<CANTime, CANFrame> sample);
+        void batch_frame(const std::pair<CANTime, CANFlexibleFrame>& sample);
+        void batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg);
+        void batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>& sample, const DecodeMessage& msg);
+        // raw and decoded groups are appended together, so either flush writes the whole batch
+        void flush_frames_batch();
+        void flush_decoded_signals_batch();
+        void flush_all_batches();
+        void store_message_metadata(canid_t message_id, const std::string& message_name, size_t message_size);
+
+    private:
+        struct Channel;
+
+        // one data group holding one channel group
+        struct Group {
+            uint64_t dg_at = 0;
+            uint64_t cg_at = 0;
+            // the link the next DL block is written to: dg_data, then dl_dl_next
+            uint64_t data_link_at = 0;
+            uint64_t data_bytes = 0;
+            uint64_t cycles = 0;
+            uint32_t record_size = 0;
+        };
+
+        MDFTranscoder(FILE* file, std::string path, size_t batch_size);
+
+        std::unique_ptr<FILE, int (*)(FILE*)> file{nullptr, fclose};
+        std::string path;
+        uint64_t file_end = 0;
+        // hd_start_time_ns: the first flushed frame; record times are seconds after it
+        std::optional<int64_t> start_time;
+        // the link the next data group is written to: hd_dg_first, then dg_dg_next
+        uint64_t dg_link_at = 0;
+        // the CAN bus source block shared by every channel group
+        uint64_t source_at = 0;
+
+        std::optional<Group> classic_frames;
+        std::optional<Group> fd_frames;
+        // by decode_table slot
+        std::vector<std::optional<Group>> message_groups;
+
+        // classic frames are widened; CANFD_FDF or a payload past 8 bytes marks CAN FD
+        std::vector<std::pair<CANTime, CANFlexibleFrame>> frames_batch;
+        ColumnBuffer decoded_columns;
+        std::vector<uint8_t> classic_records;
+        std::vector<uint8_t> fd_records;
+        std::vector<uint8_t> message_records;
+
+        void write_batch();
+        void write_header();
+        void finalize();
+        uint64_t append(const std::vector<uint8_t>& block);
+        void patch(uint64_t at, const void* data, size_t size);
+        void link(uint64_t at, uint64_t target) { patch(at, &target, sizeof(target)); }
+
+        Group& frame_group(bool fd);
+        Group& message_group(uint32_t slot);
+        void add_group(Group& group, std::string_view name, uint16_t flags, uint32_t data_bytes, uint32_t inval_bytes,
+                       const std::vector<Channel>& channels);
+        uint64_t add_text(const char* id, std::string_view text);
+        void append_records(Group& group, const std::vector<uint8_t>& records);
+
+        double relative_time(CANTime time) const;
+        void read_records(const Group& group, std::vector<uint8_t>& out);
+    };
+
+}
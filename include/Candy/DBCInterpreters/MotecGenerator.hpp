@@ -1,10 +1,17 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include "Candy/DBCInterpreters/DBC/DBCInterpreter.hpp"
 #include "Candy/Core/CANKernelTypes.hpp"
 #include "Candy/Core/CANIOHelperTypes.hpp"
+#include "Candy/Core/Signal/SignalCodec.hpp"
+#include "Candy/Core/Signal/NumericValue.hpp"
 
 namespace Candy {
 
@@ -17,8 +24,8 @@ namespace Candy {
         std::string comment;          // (optional)
         std::string log_date;         // 3-Sep-25
         std::string log_time;         // 11:54:02
-        int sample_rate;              // 333 (Hz)
-        double duration;              // 201.159 (s)
+        int sample_rate = 0;          // 333 (Hz)
+        double duration = 0.0;        // 201.159 (s)
         std::string range;            // entire outing
         std::vector<double> beacon_markers; // 05.679 69.708 133.830 198.039
         // Workbook/Worksheet fields
@@ -28,35 +35,91 @@ namespace Candy {
         std::string engine_id;
         std::string session;
         std::string practice;
-        double origin_time;           // 0 (s)
-        double start_time;            // 0 (s)
-        double end_time;              // 201.159 (s)
-        double start_distance;        // 0 (ft)
-        double end_distance;          // 11635 (ft)
+        double origin_time = 0.0;     // 0 (s)
+        double start_time = 0.0;      // 0 (s)
+        double end_time = 0.0;        // 201.159 (s)
+        double start_distance = 0.0;  // 0 (ft)
+        double end_distance = 0.0;    // 11635 (ft)
     };
 
 
+    // Streams a MoTeC CSV export back into CAN frames. Each column is encoded
+    // through the DBC signal of the same name, with spaces and punctuation
+    // read as underscores ("Brake Pressure RL" -> Brake_Pressure_RL); columns
+    // without one are skipped. The file is mmapped and rows are tokenized in
+    // place. Every row yields one frame per message that has a value in it,
+    // stamped with Log Date + Log Time + the row's Time column.
     class MotecGenerator : public DBCInterpreter<MotecGenerator> {
     public:
         MotecGenerator(const std::string& csv_path);
-        ~MotecGenerator() = default;
+        ~MotecGenerator();
 
+        MotecGenerator(MotecGenerator&& other) noexcept;
+        MotecGenerator& operator=(MotecGenerator&& other) noexcept;
+        MotecGenerator(const MotecGenerator&) = delete;
+        MotecGenerator& operator=(const MotecGenerator&) = delete;
+
+        // maps the file and reads the header and channel rows; call after parse_dbc
         bool parse_csv();
 
-        const std::pair<CANTime, CANFrame>* get_frame() const;
+        // the next frame, or nullptr once every row has been read
+        const std::pair<CANTime, CANFrame>* get_frame();
+
+        const MotecHeader& header() const { return motec_header; }
+        // columns that found a signal to encode into
+        size_t bound_columns() const;
+
+        //DBC methods
+        void bo(canid_t message_id, std::string message_name, size_t message_size, size_t transmitter);
+
+        void sg(canid_t message_id, std::optional<unsigned> mux_val, const std::string& signal_name,
+                unsigned start_bit, unsigned bit_size, char byte_order, char sign_type,
+                double factor, double offset, double min_val, double max_val,
+                std::string unit, std::vector<size_t> receivers);
+
+        void sig_valtype(canid_t message_id, const std::string& signal_name, unsigned value_type);
 
     private:
+        struct MotecMessage {
+            canid_t can_id;
+            size_t size;
+        };
+
+        struct MotecSignal {
+            canid_t can_id;
+            std::string name;
+            SignalCodec codec;
+            double factor;
+            double offset;
+            NumericValueType value_type;
+        };
+
         std::string path;
-        std::vector<std::pair<CANTime, CANFrame>> frames;
+        const char* data = nullptr;
+        size_t size = 0;
+        // start of the next data row
+        const char* cursor = nullptr;
+
+        MotecHeader motec_header;
+        CANTime log_start {};
+
+        std::vector<MotecMessage> messages;
+        std::vector<MotecSignal> signals;
+        // per CSV column: index into signals, or -1
+        std::vector<int32_t> column_signals;
+        // per signal: index into row_frames
+        std::vector<uint32_t> signal_frames;
+        size_t time_column = 0;
 
-        int current;
+        // one frame per message, kept between rows so blank cells hold their value
+        std::vector<std::pair<CANTime, CANFrame>> row_frames;
+        std::vector<uint8_t> row_present;
+        size_t current = 0;
 
-        static void parse_header(MotecHeader& header, const std::string& data);
-        static void parse_messages(std::vector<MessageDefinition>& messages, const std::string& data);
-        
-        void parse_data_row(const std::string& row_data, 
-                           const std::vector<std::string>& column_names, 
-                           const std::vector<std::string>& column_units);
+        void parse_header(std::string_view line);
+        bool bind_columns(std::string_view names);
+        bool parse_data_row();
+        void encode(const MotecSignal& signal, double value, CANFrame& frame) const;
     };
 
-}
\ No newline at end of file
+}
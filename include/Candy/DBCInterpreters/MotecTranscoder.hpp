@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/CANIOHelperTypes.hpp"
+#include "Candy/Core/CANHelpers.hpp"
+#include "Candy/Core/Signal/SignalBatch.hpp"
+#include "Candy/DBCInterpreters/File/FileTranscoder.hpp"
+#include "Candy/DBCInterpreters/MotecGenerator.hpp"
+
+namespace Candy {
+
+    // Writes decoded signals as a MoTeC i2 log (.ld). Every DBC signal that
+    // received a frame becomes a float32 channel. The channels of a message
+    // share a fixed sample rate: its mean frame rate, rounded to whole Hz.
+    // Every channel spans the whole session and holds the previous value
+    // between frames, as do signals a multiplexer leaves out. Driver, vehicle, venue, session
+    // and comment come from the MotecHeader.
+    //
+    // An .ld channel is one contiguous array, so decoded values are kept in
+    // memory and the file is rewritten by flush_all_batches and on close.
+    // Frames are expected in time order.
+    class MotecTranscoder final : public FileTranscoder<MotecTranscoder> {
+    public:
+        ~MotecTranscoder();
+
+        MotecTranscoder(MotecTranscoder&& other) noexcept;
+        MotecTranscoder& operator=(MotecTranscoder&& other) noexcept;
+
+        MotecTranscoder(const MotecTranscoder&) = delete;
+        MotecTranscoder& operator=(const MotecTranscoder&) = delete;
+
+        static std::optional<MotecTranscoder> create(const std::string& path, const MotecHeader& header = {},
+                                                     size_t batch_size = 10000);
+
+        //CANIO methods
+        void receive_message(const CANMessage& message);
+        void receive_raw_message(std::pair<CANTime, CANFrame> sample);
+        void receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample);
+        void receive_metadata(const CANDataStreamMetadata& metadata);
+
+        // read back from the log at the channel rate; values are float32 and carry no mux value
+        std::vector<CANMessage> transmit_messages(canid_t can_id);
+        std::vector<CANMessage> transmit_messages_in_range(canid_t can_id, CANTime start, CANTime end);
+        const CANDataStreamMetadata& transmit_metadata();
+
+        //transcoder methods
+        void batch_frame(std::pair<CANTime, CANFrame> sample);
+        void batch_frame(const std::pair<CANTime, CANFlexibleFrame>& sample);
+        void batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg);
+        void batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>& sample, const DecodeMessage& msg);
+        void flush_frames_batch();
+        void flush_decoded_signals_batch();
+        void flush_all_batches();
+        void store_message_metadata(canid_t message_id, const std::string& message_name, size_t message_size);
+
+    private:
+        MotecTranscoder(FILE* file, std::string path, const MotecHeader& header, size_t batch_size);
+
+        // the decoded frames of one message, a column per signal
+        struct Series {
+            std::vector<int64_t> time;
+            std::vector<std::vector<float>> values;
+        };
+
+        std::unique_ptr<FILE, int (*)(FILE*)> file{nullptr, fclose};
+        std::string path;
+        MotecHeader header;
+
+        std::vector<std::pair<CANTime, CANFrame>> decoded_signals_batch;
+        std::vector<std::pair<CANTime, CANFlexibleFrame>> decoded_fd_signals_batch;
+        ColumnBuffer decoded_columns;
+        // by decode_table slot
+        std::vector<Series> series;
+        // ns since the epoch of the first and last frame
+        std::optional<int64_t> start_time;
+        int64_t end_time = 0;
+
+        template <typename Frame>
+        void decode_series(std::vector<std::pair<CANTime, Frame>>& batch);
+        void write_log();
+    };
+
+}
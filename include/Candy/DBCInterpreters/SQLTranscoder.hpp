@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <optional>
 #include <string>
 #include <vector>
 #include <memory>
@@ -7,10 +9,22 @@
 
 #include "Candy/Core/CANKernelTypes.hpp"
 #include "Candy/Core/CANIOHelperTypes.hpp"
+#include "Candy/Core/CANHelpers.hpp"
+#include "Candy/Core/Signal/SignalBatch.hpp"
 #include "Candy/DBCInterpreters/File/FileTranscoder.hpp"
 
 namespace Candy {
 
+    enum class SQLSchema {
+        // one row per frame/signal with names, units and hex payloads inline;
+        // signal rows carry the id of the frame they were decoded from
+        text,
+        // frame_data/signal_data rows hold integer keys into frames/signals,
+        // payloads as BLOBs and microsecond timestamps; `frames` and
+        // `decoded_frames` become views with the text schema's columns
+        normalized
+    };
+
     class SQLTranscoder final : public FileTranscoder<SQLTranscoder> {
     public:
         ~SQLTranscoder();
@@ -21,11 +35,13 @@ namespace Candy {
         SQLTranscoder(const SQLTranscoder&) = delete;
         SQLTranscoder& operator=(const SQLTranscoder&) = delete;
         
-        static std::optional<SQLTranscoder> create(const std::string& db_file_path, size_t batch_size = 10000);
+        static std::optional<SQLTranscoder> create(const std::string& db_file_path, size_t batch_size = 10000,
+                                                   SQLSchema schema = SQLSchema::text);
 
         //CANIO methods 
         void receive_message(const CANMessage& message);
         void receive_raw_message(std::pair<CANTime, CANFrame> sample);
+        void receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample);
         void receive_metadata(const CANDataStreamMetadata& metadata);
 
         std::vector<CANMessage> transmit_messages(canid_t can_id);
@@ -35,31 +51,96 @@ namespace Candy {
 
         //transcoder methods 
         void batch_frame(std::pair<CANTime, CANFrame> sample);
-        void batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const MessageDefinition& msg_def);
+        void batch_frame(const std::pair<CANTime, CANFlexibleFrame>& sample);
+        // the sample's rows are keyed to the frame batched just before it
+        void batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg);
+        void batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>& sample, const DecodeMessage& msg);
         void flush_frames_batch();
         void flush_decoded_signals_batch();
         void flush_all_batches();
         void store_message_metadata(canid_t message_id, const std::string& message_name, size_t message_size);
 
+        // (can_id, time) and frame key indexes for range queries. Built on
+        // the first transmit or at close, so ingest before any query does
+        // not maintain them; ingest after one does.
+        void build_indexes();
+
     private:
-        SQLTranscoder(sqlite3* db, const std::string& db_file_path, size_t batch_size);
+        SQLTranscoder(sqlite3* db, const std::string& db_file_path, size_t batch_size, SQLSchema schema);
 
         std::unique_ptr<sqlite3, decltype(&sqlite3_close)> db;
         std::string db_path;
+        // readback runs on its own read-only connection, opened on first use
+        std::unique_ptr<sqlite3, decltype(&sqlite3_close)> read_db{nullptr, sqlite3_close};
+        sqlite3_stmt* range_query_stmt = nullptr;
+        bool indexes_built = false;
+        SQLSchema schema;
+        // normalized: signals rows are written once, before the first decoded row
+        bool signals_stored = false;
         sqlite3_stmt* decoded_signals_insert_stmt;
         sqlite3_stmt* frames_insert_stmt;
+        // rows_per_insert rows per step; the single-row statements take the remainder
+        sqlite3_stmt* decoded_signals_multi_insert_stmt;
+        sqlite3_stmt* frames_multi_insert_stmt;
+
+        static constexpr size_t rows_per_insert = 64;
+
+        struct DecodedRow {
+            CANTime timestamp;
+            int64_t frame_id;
+            canid_t can_id;
+            uint32_t slot;
+            uint32_t signal;
+            double value;
+            int64_t raw;
+            std::optional<int64_t> mux;
+        };
+
+        // a frame of a known message with the id of its frames row
+        template <typename Frame>
+        struct DecodedSample {
+            std::pair<CANTime, Frame> sample;
+            int64_t frame_id;
+        };
+
+        // classic frames are widened so rows keep arrival order; ids are
+        // assigned as frames are batched, the last batched one being next_frame_id - 1
+        std::vector<std::pair<CANTime, CANFlexibleFrame>> frames_batch;
+        int64_t next_frame_id = 1;
+        // frames of known messages, decoded column-wise per message at flush;
+        // CAN FD frames and messages with signals past byte 8 go to the fd batch
+        std::vector<DecodedSample<CANFrame>> decoded_signals_batch;
+        std::vector<DecodedSample<CANFlexibleFrame>> decoded_fd_signals_batch;
+        ColumnBuffer decoded_columns;
+        std::array<DecodedRow, rows_per_insert> decoded_rows;
+        size_t decoded_row_count = 0;
 
         //sql methods 
         bool prepare_statements();
         void finalize_statements();
+        void bind_frame(sqlite3_stmt* stmt, int first_param, int64_t frame_id, const std::pair<CANTime, CANFlexibleFrame>& sample);
+        void bind_decoded_row(sqlite3_stmt* stmt, int first_param, const DecodedRow& row);
+        void step_insert(sqlite3_stmt* stmt);
+        void insert_frames();
+        void insert_decoded_signals();
+        template <typename Frame>
+        void insert_decoded_signals(std::vector<DecodedSample<Frame>>& batch);
+        void push_decoded_row(const DecodedRow& row);
+        void flush_full_batches();
         std::string build_insert_sql(const std::string& table, const std::vector<std::pair<std::string, std::string>>& data);
         void create_tables();
+        void create_normalized_tables();
+        void drop_relation(const char* name);
+        void store_signals();
+        int frame_params() const { return schema == SQLSchema::normalized ? 4 : 6; }
+        int decoded_params() const { return schema == SQLSchema::normalized ? 6 : 9; }
         void execute_sql(const std::string& sql);
         std::string escape_sql(const std::string& input);
 
         //CANIO Methods
         void create_metadata_table();
-        void load_decoded_signals_for_messages(sqlite3* db, std::vector<CANMessage>& messages);
+        bool open_read_db();
+        bool prepare_range_query();
         void parse_hex_data(const std::string& hex_str, uint8_t* data, size_t len);
         void parse_message_names_json(const std::string& json_str, CANDataStreamMetadata& metadata);
         void parse_message_counts_json(const std::string& json_str, CANDataStreamMetadata& metadata);
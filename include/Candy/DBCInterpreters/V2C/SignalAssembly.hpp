@@ -1,15 +1,19 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <concepts>
+#include <optional>
+#include <vector>
 
+#include "Candy/Core/Signal/SignalBatch.hpp"
 #include "Candy/DBCInterpreters/V2C/TranslatedSignal.hpp"
 
 namespace Candy {
     
     template <typename Derived>
-    concept IsSignalAssembler = requires(Derived& self, int64_t mux_val, uint64_t fd) {
-        { self.assemble(mux_val, fd) } -> std::convertible_to<uint64_t>;
+    concept IsSignalAssembler = requires(Derived& self, typename Derived::value_type val) {
+        { self.update(val) } -> std::same_as<typename Derived::value_type>;
         { self.reset() } -> std::same_as<void>;
     };
     template<typename T>
@@ -18,8 +22,27 @@ namespace Candy {
                               std::is_same_v<T, float>    ||
                               std::is_same_v<T, double>;
 
+    // a decoded raw value as the signal's numeric type, floats from the low bits
+    template <typename Numeric>
+    Numeric raw_to_value(uint64_t raw) {
+        Numeric val;
+        std::memcpy(&val, &raw, sizeof(Numeric));
+        return val;
+    }
+
+    template <typename Numeric>
+    uint64_t value_to_raw(Numeric val) {
+        uint64_t raw = 0;
+        std::memcpy(&raw, &val, sizeof(Numeric));
+        return raw;
+    }
+
+    // Derived folds each decoded sample into its state through update(),
+    // which returns the value to publish for the interval so far.
     template <typename Derived, typename Numeric>
     struct SignalAssembler {
+        using value_type = Numeric;
+
         const TranslatedSignal _sig;
         Numeric _val{0};
 
@@ -27,8 +50,17 @@ namespace Candy {
             _sig(sig) 
         {}
 
-        uint64_t assemble_vrtl(int64_t mux_val, uint64_t fd) {
-            return static_cast<Derived*>(this)->assemble(mux_val, fd);
+        // decodes the signal from data and encodes the assembled value into payload
+        void assemble(int64_t mux_val, const uint8_t* data, uint8_t* payload) {
+            if (!_sig.is_active(mux_val))
+                return;
+
+            Numeric val = static_cast<Derived*>(this)->update(raw_to_value<Numeric>(_sig.decode(data)));
+            _sig.encode(value_to_raw(val), payload);
+        }
+
+        void assemble_vrtl(int64_t mux_val, const uint8_t* data, uint8_t* payload) {
+            assemble(mux_val, data, payload);
         }
 
         void reset_vrtl() {
@@ -47,7 +79,7 @@ namespace Candy {
             SignalAssembler<LastSignal<Numeric>, Numeric>(sig) 
         {}
 
-        uint64_t assemble(int64_t mux_val, uint64_t fd);
+        Numeric update(Numeric val);
         void reset();
     };
 
@@ -59,10 +91,138 @@ namespace Candy {
             SignalAssembler<AverageSignal<Numeric>, Numeric>(sig)
         {}
 
-        uint64_t assemble(int64_t mux_val, uint64_t fd);
+        Numeric update(Numeric val);
+        void reset();
+    };
+
+    // MIN, MAX, RMS, COUNT and DELTA follow the signal's physical value, so
+    // they hold under a DBC factor and offset
+
+    template <typename Numeric>
+    struct MinSignal : public SignalAssembler<MinSignal<Numeric>, Numeric> {
+        bool _seen{false};
+
+        MinSignal(const TranslatedSignal sig) : 
+            SignalAssembler<MinSignal<Numeric>, Numeric>(sig)
+        {}
+
+        Numeric update(Numeric val);
+        void reset();
+    };
+
+    template <typename Numeric>
+    struct MaxSignal : public SignalAssembler<MaxSignal<Numeric>, Numeric> {
+        bool _seen{false};
+
+        MaxSignal(const TranslatedSignal sig) : 
+            SignalAssembler<MaxSignal<Numeric>, Numeric>(sig)
+        {}
+
+        Numeric update(Numeric val);
+        void reset();
+    };
+
+    template <typename Numeric>
+    struct RmsSignal : public SignalAssembler<RmsSignal<Numeric>, Numeric> {
+        double _sum_squares{0};
+        uint64_t _num_samples{0};
+
+        RmsSignal(const TranslatedSignal sig) : 
+            SignalAssembler<RmsSignal<Numeric>, Numeric>(sig)
+        {}
+
+        Numeric update(Numeric val);
+        void reset();
+    };
+
+    // samples seen this interval, saturated to what the signal can hold
+    template <typename Numeric>
+    struct CountSignal : public SignalAssembler<CountSignal<Numeric>, Numeric> {
+        uint64_t _num_samples{0};
+
+        CountSignal(const TranslatedSignal sig) : 
+            SignalAssembler<CountSignal<Numeric>, Numeric>(sig)
+        {}
+
+        Numeric update(Numeric val);
+        void reset();
+    };
+
+    template <typename Numeric>
+    struct FirstSignal : public SignalAssembler<FirstSignal<Numeric>, Numeric> {
+        bool _seen{false};
+
+        FirstSignal(const TranslatedSignal sig) : 
+            SignalAssembler<FirstSignal<Numeric>, Numeric>(sig)
+        {}
+
+        Numeric update(Numeric val);
         void reset();
     };
 
+    // change since the last value of the previous interval; integer
+    // counters that roll over within the signal's width still come out right,
+    // and an offset that is not a whole number of steps is rounded
+    template <typename Numeric>
+    struct DeltaSignal : public SignalAssembler<DeltaSignal<Numeric>, Numeric> {
+        Numeric _base{0};
+        bool _seen{false};
+
+        DeltaSignal(const TranslatedSignal sig) : 
+            SignalAssembler<DeltaSignal<Numeric>, Numeric>(sig)
+        {}
+
+        Numeric update(Numeric val);
+        void reset();
+    };
+
+    // One message's signals that share an assembler type and mux value.
+    // Their fields are pulled out of the frame together by a
+    // SignalLayoutPack, folded in with direct update() calls and written
+    // back in one pass, so a frame costs one dispatch per group rather
+    // than a variant visit and two bitwise codec walks per signal.
+    template <typename Assembler>
+    class FusedSignalAssembly {
+        using Numeric = typename Assembler::value_type;
+
+        std::optional<int64_t> _mux_val;
+        std::vector<Assembler> _asms;
+        SignalLayoutPack _pack;
+        std::vector<uint64_t> _raw;
+
+    public:
+        explicit FusedSignalAssembly(std::optional<int64_t> mux_val) :
+            _mux_val(mux_val)
+        {}
+
+        std::optional<int64_t> mux_val() const { return _mux_val; }
+        size_t size() const { return _asms.size(); }
+
+        // false for signals a pack can't hold, which assemble on their own
+        bool add(const Assembler& assembler) {
+            if (!_pack.add(assembler._sig.layout()))
+                return false;
+            _asms.push_back(assembler);
+            _raw.resize(_asms.size());
+            return true;
+        }
+
+        void assemble(int64_t mux_val, const uint8_t* data, uint8_t* payload) {
+            if (_mux_val && *_mux_val != mux_val)
+                return;
+
+            _pack.decode(data, _raw.data());
+            for (size_t i = 0; i < _asms.size(); ++i)
+                _raw[i] = value_to_raw(_asms[i].update(raw_to_value<Numeric>(_raw[i])));
+            _pack.encode(_raw.data(), payload);
+        }
+
+        void reset() {
+            for (auto& assembler : _asms)
+                assembler.reset();
+        }
+    };
+
     // Extern template declarations to prevent implicit instantiation
     extern template struct LastSignal<uint64_t>;
     extern template struct LastSignal<int64_t>;
@@ -74,4 +234,34 @@ namespace Candy {
     extern template struct AverageSignal<double>;
     extern template struct AverageSignal<float>;
 
+    extern template struct MinSignal<uint64_t>;
+    extern template struct MinSignal<int64_t>;
+    extern template struct MinSignal<double>;
+    extern template struct MinSignal<float>;
+
+    extern template struct MaxSignal<uint64_t>;
+    extern template struct MaxSignal<int64_t>;
+    extern template struct MaxSignal<double>;
+    extern template struct MaxSignal<float>;
+
+    extern template struct RmsSignal<uint64_t>;
+    extern template struct RmsSignal<int64_t>;
+    extern template struct RmsSignal<double>;
+    extern template struct RmsSignal<float>;
+
+    extern template struct CountSignal<uint64_t>;
+    extern template struct CountSignal<int64_t>;
+    extern template struct CountSignal<double>;
+    extern template struct CountSignal<float>;
+
+    extern template struct FirstSignal<uint64_t>;
+    extern template struct FirstSignal<int64_t>;
+    extern template struct FirstSignal<double>;
+    extern template struct FirstSignal<float>;
+
+    extern template struct DeltaSignal<uint64_t>;
+    extern template struct DeltaSignal<int64_t>;
+    extern template struct DeltaSignal<double>;
+    extern template struct DeltaSignal<float>;
+
 }
\ No newline at end of file
@@ -22,36 +22,75 @@ namespace Candy {
         AverageSignal<uint64_t>,
         AverageSignal<int64_t>,
         AverageSignal<double>,
-        AverageSignal<float>
+        AverageSignal<float>,
+        MinSignal<uint64_t>,
+        MinSignal<int64_t>,
+        MinSignal<double>,
+        MinSignal<float>,
+        MaxSignal<uint64_t>,
+        MaxSignal<int64_t>,
+        MaxSignal<double>,
+        MaxSignal<float>,
+        RmsSignal<uint64_t>,
+        RmsSignal<int64_t>,
+        RmsSignal<double>,
+        RmsSignal<float>,
+        CountSignal<uint64_t>,
+        CountSignal<int64_t>,
+        CountSignal<double>,
+        CountSignal<float>,
+        FirstSignal<uint64_t>,
+        FirstSignal<int64_t>,
+        FirstSignal<double>,
+        FirstSignal<float>,
+        DeltaSignal<uint64_t>,
+        DeltaSignal<int64_t>,
+        DeltaSignal<double>,
+        DeltaSignal<float>
     >;
 
+    template <typename Variant>
+    struct fused_assembly_variant;
+
+    template <typename... Assemblers>
+    struct fused_assembly_variant<std::variant<Assemblers...>> {
+        using type = std::variant<FusedSignalAssembly<Assemblers>...>;
+    };
+
+    using FusedAssemblyVariant = fused_assembly_variant<SignalAssemblerVariant>::type;
+
     static SignalAssemblerVariant make_sig_agg(const TranslatedSignal& sig);
 
     class TranslatedMessage {
         std::vector<TranslatedSignal> _signals;
         std::optional<TranslatedMultiplexer> _mux;
 
+        // signals a SignalLayoutPack can't hold; the rest assemble in _fused_asms
         std::vector<SignalAssemblerVariant> _sig_asms;
+        std::vector<FusedAssemblyVariant> _fused_asms;
         TransmissionGroup* transmission_group = nullptr;
         CANTime _last_stamp;
 
     public:
         void assign_group(TransmissionGroup* txg, uint32_t message_id);
         void assemble(std::pair<CANTime, CANFrame> sample);
+        void assemble(const std::pair<CANTime, CANFlexibleFrame>& sample);
 
         void sig_agg_type(const std::string& sig_name, const std::string& agg_type);
         void sig_val_type(const std::string& sig_name, unsigned sig_ext_val_type);
         void add_signal(TranslatedSignal sig);
         void add_muxer(TranslatedMultiplexer mux);
 
-        auto signals(uint64_t fd) const {
-            uint64_t frame_mux = _mux.has_value() ? _mux->decode(fd) : -1;
+        // data is a CANFD_MAX_DLEN byte payload
+        auto signals(const uint8_t* data) const {
+            uint64_t frame_mux = _mux.has_value() ? _mux->decode(data) : -1;
             return _signals | std::ranges::views::filter([frame_mux](const auto& sig) {
                 return sig.is_active(frame_mux);
             });
         }
     private:
         void make_sig_assemblers();
+        void fuse_sig_assemblers();
         void reset_sig_asms();
         TranslatedSignal* find_signal(const std::string& sig_name);
         std::vector<uint64_t> distinct_mux_vals() const;
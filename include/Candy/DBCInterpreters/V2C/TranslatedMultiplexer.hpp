@@ -11,14 +11,12 @@ namespace Candy {
     public:
         TranslatedMultiplexer(SignalCodec codec) : _codec(codec) {}
 
-        uint64_t decode(uint64_t data) const {
-            return _codec((uint8_t*)&data);
+        uint64_t decode(const uint8_t* data) const {
+            return _codec(data);
         }
         
-        uint64_t encode(uint64_t raw) const {
-            uint64_t rv = 0;
-            _codec(raw, (void*)&rv);
-            return rv;
+        void encode(uint64_t raw, uint8_t* payload) const {
+            _codec(raw, payload);
         }
     };
 
@@ -2,7 +2,9 @@
 
 #include <string>
 #include <optional>
+#include <cmath>
 #include <cstdint>
+#include <type_traits>
 
 #include "Candy/Core/Signal/NumericValue.hpp"
 #include "Candy/Core/Signal/SignalCodec.hpp"
@@ -16,9 +18,11 @@ namespace Candy {
         std::string _agg_type = "LAST";
         NumericValueType _val_type = Candy::NumericValueType::i64;
         std::optional<int64_t> _mux_val; 
+        double _factor = 1;
+        double _offset = 0;
     public:
-        TranslatedSignal(std::string name, SignalCodec codec, std::optional<int64_t> mux_val)
-            : _name(std::move(name)), _codec(codec), _mux_val(mux_val)
+        TranslatedSignal(std::string name, SignalCodec codec, std::optional<int64_t> mux_val, double factor = 1, double offset = 0)
+            : _name(std::move(name)), _codec(codec), _mux_val(mux_val), _factor(factor), _offset(offset)
         {}
 
         const std::string& name() const { return _name; }
@@ -28,6 +32,29 @@ namespace Candy {
             return !_mux_val || _mux_val == frame_mux_val;
         }
         
+        double factor() const { return _factor; }
+        double offset() const { return _offset; }
+
+        double to_physical(double raw) const {
+            return raw * _factor + _offset;
+        }
+
+        // the raw value nearest a physical value, integers rounded and saturated to the signal's width
+        template <typename Numeric>
+        Numeric from_physical(double value) const {
+            double raw = (value - _offset) / _factor;
+            if constexpr (std::is_integral_v<Numeric>) {
+                const SignalLayout& sig_layout = layout();
+                const uint64_t hi = sig_layout.sign_bit ? sig_layout.sign_bit - 1 : sig_layout.mask;
+                const auto lo = static_cast<int64_t>(sig_layout.sign_bit ? 0 - sig_layout.sign_bit : 0);
+
+                raw = std::round(raw);
+                if (!(raw > static_cast<double>(lo))) return static_cast<Numeric>(lo);
+                if (raw >= static_cast<double>(hi)) return static_cast<Numeric>(hi);
+            }
+            return static_cast<Numeric>(raw);
+        }
+
         std::string_view agg_type() const { return _agg_type; }
         void agg_type(const std::string& agg_type) { _agg_type = agg_type; }
         NumericValueType value_type() const { return _val_type; }
@@ -38,14 +65,16 @@ namespace Candy {
                 _val_type = Candy::NumericValueType::u64;
         }
 
-        uint64_t decode(uint64_t data) const {
-            return _codec((uint8_t*)&data);
+        // data is a CANFD_MAX_DLEN byte payload, so signals may sit anywhere in it
+        uint64_t decode(const uint8_t* data) const {
+            return _codec(data);
         }
 
-        uint64_t encode(uint64_t raw) const {
-            uint64_t rv = 0;
-            _codec(raw, (void*)&rv);
-            return rv;
+        const SignalLayout& layout() const { return _codec.layout(); }
+
+        // writes raw's bits into the signal's position in payload
+        void encode(uint64_t raw, uint8_t* payload) const {
+            _codec(raw, payload);
         }
     };
 
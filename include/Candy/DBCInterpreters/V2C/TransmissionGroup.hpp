@@ -1,12 +1,15 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <chrono>
 
 #include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/Frame/CANIdIndex.hpp"
 #include "Candy/Core/Frame/FramePacket.hpp"
+#include "Candy/Core/Frame/FramePacketEncoder.hpp"
 
 namespace Candy {
 
@@ -15,14 +18,27 @@ namespace Candy {
             CANTime stamp;
             canid_t message_id;
             int64_t message_mux;
-            uint64_t mdata;
+            std::array<uint8_t, CANFD_MAX_DLEN> mdata;
+            uint8_t len;
         };
 
         std::string _name;
         std::chrono::milliseconds _assemble_freq;
         CANTime _group_origin;
 
+        // the slots of one message_id, ordered by mux
+        struct clump_run {
+            uint32_t first;
+            uint32_t count;
+            int64_t first_mux;
+            // mux values first_mux .. first_mux + count - 1, so they index the run directly
+            bool dense;
+        };
+
+        // sorted by (message_id, mux) once assignment is done, so publish never sorts
         std::vector<stamped_msg> _msg_clumps;
+        std::vector<clump_run> _runs;
+        CANIdIndex _run_index;
 
     public:
         TransmissionGroup(std::string_view name, uint32_t assemble_freq) :
@@ -30,16 +46,21 @@ namespace Candy {
         {}
 
         std::string_view name() const { return _name; }
-        void time_begin(CANTime tp) { _group_origin = tp; }
-        void try_publish(CANTime up_to, FramePacket& fp);
-        void add_clumped(CANTime stamp, canid_t message_id, int64_t message_mux, uint64_t cval);
+        // also fixes the slot order, so assign() must be done by then
+        void time_begin(CANTime tp);
+        void try_publish(CANTime up_to, FramePacketEncoder& encoder, FramePacket& fp);
+        // len above CAN_MAX_DLEN publishes the message as a CAN FD frame
+        void add_clumped(CANTime stamp, canid_t message_id, int64_t message_mux,
+                         const std::array<uint8_t, CANFD_MAX_DLEN>& cval, uint8_t len);
         bool within_interval(CANTime stamp) const;
         void assign(canid_t message_id, int64_t message_mux);
 
 
     private:
-        void publish(CANTime tp, FramePacket& fp);
+        void publish(CANTime tp, FramePacketEncoder& encoder, FramePacket& fp);
         bool all_collected() const;
+        void index_slots();
+        uint32_t find_slot(canid_t message_id, int64_t message_mux) const;
     };
 
 }
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include <string_view>
 
 #include "Candy/Core/CANKernelTypes.hpp"
+#include "Candy/Core/Frame/CANIdIndex.hpp"
+#include "Candy/Core/Frame/FramePacketEncoder.hpp"
+#include "Candy/Core/Frame/FramePacketPool.hpp"
 
 #include "Candy/DBCInterpreters/V2C/TransmissionGroup.hpp"
 #include "Candy/DBCInterpreters/V2C/TranslatedMessage.hpp"
@@ -22,13 +25,37 @@ namespace Candy {
         std::chrono::milliseconds update_frequency{0};
 
         std::unordered_map<canid_t, TranslatedMessage> _msgs;
+        // per-frame lookup into _msgs, built by parse_dbc
+        CANIdIndex _dispatch;
+        std::vector<TranslatedMessage*> _dispatch_msgs;
         std::vector<std::unique_ptr<TransmissionGroup>> transmission_groups;
 
         FramePacket frame_packet;
+        FramePacketEncoder _encoder;
+        // buffers for the next frame_packet; consumers hand them back through recycle
+        FramePacketPool _packet_pool;
         CANTime _last_update_tp;
 
     public:
+        // parses the DBC, then builds the can_id dispatch used by transcode
+        bool parse_dbc(std::string_view dbc_src);
+
         FramePacket transcode(std::pair<CANTime, CANFrame> sample);
+        FramePacket transcode(const std::pair<CANTime, CANFlexibleFrame>& sample);
+
+        // Returns a published packet's buffer once the consumer is done with
+        // it. With every packet recycled, steady-state transcoding does not
+        // allocate.
+        // v2 packets are delta encoded and roughly half the size; FrameIterator reads both
+        void set_packet_format(FramePacketFormat format, bool xor_payloads = true) {
+            _encoder = FramePacketEncoder(format, xor_payloads);
+        }
+
+        void recycle(FramePacket&& packet) { _packet_pool.recycle(std::move(packet)); }
+        FramePacketPool& packet_pool() { return _packet_pool; }
+
+        // ids of the parsed messages, e.g. for SocketCANSource filters
+        std::vector<canid_t> message_ids() const;
 
         void assign_tx_group(const std::string& object_type, unsigned message_id, const std::string& tx_group);
         void add_signal(canid_t message_id, TranslatedSignal sig);
@@ -61,7 +88,7 @@ namespace Candy {
             const std::vector<size_t>& rec_ords
         ) {
             SignalCodec codec{sg_start_bit, sg_size, sg_byte_order, sg_sign};
-            TranslatedSignal sig{sg_name, codec, std::optional<int64_t>(sg_mux_switch_val)};
+            TranslatedSignal sig{sg_name, codec, std::optional<int64_t>(sg_mux_switch_val), sg_factor, sg_offset};
             add_signal(message_id, std::move(sig));
         }
 
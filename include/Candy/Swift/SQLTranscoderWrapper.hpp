@@ -53,7 +53,7 @@ namespace Candy {
 
         // Transcoder methods
         void batchFrame(std::pair<CANTime, CANFrame> sample);
-        void batchDecodedSignals(std::pair<CANTime, CANFrame> sample, const MessageDefinition& msg_def);
+        void batchDecodedSignals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg);
         void flushFramesBatch();
         void flushDecodedSignalsBatch();
         void flushAllBatches();
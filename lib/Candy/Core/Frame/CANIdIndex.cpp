@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <bit>
+
+#include "Candy/Core/Frame/CANIdIndex.hpp"
+
+namespace Candy {
+
+    void CANIdIndex::build(std::span<const std::pair<canid_t, uint32_t>> entries) {
+        clear();
+
+        std::vector<std::pair<canid_t, uint32_t>> hashed;
+        _standard.assign(size_t{1} << CAN_SFF_ID_BITS, npos);
+
+        for (const auto& [can_id, value] : entries) {
+            if (can_id < _standard.size())
+                _standard[can_id] = value;
+            else
+                hashed.emplace_back(can_id, value);
+        }
+
+        // later entries win, same as repeated map assignment
+        std::reverse(hashed.begin(), hashed.end());
+        std::stable_sort(hashed.begin(), hashed.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        hashed.erase(std::unique(hashed.begin(), hashed.end(), [](const auto& a, const auto& b) { return a.first == b.first; }), hashed.end());
+
+        _size = std::count_if(_standard.begin(), _standard.end(), [](uint32_t v) { return v != npos; }) + hashed.size();
+
+        if (hashed.empty())
+            return;
+
+        // load factor <= 0.5; doubling is a fallback that small DBCs never reach
+        size_t slot_count = std::bit_ceil(hashed.size() * 2);
+        while (!build_hashed(hashed, slot_count))
+            slot_count *= 2;
+    }
+
+    bool CANIdIndex::build_hashed(std::span<const std::pair<canid_t, uint32_t>> entries, size_t slot_count) {
+        constexpr uint32_t max_seed = 1u << 16;
+
+        const size_t bucket_count = std::bit_ceil(std::max<size_t>(1, entries.size() / 2));
+        _bucket_mask = static_cast<uint32_t>(bucket_count - 1);
+        _slot_mask = static_cast<uint32_t>(slot_count - 1);
+
+        std::vector<std::vector<size_t>> buckets(bucket_count);
+        for (size_t i = 0; i < entries.size(); ++i)
+            buckets[hash(entries[i].first, 0) & _bucket_mask].push_back(i);
+
+        // place the most crowded buckets first while the table is empty
+        std::vector<size_t> order(bucket_count);
+        for (size_t b = 0; b < bucket_count; ++b) order[b] = b;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+        _seeds.assign(bucket_count, 0);
+        _keys.assign(slot_count, 0);
+        _values.assign(slot_count, npos);
+        std::vector<bool> taken(slot_count, false);
+        std::vector<uint32_t> slots;
+
+        for (size_t b : order) {
+            const auto& bucket = buckets[b];
+            if (bucket.empty()) break;
+
+            uint32_t seed = 1;
+            for (; seed < max_seed; ++seed) {
+                slots.clear();
+                bool fits = true;
+                for (size_t i : bucket) {
+                    uint32_t slot = hash(entries[i].first, seed) & _slot_mask;
+                    if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                        fits = false;
+                        break;
+                    }
+                    slots.push_back(slot);
+                }
+                if (fits) break;
+            }
+            if (seed == max_seed)
+                return false;
+
+            _seeds[b] = seed;
+            for (size_t k = 0; k < bucket.size(); ++k) {
+                taken[slots[k]] = true;
+                _keys[slots[k]] = entries[bucket[k]].first;
+                _values[slots[k]] = entries[bucket[k]].second;
+            }
+        }
+
+        return true;
+    }
+
+    void CANIdIndex::clear() {
+        _standard.clear();
+        _seeds.clear();
+        _keys.clear();
+        _values.clear();
+        _bucket_mask = 0;
+        _slot_mask = 0;
+        _size = 0;
+    }
+
+}
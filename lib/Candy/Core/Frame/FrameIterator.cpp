@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
 #include <cstring>
 
 #include "Candy/Core/CANKernelTypes.hpp"
@@ -8,7 +11,14 @@ namespace Candy {
         : frame_packet(fp), 
         payload_data(fp.payload()), 
         current_offset(0) {
+        if (fp.is_empty())
+            return;
+
         packet_utc = fp.utc();
+        if (fp.format() == FramePacketFormat::v2) {
+            delta_encoded = true;
+            decode_delta_record();
+        }
     }
 
     FrameIterator::~FrameIterator() {}
@@ -20,23 +30,62 @@ namespace Candy {
         return current_offset >= payload_data.size();
     }
 
-    std::pair<CANTime, CANFrame> FrameIterator::operator*() {
+    std::pair<CANTime, CANFlexibleFrame> FrameIterator::operator*() {
         using namespace std::chrono;
 
+        if (delta_encoded)
+            return { CANTime(seconds(packet_utc)) + milliseconds(delta_millis), delta_frame };
+
         int32_t millis = transmit_at_offset<int32_t>(current_offset);
-        CANFrame frame = transmit_at_offset<CANFrame>(current_offset + 4);
 
-        return { CANTime(seconds(packet_utc)) + milliseconds(millis), std::move(frame) };
+        CANFlexibleFrame frame {};
+        size_t frame_size = record_size() - 4;
+        if (current_offset + 4 + frame_size <= payload_data.size())
+            std::memcpy(&frame, payload_data.data() + current_offset + 4, frame_size);
+        else
+            printf("Read beyond payload bounds\n");
+
+        return { CANTime(seconds(packet_utc)) + milliseconds(millis), frame };
     }
 
     FrameIterator& FrameIterator::operator++() {
         if (frame_packet.is_empty())
             return *this;
 
-        current_offset += 4 + sizeof(CANFrame);
+        if (delta_encoded) {
+            current_offset += delta_record_size;
+            decode_delta_record();
+            return *this;
+        }
+
+        current_offset += record_size();
         return *this;
     }
 
+    void FrameIterator::decode_delta_record() {
+        if (current_offset >= payload_data.size())
+            return;
+
+        delta_record_size = decode_frame_record(payload_data.subspan(current_offset), delta_history, delta_millis, delta_frame);
+        if (delta_record_size == 0) {
+            std::fprintf(stderr, "Malformed frame record at offset %zu\n", current_offset);
+            current_offset = payload_data.size();
+        }
+    }
+
+    size_t FrameIterator::record_size() const {
+        constexpr size_t flags_at = 4 + offsetof(CANFlexibleFrame, flags);
+        constexpr size_t length_at = 4 + offsetof(CANFlexibleFrame, length);
+
+        if (current_offset + 4 + frame_header_size > payload_data.size())
+            return 4 + sizeof(CANFrame);
+
+        if (!(payload_data[current_offset + flags_at] & CANFD_FDF))
+            return 4 + sizeof(CANFrame);
+
+        return 4 + frame_header_size + std::min<size_t>(payload_data[current_offset + length_at], CANFD_MAX_DLEN);
+    }
+
     template<typename IntType>
     IntType FrameIterator::transmit_at_offset(size_t offset) const {
         if (offset + sizeof(IntType) > payload_data.size()) {
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstring>
 
 #include "Candy/Core/Frame/FramePacket.hpp"
@@ -8,12 +9,11 @@ namespace Candy {
 
     FramePacket::FramePacket(base buff) : _buff(std::move(buff)) {}
 
-    void FramePacket::prepare(uint32_t utc) {
+    void FramePacket::prepare(uint32_t utc, FramePacketFormat format) {
         _buff.resize(0);
-        _buff.reserve(32 * 1024);
+        _buff.reserve(packet_reserve_bytes);
 
-        constexpr uint16_t dbc_version = 100;
-        append(dbc_version);
+        append(static_cast<int16_t>(format));
         append(utc);
     }
 
@@ -21,6 +21,12 @@ namespace Candy {
         return *reinterpret_cast<const uint32_t*>(_buff.data() + 2);
     }
 
+    FramePacketFormat FramePacket::format() const {
+        if (_buff.size() < 2)
+            return FramePacketFormat::v1;
+        return static_cast<FramePacketFormat>(transmit_at<int16_t>(0));
+    }
+
     bool FramePacket::is_empty() const {
         return _buff.size() <= 6;
     }
@@ -53,6 +59,16 @@ namespace Candy {
 		_buff.insert(_buff.end(), b, b + sizeof(CANFrame));
 	}
 
+    void FramePacket::append(const CANFlexibleFrame& frame) {
+        const uint8_t* b = reinterpret_cast<const uint8_t*>(&frame);
+        size_t len = std::min<size_t>(frame.length, CANFD_MAX_DLEN);
+        _buff.insert(_buff.end(), b, b + frame_header_size + len);
+    }
+
+    void FramePacket::append(std::span<const uint8_t> bytes) {
+        _buff.insert(_buff.end(), bytes.begin(), bytes.end());
+    }
+
     template <typename IntType>
     void FramePacket::append(IntType val) {
         const uint8_t* b = reinterpret_cast<const uint8_t*>(&val);
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cstring>
+
+#include "Candy/Core/CANHelpers.hpp"
+#include "Candy/Core/Frame/FramePacketEncoder.hpp"
+
+namespace Candy {
+
+    namespace {
+
+        constexpr uint8_t fd_flags = CANFD_BRS | CANFD_ESI | CANFD_FDF;
+
+        uint64_t zigzag(int64_t v) {
+            return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+        }
+
+        int64_t unzigzag(uint64_t v) {
+            return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+        }
+
+        size_t put_varint(uint8_t* out, uint64_t v) {
+            size_t n = 0;
+            while (v >= 0x80) {
+                out[n++] = static_cast<uint8_t>(v) | 0x80;
+                v >>= 7;
+            }
+            out[n++] = static_cast<uint8_t>(v);
+            return n;
+        }
+
+        bool get_varint(std::span<const uint8_t> bytes, size_t& at, uint64_t& v) {
+            v = 0;
+            for (unsigned shift = 0; shift < 64 && at < bytes.size(); shift += 7) {
+                uint8_t b = bytes[at++];
+                v |= static_cast<uint64_t>(b & 0x7f) << shift;
+                if (!(b & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+    }
+
+    void FrameRecordHistory::clear() {
+        millis = 0;
+        can_id = 0;
+        _last.clear();
+    }
+
+    const uint8_t* FrameRecordHistory::find(canid_t id) const {
+        for (const auto& last : _last)
+            if (last.can_id == id)
+                return last.data.data();
+        return nullptr;
+    }
+
+    void FrameRecordHistory::remember(canid_t id, const uint8_t* data, size_t len) {
+        auto it = std::find_if(_last.begin(), _last.end(), [&](const Last& last) { return last.can_id == id; });
+        if (it == _last.end())
+            it = _last.insert(_last.end(), { id, {} });
+
+        std::memcpy(it->data.data(), data, len);
+        std::memset(it->data.data() + len, 0, CANFD_MAX_DLEN - len);
+    }
+
+    FramePacketEncoder::FramePacketEncoder(FramePacketFormat format, bool xor_payloads) :
+        _format(format), _xor_payloads(xor_payloads)
+    {}
+
+    void FramePacketEncoder::begin(FramePacket& fp, uint32_t utc) {
+        fp.prepare(utc, _format);
+        _history.clear();
+    }
+
+    void FramePacketEncoder::append(FramePacket& fp, int32_t millis, const CANFlexibleFrame& frame) {
+        if (_format == FramePacketFormat::v1) {
+            fp.append(millis);
+            if (frame.flags & CANFD_FDF)
+                fp.append(frame);
+            else
+                fp.append(narrow_frame(frame));
+            return;
+        }
+
+        std::array<uint8_t, max_frame_record_size> record;
+        size_t n = put_varint(record.data(), zigzag(static_cast<int64_t>(millis) - _history.millis));
+        n += put_varint(record.data() + n, zigzag(static_cast<int64_t>(frame.can_id) - _history.can_id));
+        _history.millis = millis;
+        _history.can_id = frame.can_id;
+
+        size_t len = std::min<size_t>(frame.length, (frame.flags & CANFD_FDF) ? CANFD_MAX_DLEN : CAN_MAX_DLEN);
+        uint8_t flags = frame.flags & fd_flags;
+        if (use_non_muxed(frame))
+            flags |= frame_record_non_muxed;
+
+        // sparse against zero or against the last payload, whichever drops more bytes
+        const uint8_t* prev = _xor_payloads ? _history.find(frame.can_id) : nullptr;
+        size_t nonzero = 0;
+        size_t changed = len + 1;
+        for (size_t i = 0; i < len; ++i)
+            nonzero += frame.data[i] != 0;
+        if (prev) {
+            changed = 0;
+            for (size_t i = 0; i < len; ++i)
+                changed += frame.data[i] != prev[i];
+        }
+
+        bool use_xor = changed < nonzero;
+        size_t mask_bytes = (len + 7) / 8;
+
+        if (mask_bytes + std::min(nonzero, changed) < len) {
+            record[n++] = flags | frame_record_sparse | (use_xor ? frame_record_xor : 0);
+            record[n++] = static_cast<uint8_t>(len);
+
+            uint8_t* mask = record.data() + n;
+            std::memset(mask, 0, mask_bytes);
+            n += mask_bytes;
+            for (size_t i = 0; i < len; ++i) {
+                uint8_t b = use_xor ? frame.data[i] ^ prev[i] : frame.data[i];
+                if (b) {
+                    mask[i / 8] |= 1 << (i % 8);
+                    record[n++] = b;
+                }
+            }
+        }
+        else {
+            record[n++] = flags;
+            record[n++] = static_cast<uint8_t>(len);
+            std::memcpy(record.data() + n, frame.data, len);
+            n += len;
+        }
+
+        _history.remember(frame.can_id, frame.data, len);
+        fp.append(std::span<const uint8_t>(record.data(), n));
+    }
+
+    size_t decode_frame_record(std::span<const uint8_t> bytes, FrameRecordHistory& history,
+                               int32_t& millis, CANFlexibleFrame& frame)
+    {
+        size_t at = 0;
+        uint64_t millis_delta, id_delta;
+        if (!get_varint(bytes, at, millis_delta) || !get_varint(bytes, at, id_delta) || at + 2 > bytes.size())
+            return 0;
+
+        uint8_t flags = bytes[at++];
+        size_t len = bytes[at++];
+        if (len > ((flags & CANFD_FDF) ? CANFD_MAX_DLEN : CAN_MAX_DLEN))
+            return 0;
+
+        frame = {};
+        frame.can_id = static_cast<canid_t>(history.can_id + unzigzag(id_delta));
+        frame.length = static_cast<uint8_t>(len);
+        frame.flags = flags & fd_flags;
+        use_non_muxed(frame, flags & frame_record_non_muxed);
+        millis = static_cast<int32_t>(history.millis + unzigzag(millis_delta));
+
+        if (flags & frame_record_sparse) {
+            size_t mask_bytes = (len + 7) / 8;
+            if (at + mask_bytes > bytes.size())
+                return 0;
+
+            const uint8_t* mask = bytes.data() + at;
+            at += mask_bytes;
+            for (size_t i = 0; i < len; ++i) {
+                if (!((mask[i / 8] >> (i % 8)) & 1))
+                    continue;
+                if (at >= bytes.size())
+                    return 0;
+                frame.data[i] = bytes[at++];
+            }
+
+            if (flags & frame_record_xor) {
+                const uint8_t* prev = history.find(frame.can_id);
+                if (!prev)
+                    return 0;
+                for (size_t i = 0; i < len; ++i)
+                    frame.data[i] ^= prev[i];
+            }
+        }
+        else {
+            if (at + len > bytes.size())
+                return 0;
+            std::memcpy(frame.data, bytes.data() + at, len);
+            at += len;
+        }
+
+        history.millis = millis;
+        history.can_id = frame.can_id;
+        history.remember(frame.can_id, frame.data, len);
+        return at;
+    }
+
+}
@@ -0,0 +1,54 @@
+#include "Candy/Core/Frame/FramePacketPool.hpp"
+
+namespace Candy {
+
+    FramePacketPool::FramePacketPool(size_t capacity, size_t buffer_bytes) :
+        _capacity(capacity), _buffer_bytes(buffer_bytes)
+    {
+        // recycle() must not allocate either
+        _free.reserve(capacity);
+    }
+
+    FramePacket FramePacketPool::acquire() {
+        ++_stats.acquired;
+
+        if (!_free.empty()) {
+            ++_stats.reused;
+            std::vector<uint8_t> buff = std::move(_free.back());
+            _free.pop_back();
+            return FramePacket(std::move(buff));
+        }
+
+        ++_stats.allocated;
+        std::vector<uint8_t> buff;
+        buff.reserve(_buffer_bytes);
+        return FramePacket(std::move(buff));
+    }
+
+    void FramePacketPool::recycle(FramePacket&& packet) {
+        recycle(packet.release());
+    }
+
+    void FramePacketPool::recycle(std::vector<uint8_t> buff) {
+        // moved-from and never-prepared packets have nothing worth keeping
+        if (buff.capacity() < _buffer_bytes)
+            return;
+
+        ++_stats.recycled;
+        if (_free.size() >= _capacity) {
+            ++_stats.dropped;
+            return;
+        }
+
+        buff.clear();
+        _free.push_back(std::move(buff));
+    }
+
+    void FramePacketPool::set_capacity(size_t capacity) {
+        _capacity = capacity;
+        if (_free.size() > capacity)
+            _free.resize(capacity);
+        _free.reserve(capacity);
+    }
+
+}
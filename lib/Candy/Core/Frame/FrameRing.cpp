@@ -0,0 +1,34 @@
+#include <algorithm>
+#include <bit>
+
+#include "Candy/Core/Frame/FrameRing.hpp"
+
+namespace Candy {
+
+    template <typename Frame>
+    FrameRing<Frame>::FrameRing(size_t capacity) :
+        _capacity(std::bit_ceil(std::max<size_t>(capacity, 2))),
+        _mask(_capacity - 1),
+        _slots(std::make_unique<sample_type[]>(_capacity))
+    {}
+
+    template <typename Frame>
+    size_t FrameRing<Frame>::try_push(std::span<const sample_type> samples) {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        if (_capacity - (tail - _producer_head) < samples.size())
+            _producer_head = _head.load(std::memory_order_acquire);
+
+        const size_t count = std::min(samples.size(), _capacity - (tail - _producer_head));
+        for (size_t i = 0; i < count; ++i)
+            _slots[(tail + i) & _mask] = samples[i];
+        _tail.store(tail + count, std::memory_order_release);
+
+        if (count < samples.size())
+            _overflowed.store(_overflowed.load(std::memory_order_relaxed) + (samples.size() - count), std::memory_order_relaxed);
+        return count;
+    }
+
+    template class FrameRing<CANFrame>;
+    template class FrameRing<CANFlexibleFrame>;
+
+}
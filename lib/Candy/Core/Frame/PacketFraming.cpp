@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+#if defined(CANDY_HAS_LZ4)
+#include <lz4.h>
+#endif
+
+#include "Candy/Core/Frame/PacketFraming.hpp"
+
+namespace {
+
+    constexpr uint8_t magic[2] = { 'C', 'Y' };
+
+    // CRC-32C (Castagnoli), reflected
+    constexpr std::array<uint32_t, 256> crc32c_table = [] {
+        std::array<uint32_t, 256> table {};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (crc & 1 ? 0x82F63B78u : 0u);
+            table[i] = crc;
+        }
+        return table;
+    }();
+
+    template <typename T>
+    void put(uint8_t* at, T value) {
+        std::memcpy(at, &value, sizeof(T));
+    }
+
+    template <typename T>
+    T get(const uint8_t* at) {
+        T value;
+        std::memcpy(&value, at, sizeof(T));
+        return value;
+    }
+
+    uint32_t header_crc(const uint8_t* header, std::span<const uint8_t> body) {
+        return Candy::crc32c(body, Candy::crc32c({ header, 16 }));
+    }
+
+    bool decompress(Candy::PacketCompression compression, std::span<const uint8_t> body, uint8_t* out, size_t size) {
+        switch (compression) {
+            case Candy::PacketCompression::none:
+                if (body.size() != size) return false;
+                std::memcpy(out, body.data(), size);
+                return true;
+#if defined(CANDY_HAS_LZ4)
+            case Candy::PacketCompression::lz4:
+                return LZ4_decompress_safe(reinterpret_cast<const char*>(body.data()), reinterpret_cast<char*>(out),
+                                           static_cast<int>(body.size()), static_cast<int>(size)) == static_cast<int>(size);
+#endif
+#if defined(CANDY_HAS_ZSTD)
+            case Candy::PacketCompression::zstd: {
+                size_t n = ZSTD_decompress(out, size, body.data(), body.size());
+                return !ZSTD_isError(n) && n == size;
+            }
+#endif
+            default:
+                return false;
+        }
+    }
+
+    bool valid_header(const uint8_t* header, size_t max_size) {
+        return header[0] == magic[0] && header[1] == magic[1] && header[2] == Candy::packet_version &&
+               header[3] <= static_cast<uint8_t>(Candy::PacketCompression::zstd) &&
+               get<uint32_t>(header + 8) <= max_size &&
+               get<uint32_t>(header + 12) <= max_size;
+    }
+
+    // the body must follow the header in memory
+    bool valid_crc(const uint8_t* header) {
+        std::span<const uint8_t> body(header + Candy::packet_header_size, get<uint32_t>(header + 8));
+        return get<uint32_t>(header + 16) == header_crc(header, body);
+    }
+
+    bool decode_body(const uint8_t* header, std::vector<uint8_t>& out) {
+        std::span<const uint8_t> body(header + Candy::packet_header_size, get<uint32_t>(header + 8));
+        return decompress(static_cast<Candy::PacketCompression>(header[3]), body, out.data(), out.size());
+    }
+
+}
+
+namespace Candy {
+
+    uint32_t crc32c(std::span<const uint8_t> bytes, uint32_t crc) {
+        crc = ~crc;
+        for (uint8_t byte : bytes)
+            crc = crc32c_table[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    bool compression_available(PacketCompression compression) {
+        switch (compression) {
+            case PacketCompression::none: return true;
+#if defined(CANDY_HAS_LZ4)
+            case PacketCompression::lz4: return true;
+#endif
+#if defined(CANDY_HAS_ZSTD)
+            case PacketCompression::zstd: return true;
+#endif
+            default: return false;
+        }
+    }
+
+    // framer
+
+    PacketFramer::PacketFramer(PacketCompression compression, int level) :
+        _compression(compression),
+        _level(level)
+    {
+        _frame.reserve(packet_header_size + 32 * 1024);
+    }
+
+    std::optional<PacketFramer> PacketFramer::create(PacketCompression compression, int level) {
+        if (!compression_available(compression)) {
+            std::fprintf(stderr, "Packet compression %u is not built in (CANDY_ENABLE_LZ4 / CANDY_ENABLE_ZSTD)\n",
+                         static_cast<unsigned>(compression));
+            return std::nullopt;
+        }
+
+        PacketFramer framer(compression, level);
+#if defined(CANDY_HAS_ZSTD)
+        if (compression == PacketCompression::zstd) {
+            framer._zstd.reset(ZSTD_createCCtx());
+            if (!framer._zstd) return std::nullopt;
+        }
+#endif
+        return std::make_optional<PacketFramer>(std::move(framer));
+    }
+
+    std::span<const uint8_t> PacketFramer::frame(const FramePacket& packet) {
+        return frame(packet.data());
+    }
+
+    std::span<const uint8_t> PacketFramer::frame(std::span<const uint8_t> packet_bytes) {
+        if (packet_bytes.size() > max_packet_size) {
+            std::fprintf(stderr, "Packet of %zu bytes exceeds the %zu byte limit\n", packet_bytes.size(), max_packet_size);
+            return {};
+        }
+
+        const size_t size = packet_bytes.size();
+        const char* src = reinterpret_cast<const char*>(packet_bytes.data());
+
+        size_t capacity = size;
+#if defined(CANDY_HAS_LZ4)
+        if (_compression == PacketCompression::lz4)
+            capacity = std::max<size_t>(capacity, LZ4_compressBound(static_cast<int>(size)));
+#endif
+#if defined(CANDY_HAS_ZSTD)
+        if (_compression == PacketCompression::zstd)
+            capacity = std::max(capacity, ZSTD_compressBound(size));
+#endif
+        _frame.resize(packet_header_size + capacity);
+        uint8_t* body = _frame.data() + packet_header_size;
+
+        // compressed straight into the frame; kept only if it came out smaller
+        size_t body_size = 0;
+        PacketCompression used = PacketCompression::none;
+        switch (_compression) {
+#if defined(CANDY_HAS_LZ4)
+            case PacketCompression::lz4: {
+                int n = LZ4_compress_fast(src, reinterpret_cast<char*>(body), static_cast<int>(size),
+                                          static_cast<int>(capacity), std::max(_level, 1));
+                if (n > 0) body_size = static_cast<size_t>(n);
+                used = PacketCompression::lz4;
+                break;
+            }
+#endif
+#if defined(CANDY_HAS_ZSTD)
+            case PacketCompression::zstd: {
+                size_t n = ZSTD_compressCCtx(_zstd.get(), body, capacity, src, size, _level);
+                if (!ZSTD_isError(n)) body_size = n;
+                used = PacketCompression::zstd;
+                break;
+            }
+#endif
+            default:
+                break;
+        }
+
+        if (body_size == 0 || body_size >= size) {
+            used = PacketCompression::none;
+            body_size = size;
+            if (size > 0) std::memcpy(body, src, size);
+        }
+        _frame.resize(packet_header_size + body_size);
+
+        uint8_t* header = _frame.data();
+        header[0] = magic[0];
+        header[1] = magic[1];
+        header[2] = packet_version;
+        header[3] = static_cast<uint8_t>(used);
+        put<uint32_t>(header + 4, _sequence++);
+        put<uint32_t>(header + 8, static_cast<uint32_t>(body_size));
+        put<uint32_t>(header + 12, static_cast<uint32_t>(size));
+        put<uint32_t>(header + 16, header_crc(header, { body, body_size }));
+
+        return _frame;
+    }
+
+    std::optional<FramePacket> unframe_packet(std::span<const uint8_t> frame, uint32_t& sequence) {
+        if (frame.size() < packet_header_size || !valid_header(frame.data(), max_packet_size) ||
+            frame.size() != packet_header_size + get<uint32_t>(frame.data() + 8) || !valid_crc(frame.data())) {
+            return std::nullopt;
+        }
+
+        std::vector<uint8_t> bytes(get<uint32_t>(frame.data() + 12));
+        if (!decode_body(frame.data(), bytes)) return std::nullopt;
+
+        sequence = get<uint32_t>(frame.data() + 4);
+        return FramePacket(std::move(bytes));
+    }
+
+    // deframer
+
+    PacketDeframer::PacketDeframer(size_t max_size) :
+        _max_size(std::min(max_size, max_packet_size))
+    {}
+
+    void PacketDeframer::feed(std::span<const uint8_t> bytes) {
+        compact();
+        _buff.insert(_buff.end(), bytes.begin(), bytes.end());
+    }
+
+    std::optional<FramePacket> PacketDeframer::next() {
+        while (_buff.size() - _read >= packet_header_size) {
+            const uint8_t* header = _buff.data() + _read;
+            if (!valid_header(header, _max_size)) {
+                skip(1);
+                continue;
+            }
+
+            const size_t body_size = get<uint32_t>(header + 8);
+            if (_buff.size() - _read < packet_header_size + body_size) break;
+
+            if (!valid_crc(header)) {
+                ++_stats.crc_errors;
+                skip(1);
+                continue;
+            }
+
+            const uint32_t sequence = get<uint32_t>(header + 4);
+            std::vector<uint8_t> bytes(get<uint32_t>(header + 12));
+            const bool decoded = decode_body(header, bytes);
+            _read += packet_header_size + body_size;
+
+            // sequence numbers wrap; anything not ahead of the last one is a repeat or reorder
+            if (_last_sequence) {
+                const uint32_t gap = sequence - *_last_sequence;
+                if (gap > 0 && gap < 0x80000000u) _stats.lost += gap - 1;
+            }
+            _last_sequence = sequence;
+
+            if (!decoded) {
+                ++_stats.decode_errors;
+                continue;
+            }
+
+            ++_stats.packets;
+            return FramePacket(std::move(bytes));
+        }
+
+        compact();
+        return std::nullopt;
+    }
+
+    // drops `bytes`, then everything up to the next possible header
+    void PacketDeframer::skip(size_t bytes) {
+        const size_t from = _read;
+        _read += bytes;
+        const void* at = std::memchr(_buff.data() + _read, magic[0], _buff.size() - _read);
+        _read = at ? static_cast<size_t>(static_cast<const uint8_t*>(at) - _buff.data()) : _buff.size();
+        _stats.skipped_bytes += _read - from;
+    }
+
+    void PacketDeframer::compact() {
+        if (_read == 0) return;
+        _buff.erase(_buff.begin(), _buff.begin() + static_cast<std::ptrdiff_t>(_read));
+        _read = 0;
+    }
+
+}
@@ -0,0 +1,381 @@
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Candy/Core/Link/UDPPacketLink.hpp"
+
+namespace {
+
+    // NACK datagram: 'C' 'N', version, count, then count u32 sequence numbers
+    constexpr uint8_t nack_magic[2] = { 'C', 'N' };
+    constexpr size_t nack_header_size = 4;
+    constexpr size_t max_nacks_per_datagram = 64;
+
+    // the largest UDP payload over IPv4
+    constexpr size_t max_datagram_size = 65507;
+
+    bool drop(double loss, std::minstd_rand& gen) {
+        return loss > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(gen) < loss;
+    }
+
+}
+
+namespace Candy {
+
+    // sender
+
+    UDPPacketSender::UDPPacketSender(int fd, UDPLinkOptions options, PacketFramer framer) :
+        _fd(fd),
+        _options(options),
+        _framer(std::move(framer)),
+        _history(std::max<size_t>(options.history, 1)),
+        _loss(options.simulated_loss_seed)
+    {
+    }
+
+    std::optional<UDPPacketSender> UDPPacketSender::create(std::string_view host, uint16_t port, UDPLinkOptions options,
+                                                           PacketCompression compression)
+    {
+        auto framer = PacketFramer::create(compression);
+        if (!framer) return std::nullopt;
+
+        addrinfo hints {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* found = nullptr;
+        std::string name(host);
+        if (getaddrinfo(name.c_str(), nullptr, &hints, &found) != 0 || !found) {
+            std::cerr << "Unknown host: " << name << std::endl;
+            return std::nullopt;
+        }
+        sockaddr_in addr = *reinterpret_cast<sockaddr_in*>(found->ai_addr);
+        addr.sin_port = htons(port);
+        freeaddrinfo(found);
+
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            std::cerr << "Failed to open UDP socket: " << std::strerror(errno) << std::endl;
+            return std::nullopt;
+        }
+
+        // NACKs come back on the same socket, from the connected peer only
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            std::cerr << "Failed to connect UDP socket to " << name << ": " << std::strerror(errno) << std::endl;
+            close(fd);
+            return std::nullopt;
+        }
+
+        return UDPPacketSender(fd, options, std::move(*framer));
+    }
+
+    UDPPacketSender::UDPPacketSender(UDPPacketSender&& other) noexcept :
+        _fd(other._fd),
+        _options(other._options),
+        _framer(std::move(other._framer)),
+        _stats(other._stats),
+        _history(std::move(other._history)),
+        _loss(other._loss)
+    {
+        other._fd = -1;
+    }
+
+    UDPPacketSender& UDPPacketSender::operator=(UDPPacketSender&& other) noexcept {
+        if (this != &other) {
+            if (_fd >= 0) close(_fd);
+            _fd = other._fd;
+            _options = other._options;
+            _framer = std::move(other._framer);
+            _stats = other._stats;
+            _history = std::move(other._history);
+            _loss = other._loss;
+            other._fd = -1;
+        }
+        return *this;
+    }
+
+    UDPPacketSender::~UDPPacketSender() {
+        if (_fd >= 0) close(_fd);
+    }
+
+    bool UDPPacketSender::send(const FramePacket& packet) {
+        if (_fd < 0) return false;
+
+        const uint32_t sequence = _framer.next_sequence();
+        auto datagram = _framer.frame(packet);
+        if (datagram.empty() || datagram.size() > max_datagram_size) {
+            std::cerr << "FramePacket of " << packet.byte_size() << " bytes does not fit a datagram" << std::endl;
+            return false;
+        }
+
+        Sent& sent = _history[sequence % _history.size()];
+        sent.sequence = sequence;
+        sent.at = std::chrono::steady_clock::now();
+        sent.datagram.assign(datagram.begin(), datagram.end());
+
+        ++_stats.packets;
+        return transmit(datagram);
+    }
+
+    size_t UDPPacketSender::poll() {
+        if (_fd < 0) return 0;
+
+        size_t resent = 0;
+        uint8_t nack[nack_header_size + max_nacks_per_datagram * sizeof(uint32_t)];
+        ssize_t size;
+        while ((size = recv(_fd, nack, sizeof(nack), MSG_DONTWAIT)) > 0) {
+            const size_t count = nack[3];
+            if (static_cast<size_t>(size) != nack_header_size + count * sizeof(uint32_t) ||
+                nack[0] != nack_magic[0] || nack[1] != nack_magic[1] || nack[2] != packet_version) {
+                ++_stats.corrupt;
+                continue;
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < count; ++i) {
+                uint32_t sequence;
+                std::memcpy(&sequence, nack + nack_header_size + i * sizeof(uint32_t), sizeof(sequence));
+                ++_stats.nacks;
+
+                // overwritten by a newer packet, or too old to be worth sending
+                const Sent& sent = _history[sequence % _history.size()];
+                if (sent.sequence != sequence || sent.datagram.empty() || now - sent.at > _options.deadline)
+                    continue;
+
+                transmit(sent.datagram);
+                ++_stats.retransmits;
+                ++resent;
+            }
+        }
+        return resent;
+    }
+
+    bool UDPPacketSender::transmit(std::span<const uint8_t> datagram) {
+        if (drop(_options.simulated_loss, _loss)) return true;
+
+        // ECONNREFUSED only means nobody was listening for the previous datagram
+        ssize_t sent = ::send(_fd, datagram.data(), datagram.size(), 0);
+        return sent == static_cast<ssize_t>(datagram.size()) || (sent < 0 && errno == ECONNREFUSED);
+    }
+
+    // receiver
+
+    UDPPacketReceiver::UDPPacketReceiver(int fd, UDPLinkOptions options) :
+        _fd(fd),
+        _options(options),
+        _datagram(max_datagram_size),
+        _loss(options.simulated_loss_seed)
+    {
+    }
+
+    std::optional<UDPPacketReceiver> UDPPacketReceiver::create(uint16_t port, UDPLinkOptions options) {
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            std::cerr << "Failed to open UDP socket: " << std::strerror(errno) << std::endl;
+            return std::nullopt;
+        }
+
+        // a burst after a stall should queue, not drop
+        int buffer = 4 * 1024 * 1024;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+
+        sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            std::cerr << "Failed to bind UDP port " << port << ": " << std::strerror(errno) << std::endl;
+            close(fd);
+            return std::nullopt;
+        }
+
+        return UDPPacketReceiver(fd, options);
+    }
+
+    UDPPacketReceiver::UDPPacketReceiver(UDPPacketReceiver&& other) noexcept :
+        _fd(other._fd),
+        _options(other._options),
+        _stats(other._stats),
+        _peer(other._peer),
+        _has_peer(other._has_peer),
+        _highest(other._highest),
+        _missing(std::move(other._missing)),
+        _datagram(std::move(other._datagram)),
+        _loss(other._loss)
+    {
+        other._fd = -1;
+    }
+
+    UDPPacketReceiver& UDPPacketReceiver::operator=(UDPPacketReceiver&& other) noexcept {
+        if (this != &other) {
+            if (_fd >= 0) close(_fd);
+            _fd = other._fd;
+            _options = other._options;
+            _stats = other._stats;
+            _peer = other._peer;
+            _has_peer = other._has_peer;
+            _highest = other._highest;
+            _missing = std::move(other._missing);
+            _datagram = std::move(other._datagram);
+            _loss = other._loss;
+            other._fd = -1;
+        }
+        return *this;
+    }
+
+    UDPPacketReceiver::~UDPPacketReceiver() {
+        if (_fd >= 0) close(_fd);
+    }
+
+    uint16_t UDPPacketReceiver::port() const {
+        sockaddr_in addr {};
+        socklen_t size = sizeof(addr);
+        if (_fd < 0 || getsockname(_fd, reinterpret_cast<sockaddr*>(&addr), &size) < 0) return 0;
+        return ntohs(addr.sin_port);
+    }
+
+    std::optional<FramePacket> UDPPacketReceiver::receive(int timeout_ms) {
+        using namespace std::chrono;
+        if (_fd < 0) return std::nullopt;
+
+        const auto until = steady_clock::now() + milliseconds(timeout_ms);
+        while (true) {
+            send_nacks();
+
+            // wake for the next datagram, the next NACK round or the timeout
+            int wait = timeout_ms < 0 ? -1 :
+                static_cast<int>(std::max<int64_t>(duration_cast<milliseconds>(until - steady_clock::now()).count(), 0));
+            if (!_missing.empty())
+                wait = wait < 0 ? static_cast<int>(_options.nack_interval.count())
+                                : std::min(wait, static_cast<int>(_options.nack_interval.count()));
+
+            pollfd pfd { .fd = _fd, .events = POLLIN, .revents = 0 };
+            int ready = ::poll(&pfd, 1, wait);
+            if (ready < 0 && errno != EINTR) {
+                std::cerr << "UDP socket poll failed: " << std::strerror(errno) << std::endl;
+                return std::nullopt;
+            }
+
+            if (ready > 0) {
+                sockaddr_in from {};
+                socklen_t from_size = sizeof(from);
+                ssize_t size = recvfrom(_fd, _datagram.data(), _datagram.size(), MSG_DONTWAIT,
+                                        reinterpret_cast<sockaddr*>(&from), &from_size);
+                if (size > 0) {
+                    if (auto packet = accept({ _datagram.data(), static_cast<size_t>(size) }, from))
+                        return packet;
+                }
+            }
+
+            if (timeout_ms >= 0 && steady_clock::now() >= until) return std::nullopt;
+        }
+    }
+
+    std::optional<FramePacket> UDPPacketReceiver::accept(std::span<const uint8_t> datagram, const sockaddr_in& from) {
+        uint32_t sequence = 0;
+        auto packet = unframe_packet(datagram, sequence);
+        if (!packet) {
+            ++_stats.corrupt;
+            return std::nullopt;
+        }
+
+        // a restarted sender numbers from 0 again, usually from a new port; a packet
+        // further back than the sender's history could not be a retransmit either
+        const size_t history = std::max<size_t>(_options.history, 1);
+        const bool new_peer = _has_peer && (from.sin_addr.s_addr != _peer.sin_addr.s_addr || from.sin_port != _peer.sin_port);
+        if (_highest) {
+            const auto behind = static_cast<int32_t>(*_highest - sequence);
+            if (new_peer || (behind > 0 && static_cast<size_t>(behind) > history)) {
+                _stats.lost += _missing.size();
+                _missing.clear();
+                _highest.reset();
+                ++_stats.restarts;
+            }
+        }
+
+        // NACKs go only to a source that has sent an intact packet
+        _peer = from;
+        _has_peer = true;
+
+        if (!_highest) {
+            _highest = sequence;
+            ++_stats.packets;
+            return packet;
+        }
+
+        const auto ahead = static_cast<int32_t>(sequence - *_highest);
+        if (ahead > 0) {
+            // everything skipped is missing; past the sender's history it cannot come back
+            const auto now = std::chrono::steady_clock::now();
+            const uint32_t gap = static_cast<uint32_t>(ahead) - 1;
+            const uint32_t tracked = std::min<uint32_t>(gap, static_cast<uint32_t>(history));
+            _stats.lost += gap - tracked;
+            for (uint32_t missing = sequence - tracked; missing != sequence; ++missing)
+                _missing[missing] = { now, now - _options.nack_interval };
+
+            _highest = sequence;
+            ++_stats.packets;
+            return packet;
+        }
+
+        // a retransmit is only wanted while its sequence number is still missing
+        auto it = _missing.find(sequence);
+        if (it == _missing.end()) {
+            ++_stats.duplicates;
+            return std::nullopt;
+        }
+
+        _missing.erase(it);
+        ++_stats.recovered;
+        ++_stats.packets;
+        return packet;
+    }
+
+    void UDPPacketReceiver::send_nacks() {
+        const auto now = std::chrono::steady_clock::now();
+
+        uint8_t nack[nack_header_size + max_nacks_per_datagram * sizeof(uint32_t)];
+        size_t count = 0;
+        auto flush = [&] {
+            if (count == 0) return;
+            nack[0] = nack_magic[0];
+            nack[1] = nack_magic[1];
+            nack[2] = packet_version;
+            nack[3] = static_cast<uint8_t>(count);
+            if (!drop(_options.simulated_loss, _loss)) {
+                sendto(_fd, nack, nack_header_size + count * sizeof(uint32_t), 0,
+                       reinterpret_cast<const sockaddr*>(&_peer), sizeof(_peer));
+            }
+            count = 0;
+        };
+
+        for (auto it = _missing.begin(); it != _missing.end();) {
+            if (now - it->second.since > _options.deadline) {
+                ++_stats.lost;
+                it = _missing.erase(it);
+                continue;
+            }
+
+            if (_has_peer && now - it->second.last_nack >= _options.nack_interval) {
+                it->second.last_nack = now;
+                std::memcpy(nack + nack_header_size + count * sizeof(uint32_t), &it->first, sizeof(uint32_t));
+                ++_stats.nacks;
+                if (++count == max_nacks_per_datagram) flush();
+            }
+            ++it;
+        }
+        flush();
+    }
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+#include <algorithm>
+
+#include "Candy/Core/Signal/DecodeTable.hpp"
+
+namespace Candy {
+
+    void DecodeTable::add(canid_t can_id, const MessageDefinition& msg_def) {
+        DecodeMessage msg;
+        msg.first_signal = static_cast<uint32_t>(_layouts.size());
+
+        if (msg_def.multiplexer && msg_def.multiplexer->codec) {
+            msg.mux = msg_def.multiplexer->codec->layout();
+            msg.has_mux = true;
+            msg.payload_size = std::max<uint8_t>(msg.payload_size, payload_extent(msg.mux));
+        }
+
+        for (size_t i = 0; i < msg_def.signal_count && i < msg_def.signals.size(); ++i) {
+            const auto& sig = msg_def.signals[i];
+            if (!sig.codec || !sig.numeric_value) continue;
+
+            _layouts.push_back(sig.codec->layout());
+            msg.payload_size = std::max<uint8_t>(msg.payload_size, payload_extent(_layouts.back()));
+            _factors.push_back(sig.numeric_value->get_factor());
+            _offsets.push_back(sig.numeric_value->get_offset());
+            _mux_vals.push_back(sig.mux_val ? static_cast<int64_t>(*sig.mux_val) : no_mux);
+            // integer, signed by the SG_ sign, unless a SIG_VALTYPE_ says otherwise
+            _value_types.push_back(sig.value_type.value_or(
+                sig.codec->sign_type() == '-' ? NumericValueType::i64 : NumericValueType::u64));
+            _signal_names.emplace_back(sig.get_name());
+            _units.emplace_back(sig.get_unit());
+            ++msg.signal_count;
+        }
+
+        // a redefined message leaves its old columns unreferenced
+        auto it = std::find(_ids.begin(), _ids.end(), can_id);
+        if (it == _ids.end()) {
+            _ids.push_back(can_id);
+            _messages.push_back(msg);
+            _message_names.emplace_back(msg_def.get_name());
+        }
+        else {
+            size_t slot = it - _ids.begin();
+            _messages[slot] = msg;
+            _message_names[slot] = msg_def.get_name();
+        }
+    }
+
+    void DecodeTable::build_index() {
+        std::vector<std::pair<canid_t, uint32_t>> entries;
+        entries.reserve(_ids.size());
+        for (size_t slot = 0; slot < _ids.size(); ++slot)
+            entries.emplace_back(_ids[slot], static_cast<uint32_t>(slot));
+        _index.build(entries);
+    }
+
+    void DecodeTable::clear() {
+        _index.clear();
+        _ids.clear();
+        _messages.clear();
+        _layouts.clear();
+        _factors.clear();
+        _offsets.clear();
+        _mux_vals.clear();
+        _value_types.clear();
+        _message_names.clear();
+        _signal_names.clear();
+        _units.clear();
+    }
+
+}
@@ -1,4 +1,6 @@
     
+#include <bit>
+
 #include "Candy/Core/Signal/NumericValue.hpp"
 
 namespace Candy {
@@ -18,6 +20,28 @@ namespace Candy {
         }
     }
 
+    bool NumericValue::convert(std::span<const uint64_t> raw_values, NumericValueType type, double* out) const {
+        switch (type) {
+            case NumericValueType::i64: convert_column<int64_t>(raw_values, out); return true;
+            case NumericValueType::u64: convert_column<uint64_t>(raw_values, out); return true;
+            case NumericValueType::f32: convert_column<float>(raw_values, out); return true;
+            case NumericValueType::f64: convert_column<double>(raw_values, out); return true;
+            default: return false;
+        }
+    }
+
+    template <typename T>
+    void NumericValue::convert_column(std::span<const uint64_t> raw_values, double* out) const {
+        for (size_t i = 0; i < raw_values.size(); ++i) {
+            T value;
+            if constexpr (sizeof(T) == sizeof(uint32_t))
+                value = std::bit_cast<T>(static_cast<uint32_t>(raw_values[i]));
+            else
+                value = std::bit_cast<T>(raw_values[i]);
+            out[i] = convert_raw_to_numeric(value);
+        }
+    }
+
     template <typename T>
     requires std::convertible_to<T, double>
     double NumericValue::convert_raw_to_numeric(T value) const {
@@ -0,0 +1,258 @@
+#include <bit>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "Candy/Core/Signal/SignalBatch.hpp"
+
+namespace {
+    using Candy::SignalLayout;
+
+    constexpr bool native_little = std::endian::native == std::endian::little;
+
+    template <bool BigEndian>
+    inline uint64_t load_u64(const uint8_t* data) {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(uint64_t));
+        if constexpr (BigEndian == native_little) {
+            return __builtin_bswap64(value);
+        }
+        return value;
+    }
+
+    // 9-byte window, see SignalLayout
+    template <bool BigEndian>
+    inline uint64_t load_wide(const SignalLayout& l, const uint8_t* data) {
+        const uint64_t lo = load_u64<BigEndian>(data + l.byte_offset);
+        const uint64_t hi = data[l.byte_offset + 8];
+        if constexpr (BigEndian)
+            return ((lo << (8 - l.shift)) | (hi >> l.shift)) & l.mask;
+        else
+            return ((lo >> l.shift) | (hi << (64 - l.shift))) & l.mask;
+    }
+
+    template <bool BigEndian>
+    void decode_wide_kernel(const SignalLayout& l, const uint8_t* data, size_t stride, size_t count, uint64_t* out) {
+        for (size_t i = 0; i < count; ++i, data += stride)
+            out[i] = (load_wide<BigEndian>(l, data) ^ l.sign_bit) - l.sign_bit;
+    }
+
+#if defined(__AVX2__)
+    template <bool BigEndian, bool Signed>
+    size_t decode_simd(const SignalLayout& l, const uint8_t* data, size_t stride, size_t count, uint64_t* out) {
+        if constexpr (!native_little) return 0;
+
+        const __m256i offsets = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+        const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(l.mask));
+        const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(l.sign_bit));
+        const __m128i shift = _mm_cvtsi32_si128(l.shift);
+        const __m256i bswap = _mm256_setr_epi8(
+            7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+            7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const auto* base = reinterpret_cast<const long long*>(data + i * stride + l.byte_offset);
+            __m256i w = _mm256_i64gather_epi64(base, offsets, 1);
+            if constexpr (BigEndian) w = _mm256_shuffle_epi8(w, bswap);
+            w = _mm256_and_si256(_mm256_srl_epi64(w, shift), mask);
+            if constexpr (Signed) w = _mm256_sub_epi64(_mm256_xor_si256(w, sign), sign);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), w);
+        }
+        return i;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    template <bool BigEndian, bool Signed>
+    size_t decode_simd(const SignalLayout& l, const uint8_t* data, size_t stride, size_t count, uint64_t* out) {
+        if constexpr (!native_little) return 0;
+
+        const uint64x2_t mask = vdupq_n_u64(l.mask);
+        const uint64x2_t sign = vdupq_n_u64(l.sign_bit);
+        const int64x2_t shift = vdupq_n_s64(-static_cast<int64_t>(l.shift));
+
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2) {
+            const uint8_t* p = data + i * stride + l.byte_offset;
+            uint64x2_t w = vcombine_u64(
+                vld1_u64(reinterpret_cast<const uint64_t*>(p)),
+                vld1_u64(reinterpret_cast<const uint64_t*>(p + stride)));
+            if constexpr (BigEndian) w = vreinterpretq_u64_u8(vrev64q_u8(vreinterpretq_u8_u64(w)));
+            w = vandq_u64(vshlq_u64(w, shift), mask);
+            if constexpr (Signed) w = vsubq_u64(veorq_u64(w, sign), sign);
+            vst1q_u64(out + i, w);
+        }
+        return i;
+    }
+#else
+    template <bool BigEndian, bool Signed>
+    size_t decode_simd(const SignalLayout&, const uint8_t*, size_t, size_t, uint64_t*) {
+        return 0;
+    }
+#endif
+
+    template <bool BigEndian, bool Signed>
+    void decode_kernel(const SignalLayout& l, const uint8_t* data, size_t stride, size_t count, uint64_t* out) {
+        size_t i = decode_simd<BigEndian, Signed>(l, data, stride, count, out);
+
+        for (const uint8_t* p = data + i * stride + l.byte_offset; i < count; ++i, p += stride) {
+            uint64_t v = (load_u64<BigEndian>(p) >> l.shift) & l.mask;
+            if constexpr (Signed) v = (v ^ l.sign_bit) - l.sign_bit;
+            out[i] = v;
+        }
+    }
+}
+
+namespace Candy {
+
+    void decode_batch(const SignalLayout& layout, const uint8_t* data, size_t stride, size_t count, uint64_t* out) {
+        if (layout.wide) {
+            if (layout.big_endian) decode_wide_kernel<true>(layout, data, stride, count, out);
+            else decode_wide_kernel<false>(layout, data, stride, count, out);
+        }
+        else if (layout.big_endian) {
+            if (layout.sign_bit) decode_kernel<true, true>(layout, data, stride, count, out);
+            else decode_kernel<true, false>(layout, data, stride, count, out);
+        }
+        else {
+            if (layout.sign_bit) decode_kernel<false, true>(layout, data, stride, count, out);
+            else decode_kernel<false, false>(layout, data, stride, count, out);
+        }
+    }
+
+    bool SignalLayoutPack::add(const SignalLayout& layout) {
+        if (layout.wide)
+            return false;
+
+        _byte_offsets.push_back(layout.byte_offset);
+        _shifts.push_back(layout.shift);
+        _masks.push_back(layout.mask);
+        _sign_bits.push_back(layout.sign_bit);
+        _big_endian.push_back(layout.big_endian ? ~0ull : 0);
+        return true;
+    }
+
+    void SignalLayoutPack::clear() {
+        _byte_offsets.clear();
+        _shifts.clear();
+        _masks.clear();
+        _sign_bits.clear();
+        _big_endian.clear();
+    }
+
+#if defined(__AVX2__)
+    size_t SignalLayoutPack::decode_simd(const uint8_t* data, uint64_t* out) const {
+        if constexpr (!native_little) return 0;
+
+        const __m256i bswap = _mm256_setr_epi8(
+            7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+            7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+        auto lanes = [](const auto& v, size_t i) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v.data() + i)); };
+
+        size_t i = 0;
+        for (; i + 4 <= size(); i += 4) {
+            __m256i w = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(data), lanes(_byte_offsets, i), 1);
+            w = _mm256_blendv_epi8(w, _mm256_shuffle_epi8(w, bswap), lanes(_big_endian, i));
+            w = _mm256_and_si256(_mm256_srlv_epi64(w, lanes(_shifts, i)), lanes(_masks, i));
+            const __m256i sign = lanes(_sign_bits, i);
+            w = _mm256_sub_epi64(_mm256_xor_si256(w, sign), sign);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), w);
+        }
+        return i;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    size_t SignalLayoutPack::decode_simd(const uint8_t* data, uint64_t* out) const {
+        if constexpr (!native_little) return 0;
+
+        size_t i = 0;
+        for (; i + 2 <= size(); i += 2) {
+            uint64x2_t w = vcombine_u64(
+                vld1_u64(reinterpret_cast<const uint64_t*>(data + _byte_offsets[i])),
+                vld1_u64(reinterpret_cast<const uint64_t*>(data + _byte_offsets[i + 1])));
+            w = vbslq_u64(vld1q_u64(_big_endian.data() + i), vreinterpretq_u64_u8(vrev64q_u8(vreinterpretq_u8_u64(w))), w);
+            const int64x2_t shift = vnegq_s64(vreinterpretq_s64_u64(vld1q_u64(_shifts.data() + i)));
+            w = vandq_u64(vshlq_u64(w, shift), vld1q_u64(_masks.data() + i));
+            const uint64x2_t sign = vld1q_u64(_sign_bits.data() + i);
+            w = vsubq_u64(veorq_u64(w, sign), sign);
+            vst1q_u64(out + i, w);
+        }
+        return i;
+    }
+#else
+    size_t SignalLayoutPack::decode_simd(const uint8_t*, uint64_t*) const {
+        return 0;
+    }
+#endif
+
+    void SignalLayoutPack::decode(const uint8_t* data, uint64_t* out) const {
+        for (size_t i = decode_simd(data, out); i < size(); ++i) {
+            const uint8_t* p = data + _byte_offsets[i];
+            uint64_t v = _big_endian[i] ? load_u64<true>(p) : load_u64<false>(p);
+            v = (v >> _shifts[i]) & _masks[i];
+            out[i] = (v ^ _sign_bits[i]) - _sign_bits[i];
+        }
+    }
+
+    void SignalLayoutPack::encode(const uint64_t* raw, uint8_t* data) const {
+        // lanes may share bytes, so each one is a read-modify-write of its window
+        for (size_t i = 0; i < size(); ++i) {
+            uint8_t* p = data + _byte_offsets[i];
+            const bool big = _big_endian[i];
+            uint64_t w = big ? load_u64<true>(p) : load_u64<false>(p);
+
+            const uint64_t field = _masks[i] << _shifts[i];
+            w = (w & ~field) | ((raw[i] << _shifts[i]) & field);
+
+            if (big == native_little)
+                w = __builtin_bswap64(w);
+            std::memcpy(p, &w, sizeof(uint64_t));
+        }
+    }
+
+    void ColumnBuffer::decode(const DecodeTable& table, uint32_t slot, std::span<const std::pair<CANTime, CANFrame>> samples) {
+        const uint8_t* data = samples.empty() ? nullptr : samples.front().second.data;
+        decode(table, slot, data, sizeof(std::pair<CANTime, CANFrame>), samples.size());
+    }
+
+    void ColumnBuffer::decode(const DecodeTable& table, uint32_t slot, std::span<const std::pair<CANTime, CANFlexibleFrame>> samples) {
+        const uint8_t* data = samples.empty() ? nullptr : samples.front().second.data;
+        decode(table, slot, data, sizeof(std::pair<CANTime, CANFlexibleFrame>), samples.size());
+    }
+
+    void ColumnBuffer::decode(const DecodeTable& table, uint32_t slot, std::span<const CANFrame> frames) {
+        const uint8_t* data = frames.empty() ? nullptr : frames.front().data;
+        decode(table, slot, data, sizeof(CANFrame), frames.size());
+    }
+
+    void ColumnBuffer::decode(const DecodeTable& table, uint32_t slot, const uint8_t* data, size_t stride, size_t count) {
+        const DecodeMessage& msg = table.message(slot);
+
+        _rows = count;
+        _columns = msg.signal_count;
+        _first_signal = msg.first_signal;
+        _has_mux = msg.has_mux;
+
+        _raw.resize(_rows * _columns);
+        _values.resize(_rows * _columns);
+        _mux.resize(_has_mux ? _rows : 0);
+
+        if (count == 0) return;
+
+        if (_has_mux)
+            decode_batch(msg.mux, data, stride, count, _mux.data());
+
+        for (size_t col = 0; col < _columns; ++col) {
+            const uint32_t sig = signal(col);
+            uint64_t* raw_col = _raw.data() + col * _rows;
+            double* value_col = _values.data() + col * _rows;
+
+            decode_batch(table.layout(sig), data, stride, count, raw_col);
+            NumericValue(table.factor(sig), table.offset(sig))
+                .convert(std::span<const uint64_t>(raw_col, _rows), table.value_type(sig), value_col);
+        }
+    }
+
+}
@@ -1,4 +1,5 @@
 #include "Candy/Core/Signal/SignalCodec.hpp"
+#include "Candy/Core/Signal/SignalBatch.hpp"
 #include <cstring>
 
 namespace {
@@ -39,9 +40,23 @@ namespace Candy {
 
     _nbytes = _byte_order == std::endian::little ?
         (_bit_size + _bit_pos + 7) / 8 : (_bit_size + (7 - _start_bit % 8) + 7) / 8;
+
+    _layout = make_signal_layout(sb, bs, bo, st);
     }
 
     uint64_t SignalCodec::operator()(const uint8_t* data) const {
+    if (_layout.wide)
+        return decode_wide(data);
+
+    uint64_t val = _layout.big_endian ?
+        load_big_u64(data + _layout.byte_offset) :
+        load_little_u64(data + _layout.byte_offset);
+
+    val = (val >> _layout.shift) & _layout.mask;
+    return (val ^ _layout.sign_bit) - _layout.sign_bit;
+    }
+
+    uint64_t SignalCodec::decode_wide(const uint8_t* data) const {
     uint64_t val = _byte_order == std::endian::little ?
         load_little_u64(data + _byte_pos) :
         load_big_u64(data + _byte_pos);
@@ -113,8 +128,31 @@ namespace Candy {
     }
     }
 
+    void SignalCodec::decode_batch(const uint8_t* data, size_t stride, size_t count, uint64_t* out) const {
+    Candy::decode_batch(_layout, data, stride, count, out);
+    }
+
+    void SignalCodec::decode_batch(std::span<const CANFrame> frames, uint64_t* out) const {
+    if (frames.empty()) return;
+    decode_batch(frames.front().data, sizeof(CANFrame), frames.size(), out);
+    }
+
+    void SignalCodec::decode_batch(std::span<const std::pair<CANTime, CANFrame>> samples, uint64_t* out) const {
+    if (samples.empty()) return;
+    decode_batch(samples.front().second.data, sizeof(std::pair<CANTime, CANFrame>), samples.size(), out);
+    }
+
+    void SignalCodec::decode_batch(std::span<const std::pair<CANTime, CANFlexibleFrame>> samples, uint64_t* out) const {
+    if (samples.empty()) return;
+    decode_batch(samples.front().second.data, sizeof(std::pair<CANTime, CANFlexibleFrame>), samples.size(), out);
+    }
+
     char SignalCodec::sign_type() const {
     return _sign_type;
     }
 
+    const SignalLayout& SignalCodec::layout() const {
+    return _layout;
+    }
+
 }
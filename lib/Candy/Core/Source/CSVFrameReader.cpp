@@ -0,0 +1,209 @@
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "Candy/Core/Source/CSVFrameReader.hpp"
+
+namespace {
+
+    // first a or b in [p, end), 16 bytes per step where the target has SIMD
+    const char* find_any(const char* p, const char* end, char a, char b) {
+#if defined(__SSE2__)
+        const __m128i va = _mm_set1_epi8(a);
+        const __m128i vb = _mm_set1_epi8(b);
+        for (; end - p >= 16; p += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)));
+            if (mask) return p + std::countr_zero(static_cast<unsigned>(mask));
+        }
+#elif defined(__ARM_NEON)
+        const uint8x16_t va = vdupq_n_u8(static_cast<uint8_t>(a));
+        const uint8x16_t vb = vdupq_n_u8(static_cast<uint8_t>(b));
+        for (; end - p >= 16; p += 16) {
+            uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+            uint8x16_t hits = vorrq_u8(vceqq_u8(chunk, va), vceqq_u8(chunk, vb));
+            // 4 bits per byte
+            uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+            if (mask) return p + std::countr_zero(mask) / 4;
+        }
+#endif
+        for (; p < end; ++p) {
+            if (*p == a || *p == b) return p;
+        }
+        return end;
+    }
+
+    int hex_digit(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        c |= 0x20;
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    }
+
+    template <typename Int>
+    bool parse_int(std::string_view field, Int& out) {
+        auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), out);
+        return ec == std::errc() && ptr == field.data() + field.size();
+    }
+
+    // one "timestamp,can_id,dlc,data,message_name" row; p ends up past its newline
+    bool parse_row(const char*& p, const char* end, std::pair<CANTime, CANFlexibleFrame>& out) {
+        std::string_view fields[4];
+        bool row_done = false;
+        for (size_t i = 0; i < 4; ++i) {
+            const char* delim = find_any(p, end, ',', '\n');
+            fields[i] = std::string_view(p, delim - p);
+            p = delim < end ? delim + 1 : end;
+
+            if (delim == end || *delim == '\n') {
+                row_done = true;
+                // the data field may close the row when message_name is missing
+                if (i < 3) return false;
+            }
+        }
+
+        if (!row_done) {
+            // message_name is not needed, but a quoted one may hold commas
+            if (p < end && *p == '"') {
+                ++p;
+                while (p < end) {
+                    p = find_any(p, end, '"', '"') + 1;
+                    if (p >= end || *p != '"') break;
+                    ++p;
+                }
+            }
+            const char* nl = find_any(std::min(p, end), end, '\n', '\n');
+            p = nl < end ? nl + 1 : end;
+        }
+
+        if (!fields[3].empty() && fields[3].back() == '\r')
+            fields[3].remove_suffix(1);
+
+        int64_t timestamp_ms;
+        canid_t can_id;
+        unsigned dlc;
+        if (!parse_int(fields[0], timestamp_ms) || !parse_int(fields[1], can_id) ||
+            !parse_int(fields[2], dlc) || dlc > CANFD_MAX_DLEN) {
+            return false;
+        }
+
+        auto& [stamp, frame] = out;
+        frame = {};
+        frame.can_id = can_id;
+        frame.length = static_cast<uint8_t>(dlc);
+        if (dlc > CAN_MAX_DLEN) frame.flags = CANFD_FDF;
+
+        // "XX XX .."
+        size_t byte = 0;
+        std::string_view hex = fields[3];
+        for (size_t i = 0; i + 1 < hex.size() && byte < dlc; ) {
+            if (hex[i] == ' ') { ++i; continue; }
+            int hi = hex_digit(hex[i]);
+            int lo = hex_digit(hex[i + 1]);
+            if (hi < 0 || lo < 0) return false;
+            frame.data[byte++] = static_cast<uint8_t>(hi << 4 | lo);
+            i += 2;
+        }
+        if (byte != dlc) return false;
+
+        stamp = CANTime(std::chrono::milliseconds(timestamp_ms));
+        return true;
+    }
+}
+
+namespace Candy {
+
+    CSVFrameReader::CSVFrameReader(const char* data, size_t size) :
+        _data(data), _size(size)
+    {
+        // frames.csv may or may not start with a header line
+        if (_size > 0 && (_data[0] < '0' || _data[0] > '9')) {
+            const char* nl = find_any(_data, _data + _size, '\n', '\n');
+            _first_row = nl < _data + _size ? static_cast<size_t>(nl - _data) + 1 : _size;
+        }
+    }
+
+    std::optional<CSVFrameReader> CSVFrameReader::create(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Failed to open CSV file: " << path << std::endl;
+            return std::nullopt;
+        }
+
+        // sys/stat.h drags in linux/types.h, whose __u64 clashes with CANKernelTypes.hpp
+        off_t file_size = lseek(fd, 0, SEEK_END);
+        if (file_size < 0) {
+            close(fd);
+            std::cerr << "Failed to size CSV file: " << path << std::endl;
+            return std::nullopt;
+        }
+
+        size_t size = static_cast<size_t>(file_size);
+        if (size == 0) {
+            close(fd);
+            return CSVFrameReader(nullptr, 0);
+        }
+
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Failed to map CSV file: " << path << std::endl;
+            return std::nullopt;
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+
+        return CSVFrameReader(static_cast<const char*>(mapped), size);
+    }
+
+    CSVFrameReader::CSVFrameReader(CSVFrameReader&& other) noexcept :
+        _data(other._data), _size(other._size), _first_row(other._first_row)
+    {
+        other._data = nullptr;
+        other._size = 0;
+    }
+
+    CSVFrameReader& CSVFrameReader::operator=(CSVFrameReader&& other) noexcept {
+        if (this != &other) {
+            if (_data) munmap(const_cast<char*>(_data), _size);
+            _data = other._data;
+            _size = other._size;
+            _first_row = other._first_row;
+            other._data = nullptr;
+            other._size = 0;
+        }
+        return *this;
+    }
+
+    CSVFrameReader::~CSVFrameReader() {
+        if (_data) munmap(const_cast<char*>(_data), _size);
+    }
+
+    CSVFrameReader::iterator CSVFrameReader::rows(size_t offset, size_t length) const {
+        offset = std::min(offset, _size);
+        return iterator(_data + offset, _data + std::min(_size, offset + length));
+    }
+
+    void CSVFrameReader::iterator::advance() {
+        while (_pos && _pos < _end) {
+            if (parse_row(_pos, _end, _sample)) return;
+        }
+        _pos = nullptr;
+    }
+
+}
+
+#endif // __unix__ || __APPLE__
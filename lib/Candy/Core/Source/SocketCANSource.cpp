@@ -0,0 +1,221 @@
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+#include <net/if.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Candy/Core/Source/SocketCANSource.hpp"
+
+namespace {
+    // from linux/can/raw.h and linux/net_tstamp.h, whose __u* typedefs clash with CANKernelTypes.hpp
+    constexpr int sol_can_raw = SOL_CAN_BASE + CAN_RAW;
+    constexpr int can_raw_filter = 1;
+    constexpr int can_raw_fd_frames = 5;
+
+    constexpr int timestamping_rx_hardware = 1 << 2;
+    constexpr int timestamping_rx_software = 1 << 3;
+    constexpr int timestamping_software = 1 << 4;
+    constexpr int timestamping_raw_hardware = 1 << 6;
+
+    // SCM_TIMESTAMPING carries three timespecs: software, (deprecated), raw hardware
+    constexpr size_t control_size = CMSG_SPACE(3 * sizeof(timespec)) + CMSG_SPACE(sizeof(uint32_t));
+
+    CANTime to_can_time(const timespec& ts) {
+        using namespace std::chrono;
+        return CANTime(duration_cast<CANTime::duration>(seconds(ts.tv_sec) + nanoseconds(ts.tv_nsec)));
+    }
+
+    bool is_set(const timespec& ts) {
+        return ts.tv_sec != 0 || ts.tv_nsec != 0;
+    }
+}
+
+namespace Candy {
+
+    SocketCANSource::SocketCANSource(int fd, SocketCANOptions options) :
+        _fd(fd), _options(options)
+    {
+        if (_options.batch_size == 0)
+            _options.batch_size = 1;
+
+        _samples.resize(_options.batch_size);
+        _msgs.resize(_options.batch_size);
+        _iovs.resize(_options.batch_size);
+        _control.resize(_options.batch_size * control_size);
+    }
+
+    std::optional<SocketCANSource> SocketCANSource::create(std::string_view interface_name,
+                                                           std::span<const canid_t> ids,
+                                                           SocketCANOptions options)
+    {
+        std::string name(interface_name);
+        unsigned if_index = if_nametoindex(name.c_str());
+        if (if_index == 0) {
+            std::cerr << "Unknown CAN interface: " << name << std::endl;
+            return std::nullopt;
+        }
+
+        int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+        if (fd < 0) {
+            std::cerr << "Failed to open CAN socket: " << std::strerror(errno) << std::endl;
+            return std::nullopt;
+        }
+
+        if (options.fd_frames) {
+            int enable = 1;
+            if (setsockopt(fd, sol_can_raw, can_raw_fd_frames, &enable, sizeof(enable)) < 0) {
+                std::cerr << "CAN FD frames not supported on " << name << ", reading classic frames" << std::endl;
+                options.fd_frames = false;
+            }
+        }
+
+        if (!ids.empty() && ids.size() <= CAN_RAW_FILTER_MAX) {
+            auto filters = filters_for(ids);
+            if (setsockopt(fd, sol_can_raw, can_raw_filter, filters.data(), filters.size() * sizeof(CANFilter)) < 0)
+                std::cerr << "Failed to install CAN filters: " << std::strerror(errno) << std::endl;
+        }
+
+        int stamping = timestamping_rx_software | timestamping_software;
+        if (options.hardware_timestamps)
+            stamping |= timestamping_rx_hardware | timestamping_raw_hardware;
+        if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &stamping, sizeof(stamping)) < 0)
+            std::cerr << "SO_TIMESTAMPING unavailable, stamping frames on receipt" << std::endl;
+
+        int overflow = 1;
+        setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &overflow, sizeof(overflow));
+
+        SocketAddress addr {};
+        addr.familyAddress = AF_CAN;
+        addr.interfaceAddress = static_cast<int>(if_index);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            std::cerr << "Failed to bind CAN socket to " << name << ": " << std::strerror(errno) << std::endl;
+            close(fd);
+            return std::nullopt;
+        }
+
+        return SocketCANSource(fd, options);
+    }
+
+    SocketCANSource::SocketCANSource(SocketCANSource&& other) noexcept :
+        _fd(other._fd),
+        _options(other._options),
+        _samples(std::move(other._samples)),
+        _msgs(std::move(other._msgs)),
+        _iovs(std::move(other._iovs)),
+        _control(std::move(other._control)),
+        _dropped(other._dropped)
+    {
+        other._fd = -1;
+    }
+
+    SocketCANSource& SocketCANSource::operator=(SocketCANSource&& other) noexcept {
+        if (this != &other) {
+            if (_fd >= 0) close(_fd);
+            _fd = other._fd;
+            _options = other._options;
+            _samples = std::move(other._samples);
+            _msgs = std::move(other._msgs);
+            _iovs = std::move(other._iovs);
+            _control = std::move(other._control);
+            _dropped = other._dropped;
+            other._fd = -1;
+        }
+        return *this;
+    }
+
+    SocketCANSource::~SocketCANSource() {
+        if (_fd >= 0) close(_fd);
+    }
+
+    std::span<const std::pair<CANTime, CANFlexibleFrame>> SocketCANSource::receive_batch(int timeout_ms) {
+        if (_fd < 0) return {};
+
+        pollfd pfd { .fd = _fd, .events = POLLIN, .revents = 0 };
+        int ready = poll(&pfd, 1, timeout_ms);
+        if (ready <= 0) {
+            if (ready < 0 && errno != EINTR)
+                std::cerr << "CAN socket poll failed: " << std::strerror(errno) << std::endl;
+            return {};
+        }
+
+        // recvmmsg rewrites the lengths, so the headers are rebuilt per call
+        for (size_t i = 0; i < _options.batch_size; ++i) {
+            _iovs[i] = { .iov_base = &_samples[i].second, .iov_len = sizeof(CANFlexibleFrame) };
+            _msgs[i] = {};
+            _msgs[i].msg_hdr.msg_iov = &_iovs[i];
+            _msgs[i].msg_hdr.msg_iovlen = 1;
+            _msgs[i].msg_hdr.msg_control = _control.data() + i * control_size;
+            _msgs[i].msg_hdr.msg_controllen = control_size;
+        }
+
+        int count = recvmmsg(_fd, _msgs.data(), static_cast<unsigned>(_options.batch_size), MSG_DONTWAIT, nullptr);
+        if (count < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                std::cerr << "CAN socket recvmmsg failed: " << std::strerror(errno) << std::endl;
+            return {};
+        }
+
+        const CANTime now = std::chrono::system_clock::now();
+        size_t kept = 0;
+
+        for (int i = 0; i < count; ++i) {
+            msghdr& hdr = _msgs[i].msg_hdr;
+            auto& [stamp, frame] = _samples[i];
+
+            if (_msgs[i].msg_len == CANFD_MTU)
+                frame.flags |= CANFD_FDF;
+            else if (_msgs[i].msg_len == CAN_MTU)
+                frame.flags = 0; // __pad of a classic frame
+            else
+                continue;
+            clear_padding(frame);
+
+            stamp = now;
+            for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+                if (cmsg->cmsg_level != SOL_SOCKET)
+                    continue;
+
+                if (cmsg->cmsg_type == SO_TIMESTAMPING) {
+                    timespec ts[3];
+                    std::memcpy(ts, CMSG_DATA(cmsg), sizeof(ts));
+                    if (_options.hardware_timestamps && is_set(ts[2]))
+                        stamp = to_can_time(ts[2]);
+                    else if (is_set(ts[0]))
+                        stamp = to_can_time(ts[0]);
+                }
+                else if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+                    std::memcpy(&_dropped, CMSG_DATA(cmsg), sizeof(_dropped));
+                }
+            }
+
+            if (kept != static_cast<size_t>(i))
+                _samples[kept] = _samples[i];
+            ++kept;
+        }
+
+        return { _samples.data(), kept };
+    }
+
+    std::vector<CANFilter> SocketCANSource::filters_for(std::span<const canid_t> ids) {
+        std::vector<CANFilter> filters;
+        filters.reserve(ids.size());
+
+        for (canid_t id : ids) {
+            if (id & CAN_EFF_FLAG)
+                filters.push_back({ .can_id = id & (CAN_EFF_FLAG | CAN_EFF_MASK), .canMask = CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_EFF_MASK });
+            else
+                filters.push_back({ .can_id = id & CAN_SFF_MASK, .canMask = CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_SFF_MASK });
+        }
+        return filters;
+    }
+
+}
+
+#endif // __linux__
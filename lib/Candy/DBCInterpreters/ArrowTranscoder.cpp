@@ -0,0 +1,760 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string_view>
+
+#include "Candy/DBCInterpreters/ArrowTranscoder.hpp"
+
+namespace {
+
+    // Just enough of the flatbuffers wire format for Arrow's Message tables.
+    // Objects are laid out front to back: a parent is written before its
+    // children, so every uoffset it holds points forward once linked.
+    class FlatBuilder {
+    public:
+        struct Field {
+            uint16_t slot;
+            uint8_t size;
+            uint64_t value = 0;
+        };
+
+        std::vector<uint8_t> bytes;
+
+        void pad(size_t alignment) {
+            bytes.resize((bytes.size() + alignment - 1) / alignment * alignment, 0);
+        }
+
+        size_t put(const void* data, size_t size) {
+            size_t at = bytes.size();
+            const auto* p = static_cast<const uint8_t*>(data);
+            bytes.insert(bytes.end(), p, p + size);
+            return at;
+        }
+
+        template <typename T>
+        size_t put(T value) { return put(&value, sizeof(T)); }
+
+        // the uoffset at `at` now refers to `target`
+        void link(size_t at, size_t target) {
+            uint32_t offset = static_cast<uint32_t>(target - at);
+            std::memcpy(bytes.data() + at, &offset, sizeof(offset));
+        }
+
+        size_t root() { return put<uint32_t>(0); }
+
+        // a vtable and its table; at[i] receives the position of fields[i]
+        size_t table(std::initializer_list<Field> fields, size_t* at = nullptr) {
+            std::array<uint16_t, 16> slot_offsets {};
+            std::array<uint16_t, 16> field_offsets {};
+            uint16_t slots = 0;
+            uint16_t size = sizeof(int32_t);
+
+            for (uint8_t width : { 8, 4, 2, 1 }) {
+                size_t i = 0;
+                for (const Field& field : fields) {
+                    if (field.size == width) {
+                        size = static_cast<uint16_t>((size + width - 1) / width * width);
+                        slot_offsets[field.slot] = size;
+                        field_offsets[i] = size;
+                        size += width;
+                    }
+                    slots = std::max<uint16_t>(slots, field.slot + 1);
+                    ++i;
+                }
+            }
+
+            pad(2);
+            size_t vtable = put<uint16_t>(static_cast<uint16_t>(4 + 2 * slots));
+            put<uint16_t>(size);
+            for (uint16_t slot = 0; slot < slots; ++slot)
+                put<uint16_t>(slot_offsets[slot]);
+
+            // 8-byte fields are aligned relative to an 8-aligned table
+            pad(8);
+            size_t table = bytes.size();
+            bytes.resize(table + size, 0);
+            int32_t vtable_offset = static_cast<int32_t>(table - vtable);
+            std::memcpy(bytes.data() + table, &vtable_offset, sizeof(vtable_offset));
+
+            size_t i = 0;
+            for (const Field& field : fields) {
+                std::memcpy(bytes.data() + table + field_offsets[i], &field.value, field.size);
+                if (at) at[i] = table + field_offsets[i];
+                ++i;
+            }
+            return table;
+        }
+
+        // a vector's length word, which is what offsets to it refer to;
+        // its elements start 4 bytes later, aligned to their size
+        size_t vector(size_t count, size_t element_size, const void* elements = nullptr) {
+            size_t alignment = std::max<size_t>(element_size, 4);
+            pad(4);
+            while ((bytes.size() + 4) % alignment) bytes.push_back(0);
+            size_t at = put<uint32_t>(static_cast<uint32_t>(count));
+            if (elements) put(elements, count * element_size);
+            else bytes.resize(bytes.size() + count * element_size, 0);
+            return at;
+        }
+
+        size_t string(std::string_view value) {
+            pad(4);
+            size_t at = put<uint32_t>(static_cast<uint32_t>(value.size()));
+            put(value.data(), value.size());
+            bytes.push_back(0);
+            return at;
+        }
+    };
+
+    // Schema.fbs / Message.fbs constants
+    constexpr uint16_t metadata_v5 = 4;
+    constexpr uint8_t header_schema = 1;
+    constexpr uint8_t header_dictionary_batch = 2;
+    constexpr uint8_t header_record_batch = 3;
+    constexpr uint8_t type_int = 2;
+    constexpr uint8_t type_floating_point = 3;
+    constexpr uint8_t type_utf8 = 5;
+    constexpr uint8_t type_timestamp = 10;
+    constexpr uint16_t precision_double = 2;
+    constexpr uint16_t time_unit_nanosecond = 3;
+
+    constexpr int64_t message_dictionary = 0;
+    constexpr int64_t signal_dictionary = 1;
+    constexpr int64_t unit_dictionary = 2;
+
+    enum class ColumnKind { timestamp, uint32, uint64, float64, dictionary };
+
+    struct ColumnSpec {
+        const char* name;
+        ColumnKind kind;
+        bool nullable = false;
+        int64_t dictionary_id = -1;
+    };
+
+    constexpr std::array<ColumnSpec, 8> decoded_schema = {{
+        { "timestamp", ColumnKind::timestamp },
+        { "can_id", ColumnKind::uint32 },
+        { "message_name", ColumnKind::dictionary, false, message_dictionary },
+        { "signal_name", ColumnKind::dictionary, false, signal_dictionary },
+        { "signal_value", ColumnKind::float64 },
+        { "raw_value", ColumnKind::uint64 },
+        { "unit", ColumnKind::dictionary, false, unit_dictionary },
+        { "mux_value", ColumnKind::uint64, true }
+    }};
+
+    // validity + values for each column
+    constexpr size_t buffers_per_column = 2;
+
+    struct FieldNode {
+        int64_t length;
+        int64_t null_count;
+    };
+
+    struct BufferSpec {
+        int64_t offset;
+        int64_t length;
+    };
+
+    // a record batch body: buffers packed back to back on 8-byte boundaries
+    struct Body {
+        std::vector<uint8_t> bytes;
+        std::vector<BufferSpec> buffers;
+
+        void add(const void* data, size_t size) {
+            buffers.push_back({ static_cast<int64_t>(bytes.size()), static_cast<int64_t>(size) });
+            const auto* p = static_cast<const uint8_t*>(data);
+            bytes.insert(bytes.end(), p, p + size);
+            bytes.resize((bytes.size() + 7) / 8 * 8, 0);
+        }
+
+        void add_empty() { add(nullptr, 0); }
+    };
+
+    size_t begin_message(FlatBuilder& fb, uint8_t header_type, int64_t body_length) {
+        size_t root = fb.root();
+        size_t at[4];
+        size_t message = fb.table({
+            { 0, 2, metadata_v5 },
+            { 1, 1, header_type },
+            { 2, 4 },
+            { 3, 8, static_cast<uint64_t>(body_length) }
+        }, at);
+        fb.link(root, message);
+        return at[2];
+    }
+
+    size_t int_type(FlatBuilder& fb, int bit_width, bool is_signed) {
+        return fb.table({ { 0, 4, static_cast<uint64_t>(bit_width) }, { 1, 1, is_signed } });
+    }
+
+    void write_field(FlatBuilder& fb, size_t link_at, const ColumnSpec& column) {
+        uint8_t type_type = type_int;
+        switch (column.kind) {
+            case ColumnKind::timestamp: type_type = type_timestamp; break;
+            case ColumnKind::float64: type_type = type_floating_point; break;
+            case ColumnKind::dictionary: type_type = type_utf8; break;
+            default: break;
+        }
+
+        size_t at[6];
+        size_t field;
+        if (column.dictionary_id >= 0) {
+            field = fb.table({ { 0, 4 }, { 1, 1, column.nullable }, { 2, 1, type_type }, { 3, 4 }, { 5, 4 }, { 4, 4 } }, at);
+        } else {
+            field = fb.table({ { 0, 4 }, { 1, 1, column.nullable }, { 2, 1, type_type }, { 3, 4 }, { 5, 4 } }, at);
+        }
+        fb.link(link_at, field);
+        fb.link(at[0], fb.string(column.name));
+
+        size_t type;
+        switch (column.kind) {
+            case ColumnKind::timestamp: {
+                size_t type_at[2];
+                type = fb.table({ { 0, 2, time_unit_nanosecond }, { 1, 4 } }, type_at);
+                fb.link(type_at[1], fb.string("UTC"));
+                break;
+            }
+            case ColumnKind::uint32: type = int_type(fb, 32, false); break;
+            case ColumnKind::uint64: type = int_type(fb, 64, false); break;
+            case ColumnKind::float64: type = fb.table({ { 0, 2, precision_double } }); break;
+            case ColumnKind::dictionary: type = fb.table({}); break;
+        }
+        fb.link(at[3], type);
+
+        // readers insist on a children vector, even an empty one
+        fb.link(at[4], fb.vector(0, 4));
+
+        if (column.dictionary_id >= 0) {
+            size_t dict_at[2];
+            size_t dictionary = fb.table({ { 0, 8, static_cast<uint64_t>(column.dictionary_id) }, { 1, 4 } }, dict_at);
+            fb.link(at[5], dictionary);
+            fb.link(dict_at[1], int_type(fb, 32, true));
+        }
+    }
+
+    std::vector<uint8_t> schema_message() {
+        FlatBuilder fb;
+        size_t header = begin_message(fb, header_schema, 0);
+
+        size_t at[2];
+        size_t schema = fb.table({ { 0, 2, 0 }, { 1, 4 } }, at);
+        fb.link(header, schema);
+
+        size_t fields = fb.vector(decoded_schema.size(), 4);
+        fb.link(at[1], fields);
+        for (size_t i = 0; i < decoded_schema.size(); ++i)
+            write_field(fb, fields + 4 + 4 * i, decoded_schema[i]);
+
+        return std::move(fb.bytes);
+    }
+
+    void write_record_batch_table(FlatBuilder& fb, size_t link_at, int64_t length,
+                                  std::span<const FieldNode> nodes, std::span<const BufferSpec> buffers) {
+        size_t at[3];
+        size_t batch = fb.table({ { 0, 8, static_cast<uint64_t>(length) }, { 1, 4 }, { 2, 4 } }, at);
+        fb.link(link_at, batch);
+        fb.link(at[1], fb.vector(nodes.size(), sizeof(FieldNode), nodes.data()));
+        fb.link(at[2], fb.vector(buffers.size(), sizeof(BufferSpec), buffers.data()));
+    }
+
+    std::vector<uint8_t> record_batch_message(int64_t length, std::span<const FieldNode> nodes, const Body& body) {
+        FlatBuilder fb;
+        size_t header = begin_message(fb, header_record_batch, static_cast<int64_t>(body.bytes.size()));
+        write_record_batch_table(fb, header, length, nodes, body.buffers);
+        return std::move(fb.bytes);
+    }
+
+    std::vector<uint8_t> dictionary_batch_message(int64_t id, int64_t length, std::span<const FieldNode> nodes, const Body& body) {
+        FlatBuilder fb;
+        size_t header = begin_message(fb, header_dictionary_batch, static_cast<int64_t>(body.bytes.size()));
+        size_t at[2];
+        size_t dictionary = fb.table({ { 0, 8, static_cast<uint64_t>(id) }, { 1, 4 } }, at);
+        fb.link(header, dictionary);
+        write_record_batch_table(fb, at[1], length, nodes, body.buffers);
+        return std::move(fb.bytes);
+    }
+
+    // Reading side, for transmit_*: bounds-checked table access into one message.
+    struct FlatTable {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        size_t pos = 0;
+
+        template <typename T>
+        T read(size_t at) const {
+            T value {};
+            if (at + sizeof(T) <= size) std::memcpy(&value, data + at, sizeof(T));
+            return value;
+        }
+
+        explicit operator bool() const { return data != nullptr; }
+
+        size_t field(uint16_t slot) const {
+            size_t vtable = pos - static_cast<size_t>(static_cast<int64_t>(read<int32_t>(pos)));
+            uint16_t vtable_size = read<uint16_t>(vtable);
+            if (4u + 2u * slot >= vtable_size) return 0;
+            uint16_t offset = read<uint16_t>(vtable + 4 + 2 * slot);
+            return offset ? pos + offset : 0;
+        }
+
+        template <typename T>
+        T scalar(uint16_t slot, T fallback = {}) const {
+            size_t at = field(slot);
+            return at ? read<T>(at) : fallback;
+        }
+
+        size_t deref(uint16_t slot) const {
+            size_t at = field(slot);
+            if (!at) return 0;
+            size_t target = at + read<uint32_t>(at);
+            return target < size ? target : 0;
+        }
+
+        FlatTable table(uint16_t slot) const {
+            size_t target = deref(slot);
+            return target ? FlatTable { data, size, target } : FlatTable {};
+        }
+
+        template <typename T>
+        std::span<const T> structs(uint16_t slot) const {
+            size_t target = deref(slot);
+            if (!target) return {};
+            size_t count = read<uint32_t>(target);
+            if (target + 4 + count * sizeof(T) > size) return {};
+            return { reinterpret_cast<const T*>(data + target + 4), count };
+        }
+    };
+
+    template <typename T>
+    std::span<const T> column_buffer(const std::vector<uint8_t>& body, std::span<const BufferSpec> buffers, size_t index, size_t rows) {
+        if (index >= buffers.size()) return {};
+        const BufferSpec& buffer = buffers[index];
+        if (buffer.offset < 0 || static_cast<size_t>(buffer.offset + buffer.length) > body.size() ||
+            static_cast<size_t>(buffer.length) < rows * sizeof(T)) {
+            return {};
+        }
+        return { reinterpret_cast<const T*>(body.data() + buffer.offset), rows };
+    }
+
+}
+
+namespace Candy {
+
+    void ArrowTranscoder::RowColumns::clear() {
+        timestamp.clear();
+        can_id.clear();
+        message.clear();
+        signal.clear();
+        value.clear();
+        raw.clear();
+        mux.clear();
+        mux_valid.clear();
+    }
+
+    ArrowTranscoder::ArrowTranscoder(FILE* file, std::string path, size_t batch_size) :
+        FileTranscoder<ArrowTranscoder>(batch_size, 0, 0),
+        file(file, fclose),
+        path(std::move(path))
+    {
+        decoded_signals_batch.reserve(batch_size);
+    }
+
+    ArrowTranscoder::~ArrowTranscoder() {
+        if (!file) return;
+        flush_all_batches();
+
+        // end-of-stream marker
+        const uint32_t end_of_stream[2] = { 0xFFFFFFFF, 0 };
+        fwrite(end_of_stream, sizeof(end_of_stream), 1, file.get());
+    }
+
+    ArrowTranscoder::ArrowTranscoder(ArrowTranscoder&& other) noexcept :
+        FileTranscoder<ArrowTranscoder>(std::move(other)),
+        file(std::move(other.file)),
+        path(std::move(other.path)),
+        dictionaries_written(other.dictionaries_written),
+        decoded_signals_batch(std::move(other.decoded_signals_batch)),
+        decoded_fd_signals_batch(std::move(other.decoded_fd_signals_batch)),
+        decoded_columns(std::move(other.decoded_columns)),
+        rows(std::move(other.rows))
+    {
+    }
+
+    ArrowTranscoder& ArrowTranscoder::operator=(ArrowTranscoder&& other) noexcept {
+        if (this != &other) {
+            if (file) {
+                flush_all_batches();
+                const uint32_t end_of_stream[2] = { 0xFFFFFFFF, 0 };
+                fwrite(end_of_stream, sizeof(end_of_stream), 1, file.get());
+            }
+
+            FileTranscoder<ArrowTranscoder>::operator=(std::move(other));
+            file = std::move(other.file);
+            path = std::move(other.path);
+            dictionaries_written = other.dictionaries_written;
+            decoded_signals_batch = std::move(other.decoded_signals_batch);
+            decoded_fd_signals_batch = std::move(other.decoded_fd_signals_batch);
+            decoded_columns = std::move(other.decoded_columns);
+            rows = std::move(other.rows);
+        }
+        return *this;
+    }
+
+    std::optional<ArrowTranscoder> ArrowTranscoder::create(const std::string& path, size_t batch_size) {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Failed to open Arrow stream for writing: " << path << std::endl;
+            return std::nullopt;
+        }
+
+        ArrowTranscoder transcoder(file, path, std::max<size_t>(batch_size, 1));
+        if (!transcoder.write_message(schema_message(), {})) {
+            std::cerr << "Failed to write Arrow schema to " << path << std::endl;
+            return std::nullopt;
+        }
+        return std::make_optional<ArrowTranscoder>(std::move(transcoder));
+    }
+
+    // CANIO
+    void ArrowTranscoder::receive_raw_message(std::pair<CANTime, CANFrame> sample) {
+        if (auto slot = decode_table.find(sample.second.can_id))
+            batch_decoded_signals(sample, decode_table.message(*slot));
+
+        if (decoded_signals_batch_count >= batch_size) flush_decoded_signals_batch();
+    }
+
+    void ArrowTranscoder::receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample) {
+        clear_padding(sample.second);
+        if (auto slot = decode_table.find(sample.second.can_id))
+            batch_decoded_signals(sample, decode_table.message(*slot));
+
+        if (decoded_signals_batch_count >= batch_size) flush_decoded_signals_batch();
+    }
+
+    // signals are decoded from the frame again, so values for ids outside the DBC are not kept
+    void ArrowTranscoder::receive_message(const CANMessage& message) {
+        receive_raw_message(message.sample);
+    }
+
+    // kept in memory only; the stream has no place for it once the schema is out
+    void ArrowTranscoder::receive_metadata(const CANDataStreamMetadata& stream_metadata) {
+        metadata = stream_metadata;
+    }
+
+    // the message table is written as the message_name dictionary
+    void ArrowTranscoder::store_message_metadata(canid_t, const std::string&, size_t) {
+    }
+
+    // transcoder methods
+    void ArrowTranscoder::batch_frame(std::pair<CANTime, CANFrame>) {
+    }
+
+    void ArrowTranscoder::batch_frame(const std::pair<CANTime, CANFlexibleFrame>&) {
+    }
+
+    void ArrowTranscoder::batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg) {
+        // a classic frame of a message read past byte 8 is decoded zero padded
+        if (msg.payload_size > CAN_MAX_DLEN)
+            decoded_fd_signals_batch.emplace_back(sample.first, widen_frame(sample.second));
+        else
+            decoded_signals_batch.push_back(sample);
+        decoded_signals_batch_count++;
+    }
+
+    void ArrowTranscoder::batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>& sample, const DecodeMessage&) {
+        decoded_fd_signals_batch.push_back(sample);
+        decoded_signals_batch_count++;
+    }
+
+    void ArrowTranscoder::flush_frames_batch() {
+    }
+
+    void ArrowTranscoder::flush_decoded_signals_batch() {
+        if (decoded_signals_batch_count == 0) return;
+
+        decode_rows(decoded_signals_batch);
+        decode_rows(decoded_fd_signals_batch);
+        decoded_signals_batch_count = 0;
+        write_full_record_batches();
+    }
+
+    void ArrowTranscoder::flush_all_batches() {
+        flush_decoded_signals_batch();
+        if (rows.size() > 0) {
+            write_record_batch(0, rows.size());
+            rows.clear();
+        }
+        if (file) fflush(file.get());
+    }
+
+    template <typename Frame>
+    void ArrowTranscoder::decode_rows(std::vector<std::pair<CANTime, Frame>>& batch) {
+        // group frames by message so each signal decodes as one contiguous column
+        std::sort(batch.begin(), batch.end(), [](const auto& a, const auto& b) {
+            if (a.second.can_id != b.second.can_id)
+                return a.second.can_id < b.second.can_id;
+            return a.first < b.first;
+        });
+
+        auto run_begin = batch.begin();
+        while (run_begin != batch.end()) {
+            canid_t can_id = run_begin->second.can_id;
+            auto run_end = std::find_if(run_begin, batch.end(), [can_id](const auto& s) {
+                return s.second.can_id != can_id;
+            });
+
+            if (auto slot = decode_table.find(can_id)) {
+                std::span<const std::pair<CANTime, Frame>> run(&*run_begin, run_end - run_begin);
+                decoded_columns.decode(decode_table, *slot, run);
+
+                for (size_t row = 0; row < run.size(); ++row) {
+                    const int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        run[row].first.time_since_epoch()).count();
+                    auto mux_value = decoded_columns.mux(row);
+
+                    for (size_t col = 0; col < decoded_columns.columns(); ++col) {
+                        const uint32_t signal = decoded_columns.signal(col);
+                        if (!decode_table.is_active(signal, mux_value)) continue;
+
+                        rows.timestamp.push_back(timestamp);
+                        rows.can_id.push_back(can_id);
+                        rows.message.push_back(static_cast<int32_t>(*slot));
+                        rows.signal.push_back(static_cast<int32_t>(signal));
+                        rows.value.push_back(decoded_columns.values(col)[row]);
+                        rows.raw.push_back(decoded_columns.raw(col)[row]);
+                        rows.mux.push_back(mux_value.value_or(0));
+                        rows.mux_valid.push_back(mux_value.has_value());
+                    }
+                }
+            }
+
+            run_begin = run_end;
+        }
+
+        batch.clear();
+    }
+
+    void ArrowTranscoder::write_full_record_batches() {
+        size_t first = 0;
+        while (rows.size() - first >= batch_size) {
+            write_record_batch(first, batch_size);
+            first += batch_size;
+        }
+        if (first == 0) return;
+
+        // the remainder opens the next batch
+        auto drop = [first](auto& column) { column.erase(column.begin(), column.begin() + first); };
+        drop(rows.timestamp);
+        drop(rows.can_id);
+        drop(rows.message);
+        drop(rows.signal);
+        drop(rows.value);
+        drop(rows.raw);
+        drop(rows.mux);
+        drop(rows.mux_valid);
+    }
+
+    bool ArrowTranscoder::write_message(const std::vector<uint8_t>& metadata, const std::vector<uint8_t>& body) {
+        // continuation marker, padded metadata length, metadata, body
+        const uint32_t continuation = 0xFFFFFFFF;
+        const int32_t metadata_size = static_cast<int32_t>((metadata.size() + 7) / 8 * 8);
+        const std::array<uint8_t, 8> padding {};
+
+        return fwrite(&continuation, sizeof(continuation), 1, file.get()) == 1 &&
+               fwrite(&metadata_size, sizeof(metadata_size), 1, file.get()) == 1 &&
+               fwrite(metadata.data(), 1, metadata.size(), file.get()) == metadata.size() &&
+               fwrite(padding.data(), 1, metadata_size - metadata.size(), file.get()) == metadata_size - metadata.size() &&
+               fwrite(body.data(), 1, body.size(), file.get()) == body.size();
+    }
+
+    void ArrowTranscoder::write_dictionaries() {
+        if (dictionaries_written) return;
+        dictionaries_written = true;
+
+        auto write_dictionary = [&](int64_t id, size_t count, auto&& value) {
+            Body body;
+            std::vector<int32_t> offsets { 0 };
+            std::string strings;
+            for (size_t i = 0; i < count; ++i) {
+                strings += value(i);
+                offsets.push_back(static_cast<int32_t>(strings.size()));
+            }
+            body.add_empty();
+            body.add(offsets.data(), offsets.size() * sizeof(int32_t));
+            body.add(strings.data(), strings.size());
+
+            const FieldNode node { static_cast<int64_t>(count), 0 };
+            write_message(dictionary_batch_message(id, node.length, { &node, 1 }, body), body.bytes);
+        };
+
+        write_dictionary(message_dictionary, decode_table.message_count(),
+                         [&](size_t i) { return decode_table.message_name(static_cast<uint32_t>(i)); });
+        write_dictionary(signal_dictionary, decode_table.signal_count(),
+                         [&](size_t i) { return decode_table.signal_name(static_cast<uint32_t>(i)); });
+        write_dictionary(unit_dictionary, decode_table.signal_count(),
+                         [&](size_t i) { return decode_table.unit(static_cast<uint32_t>(i)); });
+    }
+
+    void ArrowTranscoder::write_record_batch(size_t first, size_t count) {
+        if (count == 0 || !file) return;
+        write_dictionaries();
+
+        std::vector<uint8_t> mux_validity((count + 7) / 8, 0);
+        int64_t mux_nulls = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (rows.mux_valid[first + i]) mux_validity[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+            else ++mux_nulls;
+        }
+
+        Body body;
+        auto add_column = [&](const auto& column) {
+            body.add_empty();
+            body.add(column.data() + first, count * sizeof(column[0]));
+        };
+        add_column(rows.timestamp);
+        add_column(rows.can_id);
+        add_column(rows.message);
+        add_column(rows.signal);
+        add_column(rows.value);
+        add_column(rows.raw);
+        add_column(rows.signal); // unit dictionary is indexed by signal too
+        if (mux_nulls > 0) body.add(mux_validity.data(), mux_validity.size());
+        else body.add_empty();
+        body.add(rows.mux.data() + first, count * sizeof(uint64_t));
+
+        std::array<FieldNode, decoded_schema.size()> nodes;
+        nodes.fill({ static_cast<int64_t>(count), 0 });
+        nodes.back().null_count = mux_nulls;
+
+        if (!write_message(record_batch_message(static_cast<int64_t>(count), nodes, body), body.bytes))
+            std::cerr << "Failed to write Arrow record batch to " << path << std::endl;
+    }
+
+    // readback
+
+    std::vector<CANMessage> ArrowTranscoder::transmit_messages(canid_t can_id) {
+        return transmit_messages_in_range(can_id, CANTime::min(), CANTime::max());
+    }
+
+    std::vector<CANMessage> ArrowTranscoder::transmit_messages_in_range(canid_t can_id, CANTime start, CANTime end) {
+        std::vector<CANMessage> messages;
+        flush_all_batches();
+
+        FILE* in = fopen(path.c_str(), "rb");
+        if (!in) return messages;
+
+        const int64_t start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count();
+        const int64_t end_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end.time_since_epoch()).count();
+
+        std::array<std::vector<std::string>, 3> dictionaries;
+        std::vector<uint8_t> metadata_bytes;
+        std::vector<uint8_t> body;
+
+        auto name = [&](int64_t dictionary, int32_t index) -> std::string_view {
+            const auto& values = dictionaries[dictionary];
+            return index >= 0 && static_cast<size_t>(index) < values.size() ? std::string_view(values[index]) : "";
+        };
+
+        // the rows of one frame are adjacent, signals in ascending order,
+        // though a frame may straddle two record batches
+        int64_t last_timestamp = 0;
+        int32_t last_signal = -1;
+
+        while (true) {
+            uint32_t prefix[2];
+            if (fread(prefix, sizeof(prefix), 1, in) != 1 || prefix[0] != 0xFFFFFFFF || prefix[1] == 0) break;
+
+            metadata_bytes.resize(prefix[1]);
+            if (fread(metadata_bytes.data(), 1, metadata_bytes.size(), in) != metadata_bytes.size()) break;
+
+            FlatTable root { metadata_bytes.data(), metadata_bytes.size(), 0 };
+            FlatTable message { root.data, root.size, root.read<uint32_t>(0) };
+            const uint8_t header_type = message.scalar<uint8_t>(1);
+            const FlatTable header = message.table(2);
+            const int64_t body_length = message.scalar<int64_t>(3);
+
+            body.resize(static_cast<size_t>(std::max<int64_t>(body_length, 0)));
+            if (fread(body.data(), 1, body.size(), in) != body.size()) break;
+            if (!header) continue;
+
+            if (header_type == header_dictionary_batch) {
+                const int64_t id = header.scalar<int64_t>(0);
+                const FlatTable batch = header.table(1);
+                if (id < 0 || id >= static_cast<int64_t>(dictionaries.size()) || !batch) continue;
+
+                const size_t count = static_cast<size_t>(batch.scalar<int64_t>(0));
+                auto buffers = batch.structs<BufferSpec>(2);
+                auto offsets = column_buffer<int32_t>(body, buffers, 1, count + 1);
+                if (offsets.empty() || buffers.size() < 3) continue;
+
+                auto& values = dictionaries[id];
+                values.clear();
+                const char* strings = reinterpret_cast<const char*>(body.data() + buffers[2].offset);
+                for (size_t i = 0; i < count; ++i)
+                    values.emplace_back(strings + offsets[i], offsets[i + 1] - offsets[i]);
+                continue;
+            }
+
+            if (header_type != header_record_batch) continue;
+
+            const size_t count = static_cast<size_t>(header.scalar<int64_t>(0));
+            auto buffers = header.structs<BufferSpec>(2);
+            if (buffers.size() != decoded_schema.size() * buffers_per_column) continue;
+
+            auto column = [&](auto type, size_t index) {
+                return column_buffer<decltype(type)>(body, buffers, index * buffers_per_column + 1, count);
+            };
+            auto timestamps = column(int64_t{}, 0);
+            auto can_ids = column(uint32_t{}, 1);
+            auto message_names = column(int32_t{}, 2);
+            auto signal_names = column(int32_t{}, 3);
+            auto values = column(double{}, 4);
+            auto units = column(int32_t{}, 6);
+            auto mux_values = column(uint64_t{}, 7);
+            if (timestamps.empty() || can_ids.empty() || values.empty() || mux_values.empty()) continue;
+
+            const BufferSpec& mux_validity = buffers[7 * buffers_per_column];
+            if (mux_validity.length != 0 && (mux_validity.offset < 0 ||
+                static_cast<size_t>(mux_validity.offset) + (count + 7) / 8 > body.size())) {
+                continue;
+            }
+
+            for (size_t row = 0; row < count; ++row) {
+                if (can_ids[row] != can_id || timestamps[row] < start_ns || timestamps[row] > end_ns) {
+                    last_signal = -1;
+                    continue;
+                }
+
+                if (last_signal < 0 || timestamps[row] != last_timestamp || signal_names[row] <= last_signal) {
+                    CANMessage& frame = messages.emplace_back();
+                    frame.sample.first = CANTime(std::chrono::duration_cast<CANTime::duration>(std::chrono::nanoseconds(timestamps[row])));
+                    frame.sample.second.can_id = can_id;
+                    frame.set_message_name(name(message_dictionary, message_names[row]));
+
+                    bool mux_valid = mux_validity.length == 0 ||
+                        (body[mux_validity.offset + row / 8] >> (row % 8)) & 1;
+                    if (mux_valid) frame.mux_value = mux_values[row];
+                }
+
+                messages.back().add_signal(name(signal_dictionary, signal_names[row]), values[row],
+                                           name(unit_dictionary, units[row]));
+                last_timestamp = timestamps[row];
+                last_signal = signal_names[row];
+            }
+        }
+
+        fclose(in);
+
+        std::stable_sort(messages.begin(), messages.end(), [](const CANMessage& a, const CANMessage& b) {
+            return a.sample.first < b.sample.first;
+        });
+        return messages;
+    }
+
+    const CANDataStreamMetadata& ArrowTranscoder::transmit_metadata() {
+        return metadata;
+    }
+
+}
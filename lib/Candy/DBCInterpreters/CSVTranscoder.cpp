@@ -4,48 +4,95 @@
 #include <cstdio>
 #include <algorithm>
 #include <string_view>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 #include "Candy/DBCInterpreters/CSVTranscoder.hpp"
 
 namespace Candy {
 
+    struct CSVTranscoder::AsyncWriter {
+        struct Batches {
+            std::vector<std::pair<CANTime, CANFlexibleFrame>> frames;
+            std::vector<std::pair<CANTime, CANFrame>> decoded;
+            std::vector<std::pair<CANTime, CANFlexibleFrame>> decoded_fd;
+        };
+
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable work_ready;
+        std::condition_variable writer_idle;
+        std::deque<Batches> pending;
+        // written-out batches, handed back to ingest with their capacity
+        std::vector<Batches> spare;
+        bool writing = false;
+        bool stopping = false;
+    };
+
     CSVTranscoder::CSVTranscoder(std::string_view base_path, 
                       size_t batch_size, 
                       CSVWriter<3> messages_csv,
                       CSVWriter<5> frames_csv,
                       CSVWriter<8> decoded_frames_csv,
-                      CSVWriter<7> metadata_csv) : 
+                      CSVWriter<7> metadata_csv,
+                      CSVIndexWriter frames_index,
+                      CSVIndexWriter decoded_frames_index,
+                      CSVAsyncFlush async_flush) : 
         FileTranscoder<CSVTranscoder>(batch_size, 0, 0),
         base_path(base_path),
         messages_csv(std::move(messages_csv)),
         frames_csv(std::move(frames_csv)),
         decoded_frames_csv(std::move(decoded_frames_csv)),
-        metadata_csv(std::move(metadata_csv))
+        metadata_csv(std::move(metadata_csv)),
+        frames_index(std::move(frames_index)),
+        decoded_frames_index(std::move(decoded_frames_index)),
+        async_flush(async_flush)
     {
+        if (this->async_flush.max_pending == 0)
+            this->async_flush.max_pending = 1;
+
         frames_batch.reserve(batch_size);
         decoded_signals_batch.reserve(batch_size);
     }
 
     CSVTranscoder::~CSVTranscoder() {
         flush_all_batches();
+        stop_async_writer();
     }
 
+    // the writer thread works on the moved-from object, so it is stopped first
     CSVTranscoder::CSVTranscoder(CSVTranscoder&& other) noexcept
+        : CSVTranscoder(other.stop_async_writer(), std::move(other))
+    {
+    }
+
+    CSVTranscoder::CSVTranscoder(async_stopped_t, CSVTranscoder&& other) noexcept
         : FileTranscoder<CSVTranscoder>(std::move(other)),
           base_path(std::move(other.base_path)),
           messages_csv(std::move(other.messages_csv)),
           frames_csv(std::move(other.frames_csv)),
           decoded_frames_csv(std::move(other.decoded_frames_csv)),
           metadata_csv(std::move(other.metadata_csv)),
+          frames_index(std::move(other.frames_index)),
+          decoded_frames_index(std::move(other.decoded_frames_index)),
           headers_written(std::move(other.headers_written)),
           frames_batch(std::move(other.frames_batch)),
-          decoded_signals_batch(std::move(other.decoded_signals_batch))
+          decoded_signals_batch(std::move(other.decoded_signals_batch)),
+          decoded_fd_signals_batch(std::move(other.decoded_fd_signals_batch)),
+          decoded_columns(std::move(other.decoded_columns)),
+          async_flush(other.async_flush),
+          dropped_frame_count(other.dropped_frame_count),
+          dropped_decoded_row_count(other.dropped_decoded_row_count)
     {
     }
 
     CSVTranscoder& CSVTranscoder::operator=(CSVTranscoder&& other) noexcept {
         if (this != &other) {
             flush_all_batches();
+            stop_async_writer();
+            other.stop_async_writer();
             
             FileTranscoder<CSVTranscoder>::operator=(std::move(other));
             base_path = std::move(other.base_path);
@@ -53,14 +100,22 @@ namespace Candy {
             frames_csv = std::move(other.frames_csv);
             decoded_frames_csv = std::move(other.decoded_frames_csv);
             metadata_csv = std::move(other.metadata_csv);
+            frames_index = std::move(other.frames_index);
+            decoded_frames_index = std::move(other.decoded_frames_index);
             headers_written = std::move(other.headers_written);
             frames_batch = std::move(other.frames_batch);
             decoded_signals_batch = std::move(other.decoded_signals_batch);
+            decoded_fd_signals_batch = std::move(other.decoded_fd_signals_batch);
+            decoded_columns = std::move(other.decoded_columns);
+            async_flush = other.async_flush;
+            dropped_frame_count = other.dropped_frame_count;
+            dropped_decoded_row_count = other.dropped_decoded_row_count;
         }
         return *this;
     }
 
-    std::optional<CSVTranscoder> CSVTranscoder::create(std::string_view base_path, size_t batch_size) {
+    std::optional<CSVTranscoder> CSVTranscoder::create(std::string_view base_path, size_t batch_size,
+                                                       CSVAsyncFlush async_flush) {
         std::filesystem::create_directories(base_path);
         
         CSVHeader<3> messages_header = {
@@ -93,21 +148,51 @@ namespace Candy {
             return std::nullopt;
         }
 
+        std::optional<CSVIndexWriter> frames_index = CSVIndexWriter::create(std::string(base_path) + frames_header.filename);
+        std::optional<CSVIndexWriter> decoded_frames_index = CSVIndexWriter::create(std::string(base_path) + decoded_frames_header.filename);
+
+        if (!frames_index.has_value() || !decoded_frames_index.has_value()) {
+            return std::nullopt;
+        }
+
         return std::make_optional<CSVTranscoder>(base_path,
                                                  batch_size, 
                                                  std::move(messages_csv.value()), 
                                                  std::move(frames_csv.value()), 
                                                  std::move(decoded_frames_csv.value()), 
-                                                 std::move(metadata_csv.value()));
+                                                 std::move(metadata_csv.value()),
+                                                 std::move(frames_index.value()),
+                                                 std::move(decoded_frames_index.value()),
+                                                 async_flush);
     }
 
     // public Methods
     void CSVTranscoder::receive_raw_message(std::pair<CANTime, CANFrame> sample) {
         batch_frame(sample);
 
-        auto msg_it = messages.find(sample.second.can_id);
-        if (msg_it != messages.end()) {
-            batch_decoded_signals(sample, msg_it->second);
+        if (auto slot = decode_table.find(sample.second.can_id)) {
+            batch_decoded_signals(sample, decode_table.message(*slot));
+        }
+
+        flush_full_batches();
+    }
+
+    void CSVTranscoder::receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample) {
+        clear_padding(sample.second);
+        batch_frame(sample);
+
+        if (auto slot = decode_table.find(sample.second.can_id)) {
+            batch_decoded_signals(sample, decode_table.message(*slot));
+        }
+
+        flush_full_batches();
+    }
+
+    void CSVTranscoder::flush_full_batches() {
+        if (async_flush.enabled) {
+            if (frames_batch_count >= batch_size || decoded_signals_batch_count >= batch_size)
+                hand_off_batches();
+            return;
         }
 
         if (frames_batch_count >= batch_size) {
@@ -120,123 +205,287 @@ namespace Candy {
 
     void CSVTranscoder::store_message_metadata(canid_t message_id, const std::string& message_name, size_t message_size) {
         messages_csv.start_row();
-        messages_csv.field(std::to_string(message_id));
+        messages_csv.field(message_id);
         messages_csv.field(message_name);
-        messages_csv.field(std::to_string(message_size));
+        messages_csv.field(message_size);
         messages_csv.end_row();
         messages_csv.flush();
     }
 
     // protected Methods
     void CSVTranscoder::batch_frame(std::pair<CANTime, CANFrame> sample) {
+        frames_batch.emplace_back(sample.first, widen_frame(sample.second));
+        frames_batch_count++;
+    }
+
+    void CSVTranscoder::batch_frame(const std::pair<CANTime, CANFlexibleFrame>& sample) {
         frames_batch.push_back(sample);
         frames_batch_count++;
     }
 
-    void CSVTranscoder::batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const MessageDefinition& msg_def) {
-        auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(sample.first.time_since_epoch()).count();
+    void CSVTranscoder::batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg) {
+        // a classic frame of a message read past byte 8 is decoded zero padded
+        if (msg.payload_size > CAN_MAX_DLEN)
+            decoded_fd_signals_batch.emplace_back(sample.first, widen_frame(sample.second));
+        else
+            decoded_signals_batch.push_back(sample);
+        decoded_signals_batch_count++;
+    }
 
-        std::optional<uint64_t> mux_value;
-        if (msg_def.multiplexer.has_value()) {
-            uint64_t raw_mux = (*msg_def.multiplexer->codec)(sample.second.data);
-            mux_value = raw_mux;
-        }
+    void CSVTranscoder::batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>& sample, const DecodeMessage&) {
+        decoded_fd_signals_batch.push_back(sample);
+        decoded_signals_batch_count++;
+    }
 
-        for (size_t i = 0; i < msg_def.signal_count && i < msg_def.signals.size(); ++i) {
-            const auto& signal = msg_def.signals[i];
-            
-            // Skip signals with null pointers
-            if (!signal.codec || !signal.numeric_value) {
-                continue;
+    // the rows write_decoded_signals would have written for the batch
+    template <typename Frame>
+    uint64_t CSVTranscoder::count_decoded_rows(const std::vector<std::pair<CANTime, Frame>>& batch) const {
+        uint64_t rows = 0;
+        for (const auto& [timestamp, frame] : batch) {
+            auto slot = decode_table.find(frame.can_id);
+            if (!slot) continue;
+
+            const DecodeMessage& msg = decode_table.message(*slot);
+            std::optional<uint64_t> mux;
+            if (msg.has_mux) {
+                uint64_t mux_raw;
+                decode_batch(msg.mux, frame.data, 0, 1, &mux_raw);
+                mux = mux_raw;
             }
-            
-            if (signal.mux_val.has_value() && (!mux_value || mux_value.value() != signal.mux_val.value())) {
-                continue;
+            for (uint32_t sig = msg.first_signal; sig < msg.first_signal + msg.signal_count; ++sig)
+                rows += decode_table.is_active(sig, mux);
+        }
+        return rows;
+    }
+
+    void CSVTranscoder::hand_off_batches() {
+        if (!async_writer) {
+            async_writer = std::make_unique<AsyncWriter>();
+            async_writer->thread = std::thread([this] { run_async_writer(); });
+        }
+        AsyncWriter& writer = *async_writer;
+
+        std::unique_lock lock(writer.mutex);
+        if (writer.pending.size() >= async_flush.max_pending) {
+            if (async_flush.policy == CSVAsyncFlush::Policy::drop) {
+                lock.unlock();
+                dropped_frame_count += frames_batch.size();
+                dropped_decoded_row_count += count_decoded_rows(decoded_signals_batch) +
+                                             count_decoded_rows(decoded_fd_signals_batch);
+                frames_batch.clear();
+                decoded_signals_batch.clear();
+                decoded_fd_signals_batch.clear();
+                frames_batch_count = 0;
+                decoded_signals_batch_count = 0;
+                return;
             }
+            writer.writer_idle.wait(lock, [&] { return writer.pending.size() < async_flush.max_pending; });
+        }
+
+        AsyncWriter::Batches batches;
+        if (!writer.spare.empty()) {
+            batches = std::move(writer.spare.back());
+            writer.spare.pop_back();
+        }
+        std::swap(batches.frames, frames_batch);
+        std::swap(batches.decoded, decoded_signals_batch);
+        std::swap(batches.decoded_fd, decoded_fd_signals_batch);
+        writer.pending.push_back(std::move(batches));
+        lock.unlock();
+        writer.work_ready.notify_one();
+
+        // only before the spares have gone round once
+        frames_batch.reserve(batch_size);
+        decoded_signals_batch.reserve(batch_size);
+        frames_batch_count = 0;
+        decoded_signals_batch_count = 0;
+    }
 
-            uint64_t raw_value = (*signal.codec)(sample.second.data);
-            auto converted_value = signal.numeric_value->convert(raw_value, signal.value_type);
-            if (!converted_value.has_value()) continue;
+    void CSVTranscoder::run_async_writer() {
+        AsyncWriter& writer = *async_writer;
+        std::unique_lock lock(writer.mutex);
 
-            DecodedSignalBatchEntry entry;
-            entry.timestamp = sample.first;
-            entry.can_id = sample.second.can_id;
-            
-            entry.message_name.fill(0);
-            entry.signal_name.fill(0);
-            entry.unit.fill(0);
-            
-            auto msg_name = msg_def.get_name();
-            size_t msg_len = msg_name.length() < entry.message_name.size() - 1 ? msg_name.length() : entry.message_name.size() - 1;
-            std::copy_n(msg_name.begin(), msg_len, entry.message_name.begin());
-            
-            auto sig_name = signal.get_name();
-            size_t sig_len = sig_name.length() < entry.signal_name.size() - 1 ? sig_name.length() : entry.signal_name.size() - 1;
-            std::copy_n(sig_name.begin(), sig_len, entry.signal_name.begin());
-            
-            auto unit_name = signal.get_unit();
-            size_t unit_len = unit_name.length() < entry.unit.size() - 1 ? unit_name.length() : entry.unit.size() - 1;
-            std::copy_n(unit_name.begin(), unit_len, entry.unit.begin());
-            
-            entry.signal_value = converted_value.value();
-            entry.raw_value = raw_value;
-            entry.mux_value = mux_value;
-            decoded_signals_batch.emplace_back(std::move(entry));
-            decoded_signals_batch_count++;
+        while (true) {
+            writer.work_ready.wait(lock, [&] { return writer.stopping || !writer.pending.empty(); });
+            if (writer.pending.empty()) return;
+
+            AsyncWriter::Batches batches = std::move(writer.pending.front());
+            writer.pending.pop_front();
+            writer.writing = true;
+            lock.unlock();
+
+            write_frames(batches.frames);
+            write_decoded_signals(batches.decoded);
+            write_decoded_signals(batches.decoded_fd);
+            frames_csv.flush();
+            frames_index.flush();
+            decoded_frames_csv.flush();
+            decoded_frames_index.flush();
+
+            lock.lock();
+            writer.writing = false;
+            writer.spare.push_back(std::move(batches));
+            writer.writer_idle.notify_all();
+        }
+    }
+
+    void CSVTranscoder::wait_for_async_writer() {
+        if (!async_writer) return;
+
+        AsyncWriter& writer = *async_writer;
+        std::unique_lock lock(writer.mutex);
+        writer.writer_idle.wait(lock, [&] { return writer.pending.empty() && !writer.writing; });
+    }
+
+    CSVTranscoder::async_stopped_t CSVTranscoder::stop_async_writer() {
+        if (async_writer) {
+            {
+                std::lock_guard lock(async_writer->mutex);
+                async_writer->stopping = true;
+            }
+            async_writer->work_ready.notify_one();
+            async_writer->thread.join();
+            async_writer.reset();
         }
+        return {};
     }
 
     void CSVTranscoder::flush_frames_batch() {
         if (frames_batch_count == 0) return;
 
-        for (const auto& [timestamp, frame] : frames_batch) {
-            auto msg_it = messages.find(frame.can_id);
-            std::string message_name = (msg_it != messages.end()) ? std::string(msg_it->second.get_name()) : "";
+        wait_for_async_writer();
+        write_frames(frames_batch);
+        frames_csv.flush();
+        frames_index.flush();
+        frames_batch_count = 0;
+    }
+
+    void CSVTranscoder::index_row(canid_t can_id, int64_t timestamp_ms) {
+        for (auto& entry : index_entries) {
+            if (entry.can_id != can_id) continue;
+            entry.first_ms = std::min(entry.first_ms, timestamp_ms);
+            entry.last_ms = std::max(entry.last_ms, timestamp_ms);
+            return;
+        }
+        index_entries.push_back({ .offset = 0, .length = 0, .can_id = can_id, .first_ms = timestamp_ms, .last_ms = timestamp_ms });
+    }
+
+    void CSVTranscoder::write_frames(std::vector<std::pair<CANTime, CANFlexibleFrame>>& batch) {
+        if (batch.empty()) return;
+
+        // rows stay in arrival order, so every id in the block shares its byte range
+        index_entries.clear();
+        const long block_begin = frames_csv.tell();
+
+        for (const auto& [timestamp, frame] : batch) {
+            std::string_view message_name = decode_table.find_message_name(frame.can_id);
             
             auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count();
-            std::string hex_data = format_hex_data(frame.data, frame.len);
 
             frames_csv.start_row();
-            frames_csv.field(std::to_string(timestamp_ms));
-            frames_csv.field(std::to_string(frame.can_id));
-            frames_csv.field(std::to_string(static_cast<int>(frame.len)));
-            frames_csv.field(hex_data);
+            frames_csv.field(timestamp_ms);
+            frames_csv.field(frame.can_id);
+            frames_csv.field(static_cast<unsigned>(frame.length));
+            frames_csv.hex_field({ frame.data, frame.length });
             frames_csv.field(message_name);
             frames_csv.end_row();
+
+            index_row(frame.can_id, timestamp_ms);
         }
 
-        frames_csv.flush();
-        frames_batch.clear();
-        frames_batch_count = 0;
+        const long block_end = frames_csv.tell();
+        if (block_begin >= 0 && block_end >= block_begin) {
+            for (auto& entry : index_entries) {
+                entry.offset = static_cast<uint64_t>(block_begin);
+                entry.length = static_cast<uint32_t>(block_end - block_begin);
+            }
+            frames_index.append(index_entries);
+        }
+
+        batch.clear();
+    }
+
+    template <typename Frame>
+    void CSVTranscoder::write_decoded_signals(std::vector<std::pair<CANTime, Frame>>& batch) {
+        // group frames by message so each signal decodes as one contiguous column
+        std::sort(batch.begin(), batch.end(), [](const auto& a, const auto& b) {
+            if (a.second.can_id != b.second.can_id)
+                return a.second.can_id < b.second.can_id;
+            return a.first < b.first;
+        });
+
+        // one index entry per run, the rows of a run being contiguous
+        index_entries.clear();
+
+        auto run_begin = batch.begin();
+        while (run_begin != batch.end()) {
+            canid_t can_id = run_begin->second.can_id;
+            auto run_end = std::find_if(run_begin, batch.end(), [can_id](const auto& s) {
+                return s.second.can_id != can_id;
+            });
+
+            if (auto slot = decode_table.find(can_id)) {
+                std::string_view message_name = decode_table.message_name(*slot);
+                std::span<const std::pair<CANTime, Frame>> run(&*run_begin, run_end - run_begin);
+                decoded_columns.decode(decode_table, *slot, run);
+
+                const long run_offset = decoded_frames_csv.tell();
+
+                for (size_t row = 0; row < run.size(); ++row) {
+                    const CANTime timestamp = run[row].first;
+                    auto mux_value = decoded_columns.mux(row);
+
+                    for (size_t col = 0; col < decoded_columns.columns(); ++col) {
+                        const uint32_t signal = decoded_columns.signal(col);
+                        if (!decode_table.is_active(signal, mux_value)) continue;
+
+                        decoded_frames_csv.start_row();
+                        decoded_frames_csv.field(timestamp);
+                        decoded_frames_csv.field(can_id);
+                        decoded_frames_csv.field(message_name);
+                        decoded_frames_csv.field(decode_table.signal_name(signal));
+                        decoded_frames_csv.field(decoded_columns.values(col)[row], 6);
+                        decoded_frames_csv.field(decoded_columns.raw(col)[row]);
+                        decoded_frames_csv.field(decode_table.unit(signal));
+                        if (mux_value) decoded_frames_csv.field(*mux_value);
+                        else decoded_frames_csv.field("");
+                        decoded_frames_csv.end_row();
+                    }
+                }
+
+                const long run_end_offset = decoded_frames_csv.tell();
+                if (run_offset >= 0 && run_end_offset > run_offset) {
+                    index_entries.push_back({
+                        .offset = static_cast<uint64_t>(run_offset),
+                        .length = static_cast<uint32_t>(run_end_offset - run_offset),
+                        .can_id = can_id,
+                        .first_ms = std::chrono::duration_cast<std::chrono::milliseconds>(run.front().first.time_since_epoch()).count(),
+                        .last_ms = std::chrono::duration_cast<std::chrono::milliseconds>(run.back().first.time_since_epoch()).count()
+                    });
+                }
+            }
+
+            run_begin = run_end;
+        }
+
+        decoded_frames_index.append(index_entries);
+        batch.clear();
     }
 
     void CSVTranscoder::flush_decoded_signals_batch() {
         if (decoded_signals_batch_count == 0) return;
-        
-        for (const auto& entry : decoded_signals_batch) {
-            auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(entry.timestamp.time_since_epoch()).count();
-            
-            std::array<char, 32> value_buf;
-            snprintf(value_buf.data(), value_buf.size(), "%.6f", entry.signal_value);
-
-            decoded_frames_csv.start_row();
-            decoded_frames_csv.field(std::to_string(timestamp_ms));
-            decoded_frames_csv.field(std::to_string(entry.can_id));
-            decoded_frames_csv.field(std::string_view(entry.message_name.data(), strnlen(entry.message_name.data(), entry.message_name.size())));
-            decoded_frames_csv.field(std::string_view(entry.signal_name.data(), strnlen(entry.signal_name.data(), entry.signal_name.size())));
-            decoded_frames_csv.field(value_buf.data());
-            decoded_frames_csv.field(std::to_string(entry.raw_value));
-            decoded_frames_csv.field(std::string_view(entry.unit.data(), strnlen(entry.unit.data(), entry.unit.size())));
-            decoded_frames_csv.field(entry.mux_value ? std::to_string(*entry.mux_value) : "");
-            decoded_frames_csv.end_row();
-        }
+
+        wait_for_async_writer();
+        write_decoded_signals(decoded_signals_batch);
+        write_decoded_signals(decoded_fd_signals_batch);
 
         decoded_frames_csv.flush();
-        decoded_signals_batch.clear();
+        decoded_frames_index.flush();
         decoded_signals_batch_count = 0;
     }
 
     void CSVTranscoder::flush_all_batches() {
+        wait_for_async_writer();
         if (frames_batch_count > 0) flush_frames_batch();
         if (decoded_signals_batch_count > 0) flush_decoded_signals_batch();
         
@@ -244,18 +493,8 @@ namespace Candy {
         frames_csv.flush();
         decoded_frames_csv.flush();
         metadata_csv.flush();
-    }
-
-    std::string CSVTranscoder::format_hex_data(const uint8_t* data, size_t len) {
-        std::string result;
-        result.reserve(len * 3);
-        for (size_t i = 0; i < len; i++) {
-            std::array<char, 4> hex_buf;
-            std::snprintf(hex_buf.data(), hex_buf.size(), "%02X", static_cast<unsigned>(data[i]));
-            result += std::string(hex_buf.data());
-            if (i < len - 1) result += " ";
-        }
-        return result;
+        frames_index.flush();
+        decoded_frames_index.flush();
     }
 
     //CANIO
@@ -268,31 +507,40 @@ namespace Candy {
         
         // Write decoded signals if available
         if (!message.decoded_signals.empty()) {
+            wait_for_async_writer();
+            const long rows_begin = decoded_frames_csv.tell();
 
             for (size_t i = 0; i < message.signal_count && i < message.decoded_signals.size(); ++i) {
                 const auto& signal_entry = message.decoded_signals[i];
                 if (!signal_entry.is_valid) continue;
                 
-                std::string signal_name = std::string(signal_entry.get_name());
-                double signal_value = signal_entry.value;
-                std::string unit = std::string(signal_entry.get_unit());
-                
-                std::array<char, 32> value_buf;
-                snprintf(value_buf.data(), value_buf.size(), "%.6f", signal_value);
-                
                 decoded_frames_csv.start_row();
-                decoded_frames_csv.field(std::to_string(timestamp_ms));
-                decoded_frames_csv.field(std::to_string(message.sample.second.can_id));
+                decoded_frames_csv.field(timestamp_ms);
+                decoded_frames_csv.field(message.sample.second.can_id);
                 decoded_frames_csv.field(message.get_message_name());
-                decoded_frames_csv.field(signal_name);
-                decoded_frames_csv.field(std::string_view(value_buf.data()));
+                decoded_frames_csv.field(signal_entry.get_name());
+                decoded_frames_csv.field(signal_entry.value, 6);
                 decoded_frames_csv.field("0"); // raw_value not available
-                decoded_frames_csv.field(unit);
-                decoded_frames_csv.field(message.mux_value ? std::to_string(*message.mux_value) : "");
+                decoded_frames_csv.field(signal_entry.get_unit());
+                if (message.mux_value) decoded_frames_csv.field(*message.mux_value);
+                else decoded_frames_csv.field("");
                 decoded_frames_csv.end_row();
             }
             
+            const long rows_end = decoded_frames_csv.tell();
+            if (rows_begin >= 0 && rows_end > rows_begin) {
+                CSVIndexEntry entry {
+                    .offset = static_cast<uint64_t>(rows_begin),
+                    .length = static_cast<uint32_t>(rows_end - rows_begin),
+                    .can_id = message.sample.second.can_id,
+                    .first_ms = timestamp_ms,
+                    .last_ms = timestamp_ms
+                };
+                decoded_frames_index.append({ &entry, 1 });
+            }
+
             decoded_frames_csv.flush();
+            decoded_frames_index.flush();
         }
     }
 
@@ -317,9 +565,9 @@ namespace Candy {
         metadata_csv.start_row();
         metadata_csv.field(metadata.get_stream_name());
         metadata_csv.field(metadata.get_description());
-        metadata_csv.field(std::to_string(creation_ms));
-        metadata_csv.field(std::to_string(update_ms));
-        metadata_csv.field(std::to_string(metadata.total_messages));
+        metadata_csv.field(creation_ms);
+        metadata_csv.field(update_ms);
+        metadata_csv.field(metadata.total_messages);
         metadata_csv.field(names_str);
         metadata_csv.field(counts_str);
         metadata_csv.end_row();
@@ -332,57 +580,87 @@ namespace Candy {
             std::chrono::system_clock::time_point::max());
     }
 
+    template <typename Fn>
+    void CSVTranscoder::for_each_row(const std::string& path, canid_t can_id, int64_t start_ms, int64_t end_ms, Fn&& fn) {
+        FILE* file = fopen(path.c_str(), "r");
+        if (!file) return;
+
+        uint64_t file_size = 0;
+        if (fseeko(file, 0, SEEK_END) == 0) {
+            const off_t end = ftello(file);
+            if (end > 0) file_size = static_cast<uint64_t>(end);
+        }
+        rewind(file);
+
+        auto blocks = read_csv_index(path, file_size, can_id, start_ms, end_ms);
+        if (!blocks) {
+            // no usable sidecar index: scan every row
+            std::array<char, 2048> line_buf;
+            while (fgets(line_buf.data(), line_buf.size(), file)) {
+                std::string line(line_buf.data());
+                if (!line.empty() && line.back() == '\n') line.pop_back();
+                fn(line);
+            }
+            fclose(file);
+            return;
+        }
+
+        // blocks still hold rows of other ids and times, which fn filters out
+        std::string block;
+        uint64_t last_offset = UINT64_MAX;
+        for (const CSVIndexEntry& entry : *blocks) {
+            if (entry.offset == last_offset) continue;
+            last_offset = entry.offset;
+
+            block.resize(entry.length);
+            if (fseeko(file, static_cast<off_t>(entry.offset), SEEK_SET) != 0 ||
+                fread(block.data(), 1, block.size(), file) != block.size()) {
+                break;
+            }
+
+            size_t pos = 0;
+            while (pos < block.size()) {
+                size_t line_end = block.find('\n', pos);
+                if (line_end == std::string::npos) line_end = block.size();
+                fn(block.substr(pos, line_end - pos));
+                pos = line_end + 1;
+            }
+        }
+
+        fclose(file);
+    }
+
     std::vector<CANMessage> CSVTranscoder::transmit_messages_in_range(
         canid_t can_id, CANTime start, CANTime end) {
         
         std::vector<CANMessage> messages;
+        flush_all_batches();
         
         auto start_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
             start.time_since_epoch()).count();
         auto end_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
             end.time_since_epoch()).count();
         
-        // Read frames from CSV
-        std::string frames_path = base_path + "/frames.csv";
-        if (!std::filesystem::exists(frames_path)) {
-            return messages; // Return empty if file doesn't exist
-        }
-        
-        FILE* frames_file = fopen(frames_path.c_str(), "r");
-        if (!frames_file) {
-            return messages;
-        }
-        
-        // Skip header line
-        std::array<char, 2048> line_buf;
-        if (!fgets(line_buf.data(), line_buf.size(), frames_file)) {
-            fclose(frames_file);
-            return messages;
-        }
-        
         // Parse frames
         std::unordered_map<std::string, CANMessage> message_map; // timestamp+can_id -> message
         
-        while (fgets(line_buf.data(), line_buf.size(), frames_file)) {
-            std::string line(line_buf.data());
-            // Remove trailing newline
-            if (!line.empty() && line.back() == '\n') line.pop_back();
+        for_each_row(base_path + "/frames.csv", can_id, start_ms, end_ms, [&](std::string line) {
             if (!line.empty() && line.back() == '\r') line.pop_back();
             auto fields = parse_csv_line(line);
-            if (fields.size() < 5) continue;
-            
+            if (fields.size() < 5) return;
 
             auto timestamp_ms = std::stoll(fields[0]);
             auto frame_can_id = static_cast<canid_t>(std::stoul(fields[1]));
             
-            if (frame_can_id != can_id) continue;
-            if (timestamp_ms < start_ms || timestamp_ms > end_ms) continue;
+            if (frame_can_id != can_id) return;
+            if (timestamp_ms < start_ms || timestamp_ms > end_ms) return;
             
             CANMessage message;
             message.sample.first = std::chrono::system_clock::time_point(
                 std::chrono::milliseconds(timestamp_ms));
             message.sample.second.can_id = frame_can_id;
-            message.sample.second.len = static_cast<uint8_t>(std::stoi(fields[2]));
+            // CAN FD rows keep only their first 8 bytes in a CANMessage
+            message.sample.second.len = static_cast<uint8_t>(std::min(std::stoi(fields[2]), CAN_MAX_DLEN));
             
             parse_hex_data(fields[3], message.sample.second.data, message.sample.second.len);
             
@@ -390,51 +668,34 @@ namespace Candy {
             
             std::string key = std::to_string(timestamp_ms) + "_" + std::to_string(frame_can_id);
             message_map[key] = std::move(message);
-        }
-
-        fclose(frames_file);
+        });
         
         // Read decoded signals
-        std::string decoded_path = base_path + "/decoded_frames.csv";
-        if (std::filesystem::exists(decoded_path)) {
-            FILE* decoded_file = fopen(decoded_path.c_str(), "r");
-            if (decoded_file) {
-                // Skip header
-                std::array<char, 2048> line_buf;
-                if (fgets(line_buf.begin(), line_buf.size(), decoded_file)) {
-                while (fgets(line_buf.begin(), line_buf.size(), decoded_file)) {
-
-                    std::string line(line_buf.data());
-
-                    if (!line.empty() && line.back() == '\n') line.pop_back();
-                    if (!line.empty() && line.back() == '\r') line.pop_back();
-                    auto fields = parse_csv_line(line);
-                    if (fields.size() < 8) continue;
-                    
-                    auto timestamp_ms = std::stoll(fields[0]);
-                    auto frame_can_id = static_cast<canid_t>(std::stoul(fields[1]));
-                    
-                    if (frame_can_id != can_id) continue;
-                    if (timestamp_ms < start_ms || timestamp_ms > end_ms) continue;
-                    
-                    std::string key = std::to_string(timestamp_ms) + "_" + std::to_string(frame_can_id);
-                    auto it = message_map.find(key);
-                    if (it != message_map.end()) {
-                        std::string signal_name = fields[3];
-                        double signal_value = std::stod(fields[4]);
-                        std::string unit = fields[6];
-                        
-                        it->second.add_signal(signal_name, signal_value, unit);
-                        
-                        if (!fields[7].empty()) {
-                            it->second.mux_value = std::stoull(fields[7]);
-                        }
-                    }
+        for_each_row(base_path + "/decoded_frames.csv", can_id, start_ms, end_ms, [&](std::string line) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            auto fields = parse_csv_line(line);
+            if (fields.size() < 8) return;
+            
+            auto timestamp_ms = std::stoll(fields[0]);
+            auto frame_can_id = static_cast<canid_t>(std::stoul(fields[1]));
+            
+            if (frame_can_id != can_id) return;
+            if (timestamp_ms < start_ms || timestamp_ms > end_ms) return;
+            
+            std::string key = std::to_string(timestamp_ms) + "_" + std::to_string(frame_can_id);
+            auto it = message_map.find(key);
+            if (it != message_map.end()) {
+                std::string signal_name = fields[3];
+                double signal_value = std::stod(fields[4]);
+                std::string unit = fields[6];
+                
+                it->second.add_signal(signal_name, signal_value, unit);
+                
+                if (!fields[7].empty()) {
+                    it->second.mux_value = std::stoull(fields[7]);
                 }
             }
-                fclose(decoded_file);
-            }
-        }
+        });
         
         // Convert map to vector and sort by timestamp
         messages.reserve(message_map.size());
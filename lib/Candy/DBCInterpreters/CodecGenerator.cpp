@@ -0,0 +1,226 @@
+#include "Candy/DBCInterpreters/CodecGenerator.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <set>
+
+namespace Candy {
+
+	// names a DBC may use that can't be C++ identifiers
+	static const std::set<std::string> cpp_keywords = {
+		"alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case",
+		"catch", "char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "consteval",
+		"constexpr", "constinit", "const_cast", "continue", "co_await", "co_return", "co_yield", "decltype",
+		"default", "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern",
+		"false", "float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new",
+		"noexcept", "not", "not_eq", "nullptr", "operator", "or", "or_eq", "private", "protected", "public",
+		"register", "reinterpret_cast", "requires", "return", "short", "signed", "sizeof", "static",
+		"static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local", "throw",
+		"true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void",
+		"volatile", "wchar_t", "while", "xor", "xor_eq"
+	};
+
+	static std::string identifier(const std::string& name) {
+		std::string id;
+		id.reserve(name.size() + 1);
+		for (unsigned char c : name)
+			id += std::isalnum(c) ? static_cast<char>(c) : '_';
+		if (id.empty() || std::isdigit(static_cast<unsigned char>(id.front())))
+			id.insert(id.begin(), '_');
+		if (cpp_keywords.contains(id))
+			id += '_';
+		return id;
+	}
+
+	// suffixes a name whose identifier is already taken in the same scope,
+	// e.g. A-B after A_B
+	static std::string unique_identifier(const std::string& name, std::set<std::string>& used, const std::string& suffix) {
+		std::string id = identifier(name);
+		if (used.insert(id).second)
+			return id;
+
+		std::string unique = id + "_" + suffix;
+		for (int n = 2; !used.insert(unique).second; ++n)
+			unique = id + "_" + suffix + "_" + std::to_string(n);
+		return unique;
+	}
+
+	static std::string quoted(const std::string& str) {
+		std::string out = "\"";
+		for (char c : str) {
+			if (c == '"' || c == '\\')
+				out += '\\';
+			out += c;
+		}
+		return out + "\"";
+	}
+
+	static const char* value_type_name(NumericValueType type) {
+		switch (type) {
+			case NumericValueType::i64: return "i64";
+			case NumericValueType::u64: return "u64";
+			case NumericValueType::f32: return "f32";
+			default: return "f64";
+		}
+	}
+
+	template <typename... Args>
+	static void append(std::string& out, const char* fmt, Args... args) {
+		int n = std::snprintf(nullptr, 0, fmt, args...);
+		if (n <= 0)
+			return;
+		size_t at = out.size();
+		out.resize(at + n + 1);
+		std::snprintf(out.data() + at, n + 1, fmt, args...);
+		out.resize(at + n);
+	}
+
+	void CodecGenerator::sg(uint32_t message_id, std::optional<unsigned> sg_mux_switch_val, const std::string& sg_name,
+		unsigned sg_start_bit, unsigned sg_size, char sg_byte_order, char sg_sign,
+		double sg_factor, double sg_offset, double, double,
+		const std::string& sg_unit, const std::vector<size_t>&)
+	{
+		_msgs[message_id].signals.push_back(GenSignal{
+			sg_name, sg_start_bit, sg_size, sg_byte_order, sg_sign, sg_factor, sg_offset, sg_unit,
+			sg_mux_switch_val, sg_sign == '-' ? NumericValueType::i64 : NumericValueType::u64
+		});
+	}
+
+	void CodecGenerator::sg_mux(uint32_t message_id, const std::string& sg_name, unsigned sg_start_bit, unsigned sg_size,
+		char sg_byte_order, char sg_sign, const std::string& sg_unit, const std::vector<size_t>&)
+	{
+		_msgs[message_id].multiplexer = GenSignal{
+			sg_name, sg_start_bit, sg_size, sg_byte_order, sg_sign, 1.0, 0.0, sg_unit,
+			std::nullopt, NumericValueType::u64
+		};
+	}
+
+	void CodecGenerator::bo(uint32_t message_id, const std::string& msg_name, size_t msg_size, size_t) {
+		_msgs[message_id].name = msg_name;
+		_msgs[message_id].size = msg_size;
+	}
+
+	void CodecGenerator::sig_valtype(unsigned message_id, const std::string& sig_name, unsigned sig_ext_val_type) {
+		auto msg_it = _msgs.find(message_id);
+		if (msg_it == _msgs.end())
+			return;
+
+		for (auto& sig : msg_it->second.signals) {
+			if (sig.name != sig_name)
+				continue;
+			// SIG_VALTYPE_ 1 is IEEE float, 2 is IEEE double
+			if (sig_ext_val_type == 1)
+				sig.value_type = NumericValueType::f32;
+			else if (sig_ext_val_type == 2)
+				sig.value_type = NumericValueType::f64;
+			break;
+		}
+	}
+
+	static void append_signal(std::string& out, const char* indent, const std::string& id, const auto& sig) {
+		append(out, "%sinline constexpr StaticSignal<StaticSignalCodec<%u, %u, '%c', '%c'>, NumericValueType::%s> %s {\n",
+			indent, sig.start_bit, sig.size, sig.byte_order, sig.sign, value_type_name(sig.value_type), id.c_str());
+		append(out, "%s    { %s, %s, %.17g, %.17g }\n", indent, quoted(sig.name).c_str(), quoted(sig.unit).c_str(), sig.factor, sig.offset);
+		append(out, "%s};\n", indent);
+	}
+
+	std::string CodecGenerator::generate(const std::string& name_space, const std::string& source_name) const {
+		std::string out;
+		out.reserve(4096 + _msgs.size() * 1024);
+
+		append(out, "// Generated by candy_codegen from %s. Do not edit.\n", source_name.c_str());
+		out += "#pragma once\n\n";
+		out += "#include <cstddef>\n#include <cstdint>\n#include <string_view>\n\n";
+		out += "#include \"Candy/Core/CANKernelTypes.hpp\"\n";
+		out += "#include \"Candy/Core/Signal/StaticSignalCodec.hpp\"\n\n";
+		append(out, "namespace %s {\n\n", name_space.c_str());
+		out += "    using Candy::NumericValueType;\n";
+		out += "    using Candy::StaticSignal;\n";
+		out += "    using Candy::StaticSignalCodec;\n";
+		out += "    using Candy::StaticSignalInfo;\n\n";
+
+		std::set<std::string> used_ids;
+		std::map<uint32_t, std::string> msg_ids;
+		std::map<uint32_t, std::vector<std::string>> sig_ids;
+		for (const auto& [can_id, msg] : _msgs) {
+			msg_ids[can_id] = unique_identifier(msg.name, used_ids, std::to_string(can_id));
+
+			// each message's signals share one namespace
+			std::set<std::string> used_sig_ids;
+			for (size_t i = 0; i < msg.signals.size(); ++i)
+				sig_ids[can_id].push_back(unique_identifier(msg.signals[i].name, used_sig_ids, std::to_string(i)));
+		}
+
+		out += "    namespace messages {\n\n";
+		for (const auto& [can_id, msg] : _msgs) {
+			append(out, "        // BO_ %u %s\n", can_id, msg.name.c_str());
+			append(out, "        namespace %s {\n", msg_ids[can_id].c_str());
+			append(out, "            inline constexpr canid_t id = 0x%Xu;\n", can_id);
+			append(out, "            inline constexpr size_t size = %zu;\n", msg.size);
+			append(out, "            inline constexpr std::string_view name = %s;\n\n", quoted(msg.name).c_str());
+
+			if (msg.multiplexer)
+				append_signal(out, "            ", "multiplexer", *msg.multiplexer);
+
+			out += "            namespace signals {\n";
+			for (size_t i = 0; i < msg.signals.size(); ++i)
+				append_signal(out, "                ", sig_ids[can_id][i], msg.signals[i]);
+			out += "            }\n";
+			out += "        }\n\n";
+		}
+		out += "    }\n\n";
+
+		out += "    inline constexpr canid_t message_ids[] = {";
+		for (const auto& [can_id, msg] : _msgs)
+			append(out, " 0x%Xu,", can_id);
+		out += " };\n\n";
+
+		out += "    constexpr std::string_view message_name(canid_t can_id) {\n";
+		out += "        switch (can_id) {\n";
+		for (const auto& [can_id, msg] : _msgs)
+			append(out, "            case messages::%s::id: return messages::%s::name;\n", msg_ids[can_id].c_str(), msg_ids[can_id].c_str());
+		out += "            default: return {};\n";
+		out += "        }\n";
+		out += "    }\n\n";
+
+		out += "    // Calls fn(const StaticSignalInfo&, uint64_t raw, double value) for every\n";
+		out += "    // signal of can_id's message that is active in this payload.\n";
+		out += "    // Returns false if can_id is not in the DBC.\n";
+		out += "    template <typename Fn>\n";
+		out += "    inline bool decode(canid_t can_id, const uint8_t* data, Fn&& fn) {\n";
+		out += "        switch (can_id) {\n";
+		for (const auto& [can_id, msg] : _msgs) {
+			const std::string& ns = msg_ids[can_id];
+			append(out, "            case messages::%s::id: {\n", ns.c_str());
+			append(out, "                namespace msg = messages::%s;\n", ns.c_str());
+			if (msg.multiplexer && std::any_of(msg.signals.begin(), msg.signals.end(), [](const auto& s) { return s.mux_val.has_value(); }))
+				out += "                const uint64_t mux = msg::multiplexer.raw(data);\n";
+
+			for (size_t i = 0; i < msg.signals.size(); ++i) {
+				const auto& sig = msg.signals[i];
+				std::string sig_ref = "msg::signals::" + sig_ids[can_id][i];
+				if (!sig.mux_val)
+					out += "                {\n";
+				else if (msg.multiplexer)
+					append(out, "                if (mux == %uu) {\n", *sig.mux_val);
+				else
+					continue;
+
+				append(out, "                    const uint64_t raw = %s.raw(data);\n", sig_ref.c_str());
+				append(out, "                    fn(static_cast<const StaticSignalInfo&>(%s), raw, %s.value(raw));\n",
+					sig_ref.c_str(), sig_ref.c_str());
+				out += "                }\n";
+			}
+			out += "                return true;\n";
+			out += "            }\n";
+		}
+		out += "            default: return false;\n";
+		out += "        }\n";
+		out += "    }\n\n";
+
+		append(out, "}\n");
+		return out;
+	}
+
+}
@@ -0,0 +1,719 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "Candy/DBCInterpreters/ColumnarTranscoder.hpp"
+
+namespace {
+
+    constexpr char session_magic[8] = { 'C', 'A', 'N', 'D', 'Y', 'C', 'O', 'L' };
+    constexpr uint32_t session_version = 1;
+    // footer offset + magic
+    constexpr size_t trailer_size = 16;
+
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    template <typename T>
+    void put_pod(std::vector<uint8_t>& out, const T& value) {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    void put_string(std::vector<uint8_t>& out, std::string_view value) {
+        put_varint(out, value.size());
+        out.insert(out.end(), value.begin(), value.end());
+    }
+
+    // delta of delta, so periodic messages cost about a byte per row
+    void put_times(std::vector<uint8_t>& out, std::span<const int64_t> times) {
+        uint64_t prev = 0;
+        uint64_t prev_delta = 0;
+        for (size_t i = 0; i < times.size(); ++i) {
+            uint64_t delta = static_cast<uint64_t>(times[i]) - prev;
+            put_varint(out, zigzag(static_cast<int64_t>(delta - prev_delta)));
+            prev_delta = i == 0 ? 0 : delta;
+            prev = static_cast<uint64_t>(times[i]);
+        }
+    }
+
+    void put_values(std::vector<uint8_t>& out, std::span<const uint64_t> raw, bool xor_float) {
+        uint64_t prev = 0;
+        for (uint64_t value : raw) {
+            if (xor_float) {
+                // neighbouring floats share sign, exponent and high mantissa bits
+                uint64_t bits = value ^ prev;
+                if (bits == 0) {
+                    out.push_back(0);
+                } else {
+                    int trailing = std::countr_zero(bits);
+                    out.push_back(static_cast<uint8_t>(trailing + 1));
+                    put_varint(out, bits >> trailing);
+                }
+            } else {
+                put_varint(out, zigzag(static_cast<int64_t>(value - prev)));
+            }
+            prev = value;
+        }
+    }
+
+    struct ByteReader {
+        const uint8_t* pos;
+        const uint8_t* end;
+        bool ok = true;
+
+        uint8_t byte() {
+            if (pos >= end) { ok = false; return 0; }
+            return *pos++;
+        }
+
+        uint64_t varint() {
+            uint64_t value = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7) {
+                uint8_t b = byte();
+                value |= static_cast<uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80)) return value;
+            }
+            ok = false;
+            return 0;
+        }
+
+        template <typename T>
+        T pod() {
+            T value {};
+            if (static_cast<size_t>(end - pos) < sizeof(T)) { ok = false; return value; }
+            std::memcpy(&value, pos, sizeof(T));
+            pos += sizeof(T);
+            return value;
+        }
+
+        std::string_view bytes(size_t count) {
+            if (static_cast<size_t>(end - pos) < count) { ok = false; return {}; }
+            std::string_view value(reinterpret_cast<const char*>(pos), count);
+            pos += count;
+            return value;
+        }
+
+        std::string_view string() { return bytes(varint()); }
+    };
+
+    void get_times(ByteReader& in, size_t rows, std::vector<int64_t>& out) {
+        out.resize(rows);
+        uint64_t prev = 0;
+        uint64_t prev_delta = 0;
+        for (size_t i = 0; i < rows; ++i) {
+            uint64_t delta = prev_delta + static_cast<uint64_t>(unzigzag(in.varint()));
+            prev += delta;
+            prev_delta = i == 0 ? 0 : delta;
+            out[i] = static_cast<int64_t>(prev);
+        }
+    }
+
+    void get_values(ByteReader& in, size_t rows, bool xor_float, std::vector<uint64_t>& out) {
+        out.resize(rows);
+        uint64_t prev = 0;
+        for (size_t i = 0; i < rows; ++i) {
+            if (xor_float) {
+                uint8_t trailing = in.byte();
+                if (trailing > 0) prev ^= in.varint() << (trailing - 1);
+            } else {
+                prev += static_cast<uint64_t>(unzigzag(in.varint()));
+            }
+            out[i] = prev;
+        }
+    }
+
+}
+
+namespace Candy {
+
+    ColumnarTranscoder::ColumnarTranscoder(FILE* file, std::string path, size_t batch_size, bool writable) :
+        FileTranscoder<ColumnarTranscoder>(batch_size, 0, 0),
+        file(file, fclose),
+        path(std::move(path)),
+        writable(writable)
+    {
+        if (writable) frames_batch.reserve(batch_size);
+    }
+
+    ColumnarTranscoder::~ColumnarTranscoder() {
+        if (!file || !writable) return;
+        flush_all_batches();
+        write_footer();
+    }
+
+    ColumnarTranscoder::ColumnarTranscoder(ColumnarTranscoder&& other) noexcept :
+        FileTranscoder<ColumnarTranscoder>(std::move(other)),
+        file(std::move(other.file)),
+        path(std::move(other.path)),
+        writable(other.writable),
+        file_end(other.file_end),
+        session_messages(std::move(other.session_messages)),
+        session_signals(std::move(other.session_signals)),
+        session_chunks(std::move(other.session_chunks)),
+        frames_batch(std::move(other.frames_batch)),
+        decoded_columns(std::move(other.decoded_columns))
+    {
+    }
+
+    ColumnarTranscoder& ColumnarTranscoder::operator=(ColumnarTranscoder&& other) noexcept {
+        if (this != &other) {
+            if (file && writable) {
+                flush_all_batches();
+                write_footer();
+            }
+
+            FileTranscoder<ColumnarTranscoder>::operator=(std::move(other));
+            file = std::move(other.file);
+            path = std::move(other.path);
+            writable = other.writable;
+            file_end = other.file_end;
+            session_messages = std::move(other.session_messages);
+            session_signals = std::move(other.session_signals);
+            session_chunks = std::move(other.session_chunks);
+            frames_batch = std::move(other.frames_batch);
+            decoded_columns = std::move(other.decoded_columns);
+        }
+        return *this;
+    }
+
+    std::optional<ColumnarTranscoder> ColumnarTranscoder::create(const std::string& path, size_t batch_size) {
+        FILE* file = fopen(path.c_str(), "w+b");
+        if (!file) {
+            std::cerr << "Failed to create columnar session: " << path << std::endl;
+            return std::nullopt;
+        }
+
+        if (fwrite(session_magic, 1, sizeof(session_magic), file) != sizeof(session_magic) ||
+            fwrite(&session_version, sizeof(session_version), 1, file) != 1) {
+            fclose(file);
+            std::cerr << "Failed to write columnar session header: " << path << std::endl;
+            return std::nullopt;
+        }
+
+        ColumnarTranscoder transcoder(file, path, batch_size, true);
+        transcoder.file_end = sizeof(session_magic) + sizeof(session_version);
+        return std::make_optional<ColumnarTranscoder>(std::move(transcoder));
+    }
+
+    std::optional<ColumnarTranscoder> ColumnarTranscoder::open(const std::string& path) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            std::cerr << "Failed to open columnar session: " << path << std::endl;
+            return std::nullopt;
+        }
+
+        ColumnarTranscoder transcoder(file, path, 0, false);
+        if (!transcoder.load_footer()) {
+            std::cerr << "Columnar session has no valid footer (not closed?): " << path << std::endl;
+            return std::nullopt;
+        }
+        return std::make_optional<ColumnarTranscoder>(std::move(transcoder));
+    }
+
+    // CANIO
+    void ColumnarTranscoder::receive_raw_message(std::pair<CANTime, CANFrame> sample) {
+        if (!writable) return;
+
+        batch_frame(sample);
+        if (auto slot = decode_table.find(sample.second.can_id))
+            batch_decoded_signals(sample, decode_table.message(*slot));
+
+        if (frames_batch_count >= batch_size) write_batch();
+    }
+
+    void ColumnarTranscoder::receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample) {
+        if (!writable) return;
+
+        clear_padding(sample.second);
+        batch_frame(sample);
+        if (auto slot = decode_table.find(sample.second.can_id))
+            batch_decoded_signals(sample, decode_table.message(*slot));
+
+        if (frames_batch_count >= batch_size) write_batch();
+    }
+
+    // signals are decoded from the frame again, so values for ids outside the DBC are not kept
+    void ColumnarTranscoder::receive_message(const CANMessage& message) {
+        receive_raw_message(message.sample);
+    }
+
+    void ColumnarTranscoder::receive_metadata(const CANDataStreamMetadata& stream_metadata) {
+        if (!writable) return;
+        metadata = stream_metadata;
+    }
+
+    void ColumnarTranscoder::store_message_metadata(canid_t message_id, const std::string& message_name, size_t message_size) {
+        for (auto& message : session_messages) {
+            if (message.can_id != message_id) continue;
+            message.size = message_size;
+            message.name = message_name;
+            return;
+        }
+        session_messages.push_back({ message_id, message_size, message_name });
+    }
+
+    // transcoder methods
+    void ColumnarTranscoder::batch_frame(std::pair<CANTime, CANFrame> sample) {
+        frames_batch.emplace_back(sample.first, widen_frame(sample.second));
+        frames_batch_count++;
+    }
+
+    void ColumnarTranscoder::batch_frame(const std::pair<CANTime, CANFlexibleFrame>& sample) {
+        frames_batch.push_back(sample);
+        frames_batch_count++;
+    }
+
+    // decoding happens per column when the batch is written
+    void ColumnarTranscoder::batch_decoded_signals(std::pair<CANTime, CANFrame>, const DecodeMessage&) {
+        decoded_signals_batch_count++;
+    }
+
+    void ColumnarTranscoder::batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>&, const DecodeMessage&) {
+        decoded_signals_batch_count++;
+    }
+
+    void ColumnarTranscoder::flush_frames_batch() {
+        write_batch();
+    }
+
+    void ColumnarTranscoder::flush_decoded_signals_batch() {
+        write_batch();
+    }
+
+    void ColumnarTranscoder::flush_all_batches() {
+        write_batch();
+        if (file && writable) fflush(file.get());
+    }
+
+    void ColumnarTranscoder::store_signals() {
+        if (!session_signals.empty()) return;
+
+        for (uint32_t slot = 0; slot < decode_table.message_count(); ++slot) {
+            const DecodeMessage& msg = decode_table.message(slot);
+            for (uint32_t sig = msg.first_signal; sig < msg.first_signal + msg.signal_count; ++sig) {
+                NumericValueType type = decode_table.value_type(sig);
+                int bits = std::popcount(decode_table.layout(sig).mask);
+                bool is_float = (type == NumericValueType::f32 && bits == 32) ||
+                                (type == NumericValueType::f64 && bits == 64);
+
+                session_signals.push_back({
+                    .id = sig,
+                    .can_id = decode_table.ids()[slot],
+                    .mux_val = decode_table.mux_val(sig),
+                    .factor = decode_table.factor(sig),
+                    .offset = decode_table.offset(sig),
+                    .value_type = type,
+                    .encoding = is_float ? ValueEncoding::xor_float : ValueEncoding::delta,
+                    .name = std::string(decode_table.signal_name(sig)),
+                    .unit = std::string(decode_table.unit(sig))
+                });
+            }
+        }
+
+        std::sort(session_signals.begin(), session_signals.end(), [](const SessionSignal& a, const SessionSignal& b) {
+            return a.id < b.id;
+        });
+    }
+
+    void ColumnarTranscoder::append_chunk(canid_t can_id, uint32_t column) {
+        if (chunk_times.empty()) return;
+
+        if (fwrite(chunk_buffer.data(), 1, chunk_buffer.size(), file.get()) != chunk_buffer.size()) {
+            std::cerr << "Failed to write column chunk to " << path << std::endl;
+            return;
+        }
+
+        auto [first, last] = std::minmax_element(chunk_times.begin(), chunk_times.end());
+        session_chunks.push_back({
+            .offset = file_end,
+            .length = static_cast<uint32_t>(chunk_buffer.size()),
+            .rows = static_cast<uint32_t>(chunk_times.size()),
+            .can_id = can_id,
+            .column = column,
+            .first_time = *first,
+            .last_time = *last
+        });
+        file_end += chunk_buffer.size();
+    }
+
+    void ColumnarTranscoder::write_batch() {
+        if (frames_batch.empty() || !file || !writable) return;
+
+        store_signals();
+
+        // one run per id; arrival order is kept within a run
+        std::stable_sort(frames_batch.begin(), frames_batch.end(), [](const auto& a, const auto& b) {
+            return a.second.can_id < b.second.can_id;
+        });
+
+        auto run_begin = frames_batch.begin();
+        while (run_begin != frames_batch.end()) {
+            canid_t can_id = run_begin->second.can_id;
+            auto run_end = std::find_if(run_begin, frames_batch.end(), [can_id](const auto& s) {
+                return s.second.can_id != can_id;
+            });
+            std::span<const std::pair<CANTime, CANFlexibleFrame>> run(&*run_begin, run_end - run_begin);
+
+            chunk_times.resize(run.size());
+            for (size_t row = 0; row < run.size(); ++row)
+                chunk_times[row] = run[row].first.time_since_epoch().count();
+
+            chunk_buffer.clear();
+            put_times(chunk_buffer, chunk_times);
+            for (const auto& [timestamp, frame] : run) {
+                uint8_t length = std::min<uint8_t>(frame.length, CANFD_MAX_DLEN);
+                chunk_buffer.push_back(length);
+                chunk_buffer.push_back(frame.flags);
+                chunk_buffer.insert(chunk_buffer.end(), frame.data, frame.data + length);
+            }
+            append_chunk(can_id, ColumnChunk::frames_column);
+
+            if (auto slot = decode_table.find(can_id)) {
+                decoded_columns.decode(decode_table, *slot, run);
+                const bool has_mux = decode_table.message(*slot).has_mux;
+
+                if (has_mux) {
+                    chunk_raw.resize(run.size());
+                    for (size_t row = 0; row < run.size(); ++row)
+                        chunk_raw[row] = *decoded_columns.mux(row);
+
+                    chunk_buffer.clear();
+                    put_times(chunk_buffer, chunk_times);
+                    put_values(chunk_buffer, chunk_raw, false);
+                    append_chunk(can_id, ColumnChunk::mux_column);
+                }
+
+                for (size_t col = 0; col < decoded_columns.columns(); ++col) {
+                    const uint32_t signal = decoded_columns.signal(col);
+                    const SessionSignal* info = find_signal(signal);
+                    std::span<const uint64_t> raw = decoded_columns.raw(col);
+
+                    // multiplexed signals only keep the rows where they are present
+                    chunk_times.clear();
+                    chunk_raw.clear();
+                    for (size_t row = 0; row < run.size(); ++row) {
+                        if (!decode_table.is_active(signal, decoded_columns.mux(row))) continue;
+                        chunk_times.push_back(run[row].first.time_since_epoch().count());
+                        chunk_raw.push_back(raw[row]);
+                    }
+
+                    chunk_buffer.clear();
+                    put_times(chunk_buffer, chunk_times);
+                    put_values(chunk_buffer, chunk_raw, info && info->encoding == ValueEncoding::xor_float);
+                    append_chunk(can_id, signal);
+                }
+            }
+
+            run_begin = run_end;
+        }
+
+        frames_batch.clear();
+        frames_batch_count = 0;
+        decoded_signals_batch_count = 0;
+    }
+
+    const ColumnarTranscoder::SessionSignal* ColumnarTranscoder::find_signal(uint32_t id) const {
+        // session_signals is in id order
+        auto it = std::lower_bound(session_signals.begin(), session_signals.end(), id,
+                                   [](const SessionSignal& s, uint32_t value) { return s.id < value; });
+        return it != session_signals.end() && it->id == id ? &*it : nullptr;
+    }
+
+    std::string_view ColumnarTranscoder::find_message_name(canid_t can_id) const {
+        for (const auto& message : session_messages) {
+            if (message.can_id == can_id) return message.name;
+        }
+        return "";
+    }
+
+    // footer
+
+    void ColumnarTranscoder::write_footer() {
+        std::vector<uint8_t> footer;
+
+        put_varint(footer, session_messages.size());
+        for (const auto& message : session_messages) {
+            put_pod(footer, message.can_id);
+            put_varint(footer, message.size);
+            put_string(footer, message.name);
+        }
+
+        put_varint(footer, session_signals.size());
+        for (const auto& signal : session_signals) {
+            put_pod(footer, signal.id);
+            put_pod(footer, signal.can_id);
+            put_varint(footer, signal.mux_val ? *signal.mux_val + 1 : 0);
+            put_pod(footer, signal.factor);
+            put_pod(footer, signal.offset);
+            footer.push_back(static_cast<uint8_t>(signal.value_type));
+            footer.push_back(static_cast<uint8_t>(signal.encoding));
+            put_string(footer, signal.name);
+            put_string(footer, signal.unit);
+        }
+
+        put_string(footer, metadata.get_stream_name());
+        put_string(footer, metadata.get_description());
+        put_pod(footer, static_cast<int64_t>(metadata.creation_time.time_since_epoch().count()));
+        put_pod(footer, static_cast<int64_t>(metadata.last_update.time_since_epoch().count()));
+        put_varint(footer, metadata.total_messages);
+        put_varint(footer, metadata.message_count);
+        for (size_t i = 0; i < metadata.message_count && i < metadata.messages.size(); ++i) {
+            const auto& entry = metadata.messages[i];
+            put_pod(footer, entry.can_id);
+            put_string(footer, entry.get_name());
+            put_varint(footer, entry.count);
+        }
+
+        put_varint(footer, session_chunks.size());
+        for (const auto& chunk : session_chunks)
+            put_pod(footer, chunk);
+
+        put_pod(footer, file_end);
+        footer.insert(footer.end(), std::begin(session_magic), std::end(session_magic));
+
+        if (fwrite(footer.data(), 1, footer.size(), file.get()) != footer.size() || fflush(file.get()) != 0)
+            std::cerr << "Failed to write columnar session footer to " << path << std::endl;
+    }
+
+    bool ColumnarTranscoder::load_footer() {
+        FILE* f = file.get();
+        std::array<uint8_t, trailer_size> trailer;
+        if (fseeko(f, -static_cast<off_t>(trailer_size), SEEK_END) != 0 ||
+            fread(trailer.data(), 1, trailer.size(), f) != trailer.size() ||
+            std::memcmp(trailer.data() + 8, session_magic, sizeof(session_magic)) != 0) {
+            return false;
+        }
+
+        const off_t trailer_offset = ftello(f) - static_cast<off_t>(trailer_size);
+        uint64_t footer_offset;
+        std::memcpy(&footer_offset, trailer.data(), sizeof(footer_offset));
+        if (footer_offset > static_cast<uint64_t>(trailer_offset)) return false;
+
+        std::vector<uint8_t> footer(static_cast<uint64_t>(trailer_offset) - footer_offset);
+        if (pread(fileno(f), footer.data(), footer.size(), static_cast<off_t>(footer_offset)) !=
+            static_cast<ssize_t>(footer.size())) {
+            return false;
+        }
+
+        ByteReader in { footer.data(), footer.data() + footer.size() };
+
+        size_t message_count = in.varint();
+        for (size_t i = 0; i < message_count && in.ok; ++i) {
+            SessionMessage message;
+            message.can_id = in.pod<canid_t>();
+            message.size = in.varint();
+            message.name = in.string();
+            session_messages.push_back(std::move(message));
+        }
+
+        size_t signal_count = in.varint();
+        for (size_t i = 0; i < signal_count && in.ok; ++i) {
+            SessionSignal signal;
+            signal.id = in.pod<uint32_t>();
+            signal.can_id = in.pod<canid_t>();
+            uint64_t mux_val = in.varint();
+            if (mux_val > 0) signal.mux_val = mux_val - 1;
+            signal.factor = in.pod<double>();
+            signal.offset = in.pod<double>();
+            signal.value_type = static_cast<NumericValueType>(in.byte());
+            signal.encoding = static_cast<ValueEncoding>(in.byte());
+            signal.name = in.string();
+            signal.unit = in.string();
+            session_signals.push_back(std::move(signal));
+        }
+
+        metadata.set_stream_name(in.string());
+        metadata.set_description(in.string());
+        metadata.creation_time = CANTime(CANTime::duration(in.pod<int64_t>()));
+        metadata.last_update = CANTime(CANTime::duration(in.pod<int64_t>()));
+        metadata.total_messages = in.varint();
+        size_t entry_count = in.varint();
+        for (size_t i = 0; i < entry_count && in.ok; ++i) {
+            canid_t can_id = in.pod<canid_t>();
+            std::string_view name = in.string();
+            metadata.add_message(can_id, name, in.varint());
+        }
+
+        size_t chunk_count = in.varint();
+        if (!in.ok || chunk_count > footer.size() / sizeof(ColumnChunk)) return false;
+        session_chunks.resize(chunk_count);
+        for (auto& chunk : session_chunks)
+            chunk = in.pod<ColumnChunk>();
+
+        file_end = footer_offset;
+        return in.ok;
+    }
+
+    bool ColumnarTranscoder::read_chunk(const ColumnChunk& chunk, std::vector<uint8_t>& out) {
+        out.resize(chunk.length);
+        return pread(fileno(file.get()), out.data(), out.size(), static_cast<off_t>(chunk.offset)) ==
+               static_cast<ssize_t>(out.size());
+    }
+
+    // readback
+
+    std::vector<CANMessage> ColumnarTranscoder::transmit_messages(canid_t can_id) {
+        return transmit_messages_in_range(can_id, CANTime::min(), CANTime::max());
+    }
+
+    std::vector<CANMessage> ColumnarTranscoder::transmit_messages_in_range(canid_t can_id, CANTime start, CANTime end) {
+        flush_all_batches();
+
+        const int64_t start_time = start.time_since_epoch().count();
+        const int64_t end_time = end.time_since_epoch().count();
+        std::string_view message_name = find_message_name(can_id);
+
+        std::vector<CANMessage> messages;
+        std::vector<CANMessage> block;
+        std::vector<uint64_t> block_mux;
+        std::vector<uint8_t> bytes;
+        std::vector<int64_t> times;
+        std::vector<uint64_t> raw;
+        std::vector<double> values;
+
+        for (size_t i = 0; i < session_chunks.size(); ++i) {
+            const ColumnChunk& frames = session_chunks[i];
+            if (frames.can_id != can_id || frames.column != ColumnChunk::frames_column) continue;
+            if (frames.last_time < start_time || frames.first_time > end_time) continue;
+            if (!read_chunk(frames, bytes)) break;
+
+            ByteReader in { bytes.data(), bytes.data() + bytes.size() };
+            get_times(in, frames.rows, times);
+            block.assign(frames.rows, CANMessage());
+            for (size_t row = 0; row < frames.rows && in.ok; ++row) {
+                CANFlexibleFrame frame {};
+                frame.can_id = can_id;
+                frame.length = std::min<uint8_t>(in.byte(), CANFD_MAX_DLEN);
+                frame.flags = in.byte();
+                std::string_view payload = in.bytes(frame.length);
+                std::memcpy(frame.data, payload.data(), payload.size());
+
+                CANMessage& message = block[row];
+                // CAN FD rows keep only their first 8 bytes in a CANMessage
+                message.sample = { CANTime(CANTime::duration(times[row])), narrow_frame(frame) };
+                message.set_message_name(message_name);
+            }
+            if (!in.ok) break;
+
+            // the mux and signal chunks of this block follow its frames chunk
+            size_t j = i + 1;
+            bool has_mux = false;
+            if (j < session_chunks.size() && session_chunks[j].can_id == can_id &&
+                session_chunks[j].column == ColumnChunk::mux_column) {
+                const ColumnChunk& mux = session_chunks[j++];
+                if (!read_chunk(mux, bytes)) break;
+                ByteReader mux_in { bytes.data(), bytes.data() + bytes.size() };
+                get_times(mux_in, mux.rows, times);
+                get_values(mux_in, mux.rows, false, block_mux);
+                has_mux = mux_in.ok && mux.rows == frames.rows;
+                for (size_t row = 0; has_mux && row < block.size(); ++row)
+                    block[row].mux_value = block_mux[row];
+            }
+
+            for (; j < session_chunks.size(); ++j) {
+                const ColumnChunk& chunk = session_chunks[j];
+                if (chunk.can_id != can_id || chunk.column >= ColumnChunk::mux_column) break;
+
+                const SessionSignal* signal = find_signal(chunk.column);
+                if (!signal || !read_chunk(chunk, bytes)) continue;
+
+                ByteReader signal_in { bytes.data(), bytes.data() + bytes.size() };
+                get_times(signal_in, chunk.rows, times);
+                get_values(signal_in, chunk.rows, signal->encoding == ValueEncoding::xor_float, raw);
+                if (!signal_in.ok) continue;
+
+                values.resize(raw.size());
+                NumericValue(signal->factor, signal->offset).convert(raw, signal->value_type, values.data());
+
+                // the chunk holds exactly the block's rows where the signal is present, in order
+                size_t row = 0;
+                for (size_t k = 0; k < chunk.rows; ++k, ++row) {
+                    while (row < block.size() && signal->mux_val &&
+                           !(has_mux && block_mux[row] == *signal->mux_val)) {
+                        ++row;
+                    }
+                    if (row >= block.size()) break;
+                    block[row].add_signal(signal->name, values[k], signal->unit);
+                }
+            }
+
+            for (auto& message : block) {
+                int64_t time = message.sample.first.time_since_epoch().count();
+                if (time >= start_time && time <= end_time)
+                    messages.push_back(std::move(message));
+            }
+            i = j - 1;
+        }
+
+        std::stable_sort(messages.begin(), messages.end(), [](const CANMessage& a, const CANMessage& b) {
+            return a.sample.first < b.sample.first;
+        });
+        return messages;
+    }
+
+    std::vector<std::pair<CANTime, double>> ColumnarTranscoder::transmit_signal(canid_t can_id, std::string_view signal_name,
+                                                                                CANTime start, CANTime end) {
+        std::vector<std::pair<CANTime, double>> samples;
+        flush_all_batches();
+
+        auto signal = std::find_if(session_signals.begin(), session_signals.end(), [&](const SessionSignal& s) {
+            return s.can_id == can_id && s.name == signal_name;
+        });
+        if (signal == session_signals.end()) return samples;
+
+        const int64_t start_time = start.time_since_epoch().count();
+        const int64_t end_time = end.time_since_epoch().count();
+        const NumericValue numeric(signal->factor, signal->offset);
+
+        std::vector<uint8_t> bytes;
+        std::vector<int64_t> times;
+        std::vector<uint64_t> raw;
+        std::vector<double> values;
+
+        for (const ColumnChunk& chunk : session_chunks) {
+            if (chunk.column != signal->id || chunk.can_id != can_id) continue;
+            if (chunk.last_time < start_time || chunk.first_time > end_time) continue;
+            if (!read_chunk(chunk, bytes)) break;
+
+            ByteReader in { bytes.data(), bytes.data() + bytes.size() };
+            get_times(in, chunk.rows, times);
+            get_values(in, chunk.rows, signal->encoding == ValueEncoding::xor_float, raw);
+            if (!in.ok) continue;
+
+            values.resize(raw.size());
+            numeric.convert(raw, signal->value_type, values.data());
+            for (size_t k = 0; k < chunk.rows; ++k) {
+                if (times[k] < start_time || times[k] > end_time) continue;
+                samples.emplace_back(CANTime(CANTime::duration(times[k])), values[k]);
+            }
+        }
+
+        std::stable_sort(samples.begin(), samples.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+        return samples;
+    }
+
+    const CANDataStreamMetadata& ColumnarTranscoder::transmit_metadata() {
+        return metadata;
+    }
+
+}
@@ -4,7 +4,13 @@
 #include "Candy/DBCInterpreters/V2CTranscoder.hpp"
 #include "Candy/DBCInterpreters/SQLTranscoder.hpp"
 #include "Candy/DBCInterpreters/CSVTranscoder.hpp"
+#include "Candy/DBCInterpreters/ColumnarTranscoder.hpp"
+#include "Candy/DBCInterpreters/ArrowTranscoder.hpp"
+#include "Candy/DBCInterpreters/MDFTranscoder.hpp"
+#include "Candy/DBCInterpreters/MotecTranscoder.hpp"
+#include "Candy/DBCInterpreters/MotecGenerator.hpp"
 #include "Candy/DBCInterpreters/LoggingTranscoder.hpp"
+#include "Candy/DBCInterpreters/CodecGenerator.hpp"
 
 #include "Candy/DBCInterpreters/DBC/DBCParser.hpp"
 #include "Candy/DBCInterpreters/DBC/DBCInterpreter.hpp"
@@ -1154,7 +1160,13 @@ namespace Candy {
 
     template class DBCInterpreter<CSVTranscoder>;
     template class DBCInterpreter<SQLTranscoder>;
+    template class DBCInterpreter<ColumnarTranscoder>;
+    template class DBCInterpreter<ArrowTranscoder>;
+    template class DBCInterpreter<MDFTranscoder>;
+    template class DBCInterpreter<MotecTranscoder>;
     template class DBCInterpreter<V2CTranscoder>;
     template class DBCInterpreter<LoggingTranscoder>;
+    template class DBCInterpreter<CodecGenerator>;
+    template class DBCInterpreter<MotecGenerator>;
 
 }
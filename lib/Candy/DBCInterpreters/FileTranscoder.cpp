@@ -1,9 +1,25 @@
 #include "Candy/DBCInterpreters/File/FileTranscoder.hpp"
 #include "Candy/DBCInterpreters/CSVTranscoder.hpp"
 #include "Candy/DBCInterpreters/SQLTranscoder.hpp"
+#include "Candy/DBCInterpreters/ColumnarTranscoder.hpp"
+#include "Candy/DBCInterpreters/ArrowTranscoder.hpp"
+#include "Candy/DBCInterpreters/MDFTranscoder.hpp"
+#include "Candy/DBCInterpreters/MotecTranscoder.hpp"
 
 namespace Candy {
 
+    template<typename T>
+    bool FileTranscoder<T>::parse_dbc(std::string_view dbc_src) {
+        if (!DBCInterpreter<T>::parse_dbc(dbc_src))
+            return false;
+
+        for (const auto& [message_id, msg_def] : messages)
+            decode_table.add(message_id, msg_def);
+        decode_table.build_index();
+        messages.clear();
+        return true;
+    }
+
     template<typename T>
     void FileTranscoder<T>::sg(canid_t message_id, std::optional<unsigned> mux_val, const std::string& signal_name,
                         unsigned start_bit, unsigned bit_size, char byte_order, char sign_type,
@@ -61,5 +77,9 @@ namespace Candy {
 
     template class FileTranscoder<CSVTranscoder>;
     template class FileTranscoder<SQLTranscoder>;
+    template class FileTranscoder<ColumnarTranscoder>;
+    template class FileTranscoder<ArrowTranscoder>;
+    template class FileTranscoder<MDFTranscoder>;
+    template class FileTranscoder<MotecTranscoder>;
 
 }
\ No newline at end of file
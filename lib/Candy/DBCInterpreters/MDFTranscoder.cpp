@@ -0,0 +1,689 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "Candy/DBCInterpreters/MDFTranscoder.hpp"
+
+namespace {
+
+    // every block starts with id, reserved, length and link count
+    constexpr size_t block_header_size = 24;
+    constexpr size_t id_block_size = 64;
+
+    // block positions of the links and fields the writer updates in place
+    constexpr uint64_t hd_at = id_block_size;
+    constexpr uint64_t hd_dg_first = hd_at + 24;
+    constexpr uint64_t hd_fh_first = hd_at + 32;
+    constexpr uint64_t hd_md_comment = hd_at + 64;
+    constexpr uint64_t hd_start_time_ns = hd_at + 72;
+    constexpr uint64_t dg_dg_next = 24;
+    constexpr uint64_t dg_data = 40;
+    constexpr uint64_t cg_cycle_count = 80;
+    constexpr uint64_t dl_dl_next = 24;
+    constexpr size_t cn_block_size = 160;
+
+    constexpr uint16_t unfinalized_cycle_counts = 0x01;
+    constexpr uint16_t unfinalized_data_lists = 0x10;
+
+    // cn_type, cn_sync_type, cn_data_type, cn_flags
+    constexpr uint8_t cn_fixed = 0;
+    constexpr uint8_t cn_master = 2;
+    constexpr uint8_t sync_time = 1;
+    constexpr uint8_t uint_le = 0;
+    constexpr uint8_t int_le = 2;
+    constexpr uint8_t float_le = 4;
+    constexpr uint8_t byte_array = 10;
+    constexpr uint32_t cn_invalidation_bit = 0x02;
+    constexpr uint32_t cn_bus_event = 0x400;
+
+    // cg_flags
+    constexpr uint16_t cg_bus_event = 0x02;
+    constexpr uint16_t cg_plain_bus_event = 0x04;
+
+    // CAN_DataFrame records: t, ID + IDE, DLC, DataLength, EDL/BRS/ESI, DataBytes
+    constexpr size_t frame_data_at = 16;
+    constexpr size_t classic_record_size = frame_data_at + CAN_MAX_DLEN;
+    constexpr size_t fd_record_size = frame_data_at + CANFD_MAX_DLEN;
+
+    class Block {
+    public:
+        std::vector<uint8_t> bytes;
+
+        Block(const char* id, size_t links, size_t data_size) :
+            bytes(block_header_size + links * 8 + data_size, 0),
+            links(links)
+        {
+            std::memcpy(bytes.data(), id, 4);
+            put(8, static_cast<uint64_t>(bytes.size()));
+            put(16, static_cast<uint64_t>(links));
+        }
+
+        void link(size_t index, uint64_t target) { put(block_header_size + index * 8, target); }
+
+        template <typename T>
+        void set(size_t offset, T value) { put(block_header_size + links * 8 + offset, value); }
+
+    private:
+        size_t links;
+
+        template <typename T>
+        void put(size_t at, T value) { std::memcpy(bytes.data() + at, &value, sizeof(T)); }
+    };
+
+    int64_t to_ns(CANTime time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    uint8_t fd_dlc(uint8_t length) {
+        constexpr std::array<uint8_t, 7> lengths = { 12, 16, 20, 24, 32, 48, 64 };
+        if (length <= CAN_MAX_DLEN) return length;
+        auto it = std::lower_bound(lengths.begin(), lengths.end(), length);
+        return static_cast<uint8_t>(CAN_MAX_DLEN + 1 + (it - lengths.begin()));
+    }
+
+    void append_xml(std::string& out, std::string_view text) {
+        for (char c : text) {
+            switch (c) {
+                case '&': out += "&amp;"; break;
+                case '<': out += "&lt;"; break;
+                case '>': out += "&gt;"; break;
+                default: out += c; break;
+            }
+        }
+    }
+
+}
+
+namespace Candy {
+
+    struct MDFTranscoder::Channel {
+        std::string_view name {};
+        uint8_t type = cn_fixed;
+        uint8_t sync_type = 0;
+        uint8_t data_type = uint_le;
+        uint32_t byte_offset = 0;
+        uint8_t bit_offset = 0;
+        uint32_t bit_count = 0;
+        uint32_t flags = 0;
+        std::optional<uint32_t> inval_bit {};
+        std::string_view unit {};
+        // factor, offset
+        std::optional<std::pair<double, double>> linear {};
+        // indices into the group's channel list
+        int next = -1;
+        int composition = -1;
+    };
+
+    MDFTranscoder::MDFTranscoder(FILE* file, std::string path, size_t batch_size) :
+        FileTranscoder<MDFTranscoder>(batch_size, 0, 0),
+        file(file, fclose),
+        path(std::move(path))
+    {
+        frames_batch.reserve(batch_size);
+    }
+
+    MDFTranscoder::~MDFTranscoder() {
+        if (!file) return;
+        flush_all_batches();
+        finalize();
+    }
+
+    MDFTranscoder::MDFTranscoder(MDFTranscoder&& other) noexcept :
+        FileTranscoder<MDFTranscoder>(std::move(other)),
+        file(std::move(other.file)),
+        path(std::move(other.path)),
+        file_end(other.file_end),
+        start_time(other.start_time),
+        dg_link_at(other.dg_link_at),
+        source_at(other.source_at),
+        classic_frames(other.classic_frames),
+        fd_frames(other.fd_frames),
+        message_groups(std::move(other.message_groups)),
+        frames_batch(std::move(other.frames_batch)),
+        decoded_columns(std::move(other.decoded_columns))
+    {
+    }
+
+    MDFTranscoder& MDFTranscoder::operator=(MDFTranscoder&& other) noexcept {
+        if (this != &other) {
+            if (file) {
+                flush_all_batches();
+                finalize();
+            }
+
+            FileTranscoder<MDFTranscoder>::operator=(std::move(other));
+            file = std::move(other.file);
+            path = std::move(other.path);
+            file_end = other.file_end;
+            start_time = other.start_time;
+            dg_link_at = other.dg_link_at;
+            source_at = other.source_at;
+            classic_frames = other.classic_frames;
+            fd_frames = other.fd_frames;
+            message_groups = std::move(other.message_groups);
+            frames_batch = std::move(other.frames_batch);
+            decoded_columns = std::move(other.decoded_columns);
+        }
+        return *this;
+    }
+
+    std::optional<MDFTranscoder> MDFTranscoder::create(const std::string& path, size_t batch_size) {
+        FILE* file = fopen(path.c_str(), "w+b");
+        if (!file) {
+            std::cerr << "Failed to create MDF file: " << path << std::endl;
+            return std::nullopt;
+        }
+
+        MDFTranscoder transcoder(file, path, std::max<size_t>(batch_size, 1));
+        transcoder.write_header();
+        if (ferror(transcoder.file.get())) {
+            std::cerr << "Failed to write MDF header: " << path << std::endl;
+            return std::nullopt;
+        }
+        return std::make_optional<MDFTranscoder>(std::move(transcoder));
+    }
+
+    // CANIO
+    void MDFTranscoder::receive_raw_message(std::pair<CANTime, CANFrame> sample) {
+        batch_frame(sample);
+        if (auto slot = decode_table.find(sample.second.can_id))
+            batch_decoded_signals(sample, decode_table.message(*slot));
+
+        if (frames_batch_count >= batch_size) write_batch();
+    }
+
+    void MDFTranscoder::receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample) {
+        clear_padding(sample.second);
+        batch_frame(sample);
+        if (auto slot = decode_table.find(sample.second.can_id))
+            batch_decoded_signals(sample, decode_table.message(*slot));
+
+        if (frames_batch_count >= batch_size) write_batch();
+    }
+
+    // signals are decoded from the frame again, so values for ids outside the DBC are not kept
+    void MDFTranscoder::receive_message(const CANMessage& message) {
+        receive_raw_message(message.sample);
+    }
+
+    // written as the HD comment on close
+    void MDFTranscoder::receive_metadata(const CANDataStreamMetadata& stream_metadata) {
+        metadata = stream_metadata;
+    }
+
+    // message names come from decode_table when a message's channel group is first written
+    void MDFTranscoder::store_message_metadata(canid_t, const std::string&, size_t) {
+    }
+
+    // transcoder methods
+    void MDFTranscoder::batch_frame(std::pair<CANTime, CANFrame> sample) {
+        frames_batch.emplace_back(sample.first, widen_frame(sample.second));
+        frames_batch_count++;
+    }
+
+    void MDFTranscoder::batch_frame(const std::pair<CANTime, CANFlexibleFrame>& sample) {
+        frames_batch.push_back(sample);
+        frames_batch_count++;
+    }
+
+    // decoding happens per message when the batch is written
+    void MDFTranscoder::batch_decoded_signals(std::pair<CANTime, CANFrame>, const DecodeMessage&) {
+        decoded_signals_batch_count++;
+    }
+
+    void MDFTranscoder::batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>&, const DecodeMessage&) {
+        decoded_signals_batch_count++;
+    }
+
+    void MDFTranscoder::flush_frames_batch() {
+        write_batch();
+    }
+
+    void MDFTranscoder::flush_decoded_signals_batch() {
+        write_batch();
+    }
+
+    void MDFTranscoder::flush_all_batches() {
+        write_batch();
+        if (file) fflush(file.get());
+    }
+
+    // blocks
+
+    uint64_t MDFTranscoder::append(const std::vector<uint8_t>& block) {
+        const std::array<uint8_t, 8> padding {};
+        const size_t pad = (8 - block.size() % 8) % 8;
+        if (fwrite(block.data(), 1, block.size(), file.get()) != block.size() ||
+            fwrite(padding.data(), 1, pad, file.get()) != pad) {
+            std::cerr << "Failed to write MDF block to " << path << std::endl;
+        }
+
+        uint64_t at = file_end;
+        file_end += block.size() + pad;
+        return at;
+    }
+
+    void MDFTranscoder::patch(uint64_t at, const void* data, size_t size) {
+        if (fseeko(file.get(), static_cast<off_t>(at), SEEK_SET) != 0 ||
+            fwrite(data, 1, size, file.get()) != size) {
+            std::cerr << "Failed to update MDF block in " << path << std::endl;
+        }
+        fseeko(file.get(), 0, SEEK_END);
+    }
+
+    // a TX or MD block; the text is zero terminated and padded
+    uint64_t MDFTranscoder::add_text(const char* id, std::string_view text) {
+        Block block(id, 0, (text.size() + 8) / 8 * 8);
+        std::memcpy(block.bytes.data() + block_header_size, text.data(), text.size());
+        return append(block.bytes);
+    }
+
+    void MDFTranscoder::write_header() {
+        std::array<uint8_t, id_block_size> id {};
+        std::memcpy(id.data(), "UnFinMF ", 8);
+        std::memcpy(id.data() + 8, "4.10    ", 8);
+        std::memcpy(id.data() + 16, "Candy   ", 8);
+        const uint16_t version = 410;
+        const uint16_t unfinalized = unfinalized_cycle_counts | unfinalized_data_lists;
+        std::memcpy(id.data() + 28, &version, sizeof(version));
+        std::memcpy(id.data() + 60, &unfinalized, sizeof(unfinalized));
+        append({ id.begin(), id.end() });
+
+        // links are filled in as groups are added; the start time with the first batch
+        append(Block("##HD", 6, 32).bytes);
+        dg_link_at = hd_dg_first;
+
+        uint64_t comment = add_text("##MD",
+            "<FHcomment><TX>created</TX><tool_id>Candy</tool_id>"
+            "<tool_vendor>Bruin Formula Racing</tool_vendor><tool_version>0.1</tool_version></FHcomment>");
+        Block history("##FH", 2, 16);
+        history.link(1, comment);
+        history.set<uint64_t>(0, static_cast<uint64_t>(to_ns(std::chrono::system_clock::now())));
+        link(hd_fh_first, append(history.bytes));
+
+        Block source("##SI", 3, 8);
+        source.link(0, add_text("##TX", "CAN"));
+        source.set<uint8_t>(0, 2); // BUS
+        source.set<uint8_t>(1, 2); // CAN
+        source_at = append(source.bytes);
+    }
+
+    void MDFTranscoder::finalize() {
+        std::string_view name = metadata.get_stream_name();
+        std::string_view description = metadata.get_description();
+        if (!name.empty() || !description.empty()) {
+            std::string comment = "<HDcomment><TX>";
+            append_xml(comment, description);
+            comment += "</TX><common_properties><e name=\"stream_name\">";
+            append_xml(comment, name);
+            comment += "</e></common_properties></HDcomment>";
+            link(hd_md_comment, add_text("##MD", comment));
+        }
+
+        const uint16_t finalized = 0;
+        patch(0, "MDF     ", 8);
+        patch(60, &finalized, sizeof(finalized));
+        fflush(file.get());
+    }
+
+    void MDFTranscoder::add_group(Group& group, std::string_view name, uint16_t flags, uint32_t data_bytes,
+                                  uint32_t inval_bytes, const std::vector<Channel>& channels) {
+        std::vector<Block> blocks;
+        blocks.reserve(channels.size());
+        for (const Channel& channel : channels) {
+            Block& cn = blocks.emplace_back("##CN", 8, 72);
+            cn.link(2, add_text("##TX", channel.name));
+            if (!channel.unit.empty()) cn.link(6, add_text("##TX", channel.unit));
+
+            if (channel.linear) {
+                Block cc("##CC", 4, 40);
+                cc.set<uint8_t>(0, 1); // linear: phys = P1 + P2 * raw
+                cc.set<uint16_t>(6, 2);
+                cc.set<double>(24, channel.linear->second);
+                cc.set<double>(32, channel.linear->first);
+                cn.link(4, append(cc.bytes));
+            }
+
+            cn.link(3, source_at);
+            cn.set<uint8_t>(0, channel.type);
+            cn.set<uint8_t>(1, channel.sync_type);
+            cn.set<uint8_t>(2, channel.data_type);
+            cn.set<uint8_t>(3, channel.bit_offset);
+            cn.set<uint32_t>(4, channel.byte_offset);
+            cn.set<uint32_t>(8, channel.bit_count);
+            cn.set<uint32_t>(12, channel.flags | (channel.inval_bit ? cn_invalidation_bit : 0));
+            cn.set<uint32_t>(16, channel.inval_bit.value_or(0));
+        }
+
+        // the channel blocks go back to back, so their links are known up front
+        const uint64_t first_channel = file_end;
+        auto channel_at = [&](int index) {
+            return index < 0 ? 0 : first_channel + static_cast<uint64_t>(index) * cn_block_size;
+        };
+        for (size_t i = 0; i < channels.size(); ++i) {
+            blocks[i].link(0, channel_at(channels[i].next));
+            blocks[i].link(1, channel_at(channels[i].composition));
+            append(blocks[i].bytes);
+        }
+
+        uint64_t acquisition_name = add_text("##TX", name);
+        Block cg("##CG", 6, 32);
+        cg.link(1, first_channel);
+        cg.link(2, acquisition_name);
+        cg.link(3, source_at);
+        cg.set<uint16_t>(16, flags);
+        cg.set<uint16_t>(18, '.');
+        cg.set<uint32_t>(24, data_bytes);
+        cg.set<uint32_t>(28, inval_bytes);
+        uint64_t cg_at = append(cg.bytes);
+
+        Block dg("##DG", 4, 8);
+        dg.link(1, cg_at);
+        uint64_t dg_at = append(dg.bytes);
+        link(dg_link_at, dg_at);
+        dg_link_at = dg_at + dg_dg_next;
+
+        group.dg_at = dg_at;
+        group.cg_at = cg_at;
+        group.data_link_at = dg_at + dg_data;
+        group.record_size = data_bytes + inval_bytes;
+    }
+
+    MDFTranscoder::Group& MDFTranscoder::frame_group(bool fd) {
+        std::optional<Group>& group = fd ? fd_frames : classic_frames;
+        if (group) return *group;
+
+        const uint32_t data_length = fd ? CANFD_MAX_DLEN : CAN_MAX_DLEN;
+        const uint32_t record_size = fd ? fd_record_size : classic_record_size;
+
+        // ASAM MDF bus logging: a CAN_DataFrame structure with its fields as members
+        std::vector<Channel> channels = {
+            { .name = "t", .type = cn_master, .sync_type = sync_time, .data_type = float_le,
+              .bit_count = 64, .unit = "s", .next = 1 },
+            { .name = "CAN_DataFrame", .data_type = byte_array, .byte_offset = 8,
+              .bit_count = (record_size - 8) * 8, .flags = cn_bus_event, .composition = 2 },
+            { .name = "CAN_DataFrame.ID", .byte_offset = 8, .bit_count = 29, .flags = cn_bus_event, .next = 3 },
+            { .name = "CAN_DataFrame.IDE", .byte_offset = 11, .bit_offset = 7, .bit_count = 1, .flags = cn_bus_event, .next = 4 },
+            { .name = "CAN_DataFrame.DLC", .byte_offset = 12, .bit_count = 4, .flags = cn_bus_event, .next = 5 },
+            { .name = "CAN_DataFrame.DataLength", .byte_offset = 13, .bit_count = 8, .flags = cn_bus_event, .next = 6 },
+            { .name = "CAN_DataFrame.DataBytes", .data_type = byte_array, .byte_offset = frame_data_at,
+              .bit_count = data_length * 8, .flags = cn_bus_event, .next = fd ? 7 : -1 }
+        };
+        if (fd) {
+            channels.push_back({ .name = "CAN_DataFrame.EDL", .byte_offset = 14, .bit_count = 1, .flags = cn_bus_event, .next = 8 });
+            channels.push_back({ .name = "CAN_DataFrame.BRS", .byte_offset = 14, .bit_offset = 1, .bit_count = 1, .flags = cn_bus_event, .next = 9 });
+            channels.push_back({ .name = "CAN_DataFrame.ESI", .byte_offset = 14, .bit_offset = 2, .bit_count = 1, .flags = cn_bus_event });
+        }
+
+        group.emplace();
+        add_group(*group, "CAN_DataFrame", cg_bus_event | cg_plain_bus_event, record_size, 0, channels);
+        return *group;
+    }
+
+    MDFTranscoder::Group& MDFTranscoder::message_group(uint32_t slot) {
+        if (message_groups.size() < decode_table.message_count())
+            message_groups.resize(decode_table.message_count());
+
+        std::optional<Group>& group = message_groups[slot];
+        if (group) return *group;
+
+        const DecodeMessage& msg = decode_table.message(slot);
+        const uint32_t first_value = msg.has_mux ? 16 : 8;
+
+        bool multiplexed = false;
+        for (uint32_t i = 0; i < msg.signal_count; ++i)
+            multiplexed |= decode_table.mux_val(msg.first_signal + i).has_value();
+
+        std::vector<Channel> channels;
+        channels.push_back({ .name = "t", .type = cn_master, .sync_type = sync_time, .data_type = float_le,
+                             .bit_count = 64, .unit = "s" });
+        if (msg.has_mux)
+            channels.push_back({ .name = "mux_value", .byte_offset = 8, .bit_count = 64 });
+
+        for (uint32_t i = 0; i < msg.signal_count; ++i) {
+            const uint32_t sig = msg.first_signal + i;
+            Channel channel { .name = decode_table.signal_name(sig), .byte_offset = first_value + 8 * i,
+                              .bit_count = 64, .unit = decode_table.unit(sig) };
+
+            switch (decode_table.value_type(sig)) {
+                case NumericValueType::i64: channel.data_type = int_le; break;
+                case NumericValueType::u64: channel.data_type = uint_le; break;
+                case NumericValueType::f32: channel.data_type = float_le; channel.bit_count = 32; break;
+                case NumericValueType::f64: channel.data_type = float_le; break;
+            }
+            if (decode_table.factor(sig) != 1.0 || decode_table.offset(sig) != 0.0)
+                channel.linear = std::make_pair(decode_table.factor(sig), decode_table.offset(sig));
+            if (decode_table.mux_val(sig))
+                channel.inval_bit = i;
+
+            channels.push_back(channel);
+        }
+        for (size_t i = 0; i + 1 < channels.size(); ++i)
+            channels[i].next = static_cast<int>(i + 1);
+
+        const uint32_t inval_bytes = multiplexed ? (msg.signal_count + 7) / 8 : 0;
+        group.emplace();
+        add_group(*group, decode_table.message_name(slot), 0, first_value + 8 * msg.signal_count, inval_bytes, channels);
+        return *group;
+    }
+
+    // a DT block of whole records, linked in through a one-entry DL block
+    void MDFTranscoder::append_records(Group& group, const std::vector<uint8_t>& records) {
+        if (records.empty()) return;
+
+        Block dt("##DT", 0, 0);
+        uint64_t length = block_header_size + records.size();
+        std::memcpy(dt.bytes.data() + 8, &length, sizeof(length));
+        dt.bytes.insert(dt.bytes.end(), records.begin(), records.end());
+        uint64_t dt_at = append(dt.bytes);
+
+        Block dl("##DL", 2, 16);
+        dl.link(1, dt_at);
+        dl.set<uint32_t>(4, 1);
+        dl.set<uint64_t>(8, group.data_bytes);
+        uint64_t dl_at = append(dl.bytes);
+
+        link(group.data_link_at, dl_at);
+        group.data_link_at = dl_at + dl_dl_next;
+        group.data_bytes += records.size();
+        group.cycles += records.size() / group.record_size;
+        patch(group.cg_at + cg_cycle_count, &group.cycles, sizeof(group.cycles));
+    }
+
+    double MDFTranscoder::relative_time(CANTime time) const {
+        return static_cast<double>(to_ns(time) - start_time.value_or(0)) / 1e9;
+    }
+
+    void MDFTranscoder::write_batch() {
+        if (frames_batch.empty() || !file) return;
+
+        if (!start_time) {
+            start_time = to_ns(frames_batch.front().first);
+            patch(hd_start_time_ns, &*start_time, sizeof(*start_time));
+        }
+
+        // raw frames in arrival order
+        classic_records.clear();
+        fd_records.clear();
+        for (const auto& [timestamp, frame] : frames_batch) {
+            const bool fd = (frame.flags & CANFD_FDF) || frame.length > CAN_MAX_DLEN;
+            std::vector<uint8_t>& records = fd ? fd_records : classic_records;
+            const size_t at = records.size();
+            records.resize(at + (fd ? fd_record_size : classic_record_size), 0);
+            uint8_t* record = records.data() + at;
+
+            const double time = relative_time(timestamp);
+            uint32_t id = frame.can_id & CAN_EFF_MASK;
+            if (frame.can_id & CAN_EFF_FLAG) id |= 1u << 31;
+            const uint8_t length = std::min<uint8_t>(frame.length, fd ? CANFD_MAX_DLEN : CAN_MAX_DLEN);
+
+            std::memcpy(record, &time, sizeof(time));
+            std::memcpy(record + 8, &id, sizeof(id));
+            record[12] = fd ? fd_dlc(length) : length;
+            record[13] = length;
+            if (fd) record[14] = 0x01 | (frame.flags & CANFD_BRS ? 0x02 : 0) | (frame.flags & CANFD_ESI ? 0x04 : 0);
+            std::memcpy(record + frame_data_at, frame.data, length);
+        }
+        if (!classic_records.empty()) append_records(frame_group(false), classic_records);
+        if (!fd_records.empty()) append_records(frame_group(true), fd_records);
+
+        // one run per id; arrival order is kept within a run
+        std::stable_sort(frames_batch.begin(), frames_batch.end(), [](const auto& a, const auto& b) {
+            return a.second.can_id < b.second.can_id;
+        });
+
+        auto run_begin = frames_batch.begin();
+        while (run_begin != frames_batch.end()) {
+            canid_t can_id = run_begin->second.can_id;
+            auto run_end = std::find_if(run_begin, frames_batch.end(), [can_id](const auto& s) {
+                return s.second.can_id != can_id;
+            });
+
+            if (auto slot = decode_table.find(can_id)) {
+                std::span<const std::pair<CANTime, CANFlexibleFrame>> run(&*run_begin, run_end - run_begin);
+                decoded_columns.decode(decode_table, *slot, run);
+
+                Group& group = message_group(*slot);
+                const DecodeMessage& msg = decode_table.message(*slot);
+                const size_t first_value = msg.has_mux ? 16 : 8;
+                const size_t inval_at = first_value + 8 * msg.signal_count;
+
+                message_records.assign(run.size() * group.record_size, 0);
+                for (size_t row = 0; row < run.size(); ++row) {
+                    uint8_t* record = message_records.data() + row * group.record_size;
+                    const double time = relative_time(run[row].first);
+                    std::memcpy(record, &time, sizeof(time));
+
+                    auto mux = decoded_columns.mux(row);
+                    if (mux) std::memcpy(record + 8, &*mux, sizeof(uint64_t));
+
+                    for (size_t col = 0; col < decoded_columns.columns(); ++col) {
+                        const uint64_t raw = decoded_columns.raw(col)[row];
+                        std::memcpy(record + first_value + 8 * col, &raw, sizeof(raw));
+                        if (!decode_table.is_active(decoded_columns.signal(col), mux))
+                            record[inval_at + col / 8] |= static_cast<uint8_t>(1u << (col % 8));
+                    }
+                }
+                append_records(group, message_records);
+            }
+
+            run_begin = run_end;
+        }
+
+        frames_batch.clear();
+        frames_batch_count = 0;
+        decoded_signals_batch_count = 0;
+    }
+
+    // readback
+
+    void MDFTranscoder::read_records(const Group& group, std::vector<uint8_t>& out) {
+        out.clear();
+        FILE* in = fopen(path.c_str(), "rb");
+        if (!in) return;
+
+        auto read_at = [in](uint64_t at, void* data, size_t size) {
+            return fseeko(in, static_cast<off_t>(at), SEEK_SET) == 0 && fread(data, 1, size, in) == size;
+        };
+
+        uint64_t dl_at = 0;
+        read_at(group.dg_at + dg_data, &dl_at, sizeof(dl_at));
+        std::vector<uint64_t> links;
+        while (dl_at != 0) {
+            uint64_t header[3];
+            if (!read_at(dl_at, header, sizeof(header)) || header[2] == 0 || header[2] > header[1] / 8) break;
+
+            links.resize(header[2]);
+            if (!read_at(dl_at + block_header_size, links.data(), links.size() * sizeof(uint64_t))) break;
+
+            for (size_t i = 1; i < links.size(); ++i) {
+                uint64_t dt[3];
+                if (!read_at(links[i], dt, sizeof(dt)) || dt[1] < block_header_size) continue;
+
+                const size_t at = out.size();
+                out.resize(at + dt[1] - block_header_size);
+                if (!read_at(links[i] + block_header_size, out.data() + at, out.size() - at)) out.resize(at);
+            }
+            dl_at = links[0];
+        }
+
+        fclose(in);
+    }
+
+    std::vector<CANMessage> MDFTranscoder::transmit_messages(canid_t can_id) {
+        return transmit_messages_in_range(can_id, CANTime::min(), CANTime::max());
+    }
+
+    std::vector<CANMessage> MDFTranscoder::transmit_messages_in_range(canid_t can_id, CANTime start, CANTime end) {
+        std::vector<CANMessage> messages;
+        flush_all_batches();
+        if (!start_time) return messages;
+
+        const int64_t start_ns = to_ns(start);
+        const int64_t end_ns = to_ns(end);
+
+        std::vector<std::pair<CANTime, CANFlexibleFrame>> samples;
+        std::vector<uint8_t> records;
+        for (const std::optional<Group>* group : { &classic_frames, &fd_frames }) {
+            if (!*group) continue;
+            read_records(**group, records);
+
+            const size_t record_size = (*group)->record_size;
+            for (size_t at = 0; at + record_size <= records.size(); at += record_size) {
+                const uint8_t* record = records.data() + at;
+                uint32_t id;
+                double time;
+                std::memcpy(&id, record + 8, sizeof(id));
+                std::memcpy(&time, record, sizeof(time));
+
+                canid_t frame_id = (id & CAN_EFF_MASK) | (id >> 31 ? CAN_EFF_FLAG : 0);
+                if (frame_id != can_id) continue;
+
+                const int64_t timestamp = *start_time + static_cast<int64_t>(std::llround(time * 1e9));
+                if (timestamp < start_ns || timestamp > end_ns) continue;
+
+                CANFlexibleFrame frame {};
+                frame.can_id = frame_id;
+                frame.length = std::min<uint8_t>(record[13], static_cast<uint8_t>(record_size - frame_data_at));
+                frame.flags = (record[14] & 0x01 ? CANFD_FDF : 0) | (record[14] & 0x02 ? CANFD_BRS : 0) |
+                              (record[14] & 0x04 ? CANFD_ESI : 0);
+                std::memcpy(frame.data, record + frame_data_at, frame.length);
+                samples.emplace_back(CANTime(std::chrono::duration_cast<CANTime::duration>(std::chrono::nanoseconds(timestamp))), frame);
+            }
+        }
+
+        std::stable_sort(samples.begin(), samples.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+
+        auto slot = decode_table.find(can_id);
+        if (slot && !samples.empty()) decoded_columns.decode(decode_table, *slot, samples);
+
+        messages.resize(samples.size());
+        for (size_t row = 0; row < samples.size(); ++row) {
+            CANMessage& message = messages[row];
+            // CAN FD frames keep only their first 8 bytes in a CANMessage
+            message.sample = { samples[row].first, narrow_frame(samples[row].second) };
+            if (!slot) continue;
+
+            message.set_message_name(decode_table.message_name(*slot));
+            message.mux_value = decoded_columns.mux(row);
+            for (size_t col = 0; col < decoded_columns.columns(); ++col) {
+                const uint32_t signal = decoded_columns.signal(col);
+                if (!decode_table.is_active(signal, message.mux_value)) continue;
+                message.add_signal(decode_table.signal_name(signal), decoded_columns.values(col)[row],
+                                   decode_table.unit(signal));
+            }
+        }
+        return messages;
+    }
+
+    const CANDataStreamMetadata& MDFTranscoder::transmit_metadata() {
+        return metadata;
+    }
+
+}
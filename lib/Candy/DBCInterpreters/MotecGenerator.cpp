@@ -1,52 +1,425 @@
 #include "Candy/DBCInterpreters/MotecGenerator.hpp"
 
 #include <algorithm>
-#include <vector>
-#include <cctype>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+    // one field starting at p, quotes stripped; p ends up past its delimiter
+    std::string_view next_field(const char*& p, const char* end, bool& line_end) {
+        const char* value = p;
+        const char* value_end = nullptr;
+        if (p < end && *p == '"') {
+            value = p + 1;
+            const void* close = std::memchr(value, '"', end - value);
+            value_end = close ? static_cast<const char*>(close) : end;
+            p = value_end < end ? value_end + 1 : end;
+        }
+
+        const char* delim = p;
+        while (delim < end && *delim != ',' && *delim != '\n') ++delim;
+        if (!value_end) {
+            value_end = delim;
+            if (value_end > value && value_end[-1] == '\r') --value_end;
+        }
+
+        line_end = delim == end || *delim == '\n';
+        p = delim < end ? delim + 1 : end;
+        return std::string_view(value, value_end - value);
+    }
+
+    std::string_view next_line(const char*& p, const char* end) {
+        const void* nl = std::memchr(p, '\n', end - p);
+        const char* line_end = nl ? static_cast<const char*>(nl) : end;
+        std::string_view line(p, line_end - p);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        p = line_end < end ? line_end + 1 : end;
+        return line;
+    }
+
+    template <typename T>
+    bool parse_number(std::string_view field, T& out) {
+        auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), out);
+        return ec == std::errc();
+    }
+
+    // "Brake Pressure RL" -> "Brake_Pressure_RL", "Wing GH: FW_Wing_PlateL" -> "Wing_GH_FW_Wing_PlateL"
+    void dbc_name(std::string_view channel, std::string& out) {
+        out.clear();
+        for (char c : channel) {
+            if (std::isalnum(static_cast<unsigned char>(c))) out += c;
+            else if (!out.empty() && out.back() != '_') out += '_';
+        }
+        while (!out.empty() && out.back() == '_') out.pop_back();
+    }
+
+    // Log Date "03-Sep-25" and Log Time "11:54:02"
+    std::optional<CANTime> parse_log_start(std::string_view date, std::string_view time) {
+        constexpr std::array<std::string_view, 12> months = {
+            "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+        };
+
+        unsigned day = 0;
+        int year = 0;
+        size_t first = date.find('-');
+        size_t second = date.find('-', first + 1);
+        if (first == std::string_view::npos || second == std::string_view::npos ||
+            !parse_number(date.substr(0, first), day) || !parse_number(date.substr(second + 1), year)) {
+            return std::nullopt;
+        }
+        if (year < 100) year += 2000;
+
+        auto month = std::find(months.begin(), months.end(), date.substr(first + 1, second - first - 1));
+        if (month == months.end()) return std::nullopt;
+
+        std::chrono::year_month_day ymd { std::chrono::year(year),
+                                          std::chrono::month(static_cast<unsigned>(month - months.begin()) + 1),
+                                          std::chrono::day(day) };
+        if (!ymd.ok()) return std::nullopt;
+
+        int hms[3] = {};
+        for (int i = 0; i < 3 && !time.empty(); ++i) {
+            size_t colon = time.find(':');
+            if (!parse_number(time.substr(0, colon), hms[i])) return std::nullopt;
+            time = colon == std::string_view::npos ? std::string_view() : time.substr(colon + 1);
+        }
+
+        return CANTime(std::chrono::sys_days(ymd)) + std::chrono::hours(hms[0]) +
+               std::chrono::minutes(hms[1]) + std::chrono::seconds(hms[2]);
+    }
+
+}
 
 namespace Candy {
-    
-    static std::vector<std::string> parse_csv_line(const std::string& line) {
-        std::vector<std::string> result;
-        std::string current;
-        bool in_quotes = false;
-        bool escape_next = false;
-        
-        for (size_t i = 0; i < line.size(); ++i) {
-            char c = line[i];
-            
-            if (escape_next) {
-                current += c;
-                escape_next = false;
-            } else if (c == '\\') {
-                escape_next = true;
-            } else if (c == '"') {
-                in_quotes = !in_quotes;
-            } else if (c == ',' && !in_quotes) {
-                result.push_back(current);
-                current.clear();
-            } else {
-                current += c;
-            }
-        }
-        
-        result.push_back(current);
-        return result;
-    }
-    
-    static std::string trim(const std::string& str) {
-        auto start = std::find_if_not(str.begin(), str.end(), 
-            [](unsigned char ch) { return std::isspace(ch); });
-        auto end = std::find_if_not(str.rbegin(), str.rend(),
-            [](unsigned char ch) { return std::isspace(ch); }).base();
-        return (start < end) ? std::string(start, end) : std::string();
-    }
-
-    MotecGenerator::MotecGenerator(const std::string& csv_path) 
+
+    MotecGenerator::MotecGenerator(const std::string& csv_path)
         : path(csv_path), current(0) {
     }
 
+    MotecGenerator::~MotecGenerator() {
+        if (data) munmap(const_cast<char*>(data), size);
+    }
+
+    MotecGenerator::MotecGenerator(MotecGenerator&& other) noexcept :
+        DBCInterpreter<MotecGenerator>(std::move(other)),
+        path(std::move(other.path)),
+        data(other.data),
+        size(other.size),
+        cursor(other.cursor),
+        motec_header(std::move(other.motec_header)),
+        log_start(other.log_start),
+        messages(std::move(other.messages)),
+        signals(std::move(other.signals)),
+        column_signals(std::move(other.column_signals)),
+        signal_frames(std::move(other.signal_frames)),
+        time_column(other.time_column),
+        row_frames(std::move(other.row_frames)),
+        row_present(std::move(other.row_present)),
+        current(other.current)
+    {
+        other.data = nullptr;
+        other.size = 0;
+        other.cursor = nullptr;
+    }
+
+    MotecGenerator& MotecGenerator::operator=(MotecGenerator&& other) noexcept {
+        if (this != &other) {
+            if (data) munmap(const_cast<char*>(data), size);
+
+            DBCInterpreter<MotecGenerator>::operator=(std::move(other));
+            path = std::move(other.path);
+            data = other.data;
+            size = other.size;
+            cursor = other.cursor;
+            motec_header = std::move(other.motec_header);
+            log_start = other.log_start;
+            messages = std::move(other.messages);
+            signals = std::move(other.signals);
+            column_signals = std::move(other.column_signals);
+            signal_frames = std::move(other.signal_frames);
+            time_column = other.time_column;
+            row_frames = std::move(other.row_frames);
+            row_present = std::move(other.row_present);
+            current = other.current;
+
+            other.data = nullptr;
+            other.size = 0;
+            other.cursor = nullptr;
+        }
+        return *this;
+    }
+
+    // DBC
+    void MotecGenerator::bo(canid_t message_id, std::string, size_t message_size, size_t) {
+        for (auto& message : messages) {
+            if (message.can_id != message_id) continue;
+            message.size = message_size;
+            return;
+        }
+        messages.push_back({ message_id, message_size });
+    }
+
+    // MoTeC channels are flat, so multiplexed signals and signals past byte 8 are not bound
+    void MotecGenerator::sg(canid_t message_id, std::optional<unsigned> mux_val, const std::string& signal_name,
+                            unsigned start_bit, unsigned bit_size, char byte_order, char sign_type,
+                            double factor, double offset, double, double,
+                            std::string, std::vector<size_t>)
+    {
+        SignalCodec codec(start_bit, bit_size, byte_order, sign_type);
+        if (mux_val || codec.layout().wide || payload_extent(codec.layout()) > CAN_MAX_DLEN) return;
+
+        // SG_ lines without a SIG_VALTYPE_ are integers
+        signals.push_back({ message_id, signal_name, codec, factor == 0.0 ? 1.0 : factor, offset,
+                            sign_type == '-' ? NumericValueType::i64 : NumericValueType::u64 });
+    }
+
+    void MotecGenerator::sig_valtype(canid_t message_id, const std::string& signal_name, unsigned value_type) {
+        for (auto& signal : signals) {
+            if (signal.can_id == message_id && signal.name == signal_name) {
+                signal.value_type = static_cast<NumericValueType>(value_type);
+                return;
+            }
+        }
+    }
+
+    // CSV
+
     bool MotecGenerator::parse_csv() {
+        if (data) {
+            munmap(const_cast<char*>(data), size);
+            data = nullptr;
+        }
+
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Failed to open MoTeC CSV file: " << path << std::endl;
+            return false;
+        }
+
+        // sys/stat.h drags in linux/types.h, whose __u64 clashes with CANKernelTypes.hpp
+        off_t file_size = lseek(fd, 0, SEEK_END);
+        void* mapped = file_size > 0 ? mmap(nullptr, static_cast<size_t>(file_size), PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Failed to map MoTeC CSV file: " << path << std::endl;
+            return false;
+        }
+        madvise(mapped, static_cast<size_t>(file_size), MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+        size = static_cast<size_t>(file_size);
+
+        // key/value header lines, up to the channel name row
+        const char* p = data;
+        const char* end = data + size;
+        motec_header = MotecHeader();
+        column_signals.clear();
+        while (p < end) {
+            std::string_view line = next_line(p, end);
+            if (line.starts_with("\"Time\"")) {
+                if (!bind_columns(line)) return false;
+                break;
+            }
+            if (!line.empty()) parse_header(line);
+        }
+
+        if (column_signals.empty()) {
+            std::cerr << "MoTeC CSV file has no channel row: " << path << std::endl;
+            return false;
+        }
+
+        // the units row, then data
+        while (p < end && (*p == '\n' || *p == '\r')) ++p;
+        next_line(p, end);
+        cursor = p;
+        current = row_frames.size();
+
+        log_start = parse_log_start(motec_header.log_date, motec_header.log_time).value_or(CANTime());
+        return true;
+    }
+
+    void MotecGenerator::parse_header(std::string_view line) {
+        std::array<std::string_view, 8> fields;
+        size_t count = 0;
+        const char* p = line.data();
+        const char* end = line.data() + line.size();
+        bool line_end = false;
+        while (!line_end && count < fields.size())
+            fields[count++] = next_field(p, end, line_end);
+
+        MotecHeader& h = motec_header;
+        for (size_t i = 0; i + 1 < count; ++i) {
+            std::string_view key = fields[i];
+            std::string_view value = fields[i + 1];
+
+            if (key == "Format") h.format = value;
+            else if (key == "Venue") h.venue = value;
+            else if (key == "Vehicle") h.vehicle = value;
+            else if (key == "Driver") h.driver = value;
+            else if (key == "Device") h.device = value;
+            else if (key == "Comment") h.comment = value;
+            else if (key == "Log Date") h.log_date = value;
+            else if (key == "Log Time") h.log_time = value;
+            else if (key == "Sample Rate") parse_number(value, h.sample_rate);
+            else if (key == "Duration") parse_number(value, h.duration);
+            else if (key == "Range") h.range = value;
+            else if (key == "Workbook") h.workbook = value;
+            else if (key == "Worksheet") h.worksheet = value;
+            else if (key == "Vehicle Desc") h.vehicle_desc = value;
+            else if (key == "Engine ID") h.engine_id = value;
+            else if (key == "Session") h.session = value;
+            else if (key == "Origin Time") parse_number(value, h.origin_time);
+            else if (key == "Start Time") parse_number(value, h.start_time);
+            else if (key == "End Time") parse_number(value, h.end_time);
+            else if (key == "Start Distance") parse_number(value, h.start_distance);
+            else if (key == "End Distance") parse_number(value, h.end_distance);
+            else if (key == "Beacon Markers") {
+                h.beacon_markers.clear();
+                while (!value.empty()) {
+                    size_t space = value.find(' ');
+                    double marker;
+                    if (parse_number(value.substr(0, space), marker)) h.beacon_markers.push_back(marker);
+                    value = space == std::string_view::npos ? std::string_view() : value.substr(space + 1);
+                }
+            }
+            else continue;
+
+            ++i;
+        }
+    }
+
+    bool MotecGenerator::bind_columns(std::string_view names) {
+        std::unordered_map<std::string_view, int32_t> by_name;
+        for (size_t i = 0; i < signals.size(); ++i)
+            by_name.emplace(signals[i].name, static_cast<int32_t>(i));
+
+        std::unordered_map<canid_t, uint32_t> frame_of;
+        row_frames.clear();
+        for (const auto& message : messages) {
+            frame_of[message.can_id] = static_cast<uint32_t>(row_frames.size());
+            std::pair<CANTime, CANFrame>& frame = row_frames.emplace_back();
+            frame.second.can_id = message.can_id;
+            frame.second.len = static_cast<uint8_t>(std::min<size_t>(message.size, CAN_MAX_DLEN));
+        }
+
+        signal_frames.assign(signals.size(), 0);
+        for (size_t i = 0; i < signals.size(); ++i) {
+            auto it = frame_of.find(signals[i].can_id);
+            if (it == frame_of.end()) {
+                // an SG_ without its BO_: the frame gets the full classic length
+                it = frame_of.emplace(signals[i].can_id, static_cast<uint32_t>(row_frames.size())).first;
+                std::pair<CANTime, CANFrame>& frame = row_frames.emplace_back();
+                frame.second.can_id = signals[i].can_id;
+                frame.second.len = CAN_MAX_DLEN;
+            }
+            signal_frames[i] = it->second;
+        }
+        row_present.assign(row_frames.size(), 0);
+
+        const char* p = names.data();
+        const char* end = names.data() + names.size();
+        bool line_end = false;
+        bool has_time = false;
+        std::string name;
+        while (!line_end) {
+            std::string_view channel = next_field(p, end, line_end);
+            if (channel == "Time") {
+                time_column = column_signals.size();
+                has_time = true;
+            }
+
+            dbc_name(channel, name);
+            auto it = by_name.find(name);
+            column_signals.push_back(it == by_name.end() ? -1 : it->second);
+        }
+
+        if (!has_time || bound_columns() == 0) {
+            std::cerr << "No MoTeC CSV channels match the DBC signals: " << path << std::endl;
+            column_signals.clear();
+            return false;
+        }
+        return true;
+    }
+
+    size_t MotecGenerator::bound_columns() const {
+        return static_cast<size_t>(std::count_if(column_signals.begin(), column_signals.end(),
+                                                 [](int32_t signal) { return signal >= 0; }));
+    }
+
+    // physical value to raw bits; integers saturate at the signal's range
+    void MotecGenerator::encode(const MotecSignal& signal, double value, CANFrame& frame) const {
+        const SignalLayout& layout = signal.codec.layout();
+        const int bits = std::popcount(layout.mask);
+        const double scaled = (value - signal.offset) / signal.factor;
+
+        uint64_t raw;
+        if (signal.value_type == NumericValueType::f32 && bits == 32) {
+            raw = std::bit_cast<uint32_t>(static_cast<float>(scaled));
+        } else if (signal.value_type == NumericValueType::f64 && bits == 64) {
+            raw = std::bit_cast<uint64_t>(scaled);
+        } else if (layout.sign_bit) {
+            const double high = static_cast<double>(layout.sign_bit - 1);
+            raw = static_cast<uint64_t>(static_cast<int64_t>(std::round(std::clamp(scaled, -high - 1, high))));
+        } else {
+            raw = static_cast<uint64_t>(std::round(std::clamp(scaled, 0.0, static_cast<double>(layout.mask))));
+        }
+
+        signal.codec(raw & layout.mask, frame.data);
+    }
+
+    bool MotecGenerator::parse_data_row() {
+        const char* end = data + size;
+        while (cursor && cursor < end) {
+            if (*cursor == '\n' || *cursor == '\r') {
+                ++cursor;
+                continue;
+            }
+
+            std::fill(row_present.begin(), row_present.end(), 0);
+            std::optional<double> time;
+            size_t column = 0;
+            bool line_end = false;
+            while (!line_end) {
+                std::string_view field = next_field(cursor, end, line_end);
+                double value;
+                if (column < column_signals.size() && !field.empty() && parse_number(field, value)) {
+                    if (column == time_column) time = value;
+                    if (int32_t signal = column_signals[column]; signal >= 0) {
+                        const uint32_t frame = signal_frames[signal];
+                        encode(signals[signal], value, row_frames[frame].second);
+                        row_present[frame] = 1;
+                    }
+                }
+                ++column;
+            }
+            if (!time) continue;
+
+            const CANTime stamp = log_start + std::chrono::round<CANTime::duration>(std::chrono::duration<double>(*time));
+            for (auto& frame : row_frames) frame.first = stamp;
+            return true;
+        }
         return false;
     }
-}
\ No newline at end of file
+
+    const std::pair<CANTime, CANFrame>* MotecGenerator::get_frame() {
+        if (!data) return nullptr;
+
+        while (true) {
+            while (current < row_frames.size()) {
+                size_t frame = current++;
+                if (row_present[frame]) return &row_frames[frame];
+            }
+            if (!parse_data_row()) return nullptr;
+            current = 0;
+        }
+    }
+}
@@ -0,0 +1,395 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <span>
+#include <string_view>
+
+#include <unistd.h>
+
+#include "Candy/DBCInterpreters/MotecTranscoder.hpp"
+
+namespace {
+
+    // .ld layout, as read by i2 and ldparser: file header, event, channel
+    // list, then each channel's samples back to back
+    constexpr size_t header_size = 1762;
+    constexpr size_t event_size = 1154;
+    constexpr size_t channel_size = 124;
+
+    // channel data type: float32
+    constexpr uint16_t dtype_float = 0x07;
+    constexpr uint16_t dtype_size = 4;
+
+    template <typename T>
+    void put(std::vector<uint8_t>& out, size_t at, T value) {
+        std::memcpy(out.data() + at, &value, sizeof(T));
+    }
+
+    template <typename T>
+    T get(const std::vector<uint8_t>& in, size_t at) {
+        T value {};
+        if (at + sizeof(T) <= in.size()) std::memcpy(&value, in.data() + at, sizeof(T));
+        return value;
+    }
+
+    // a NUL-terminated field of `size` bytes
+    void put_text(std::vector<uint8_t>& out, size_t at, size_t size, std::string_view text) {
+        std::memcpy(out.data() + at, text.data(), std::min(text.size(), size - 1));
+    }
+
+    std::string_view get_text(const std::vector<uint8_t>& in, size_t at, size_t size) {
+        if (at + size > in.size()) return {};
+        const char* text = reinterpret_cast<const char*>(in.data() + at);
+        return std::string_view(text, strnlen(text, size));
+    }
+
+    std::string_view channel_name(std::string_view name) {
+        return name.substr(0, 31);
+    }
+
+}
+
+namespace Candy {
+
+    MotecTranscoder::MotecTranscoder(FILE* file, std::string path, const MotecHeader& header, size_t batch_size) :
+        FileTranscoder<MotecTranscoder>(batch_size, 0, 0),
+        file(file, fclose),
+        path(std::move(path)),
+        header(header)
+    {
+        decoded_signals_batch.reserve(batch_size);
+    }
+
+    MotecTranscoder::~MotecTranscoder() {
+        if (file) flush_all_batches();
+    }
+
+    MotecTranscoder::MotecTranscoder(MotecTranscoder&& other) noexcept :
+        FileTranscoder<MotecTranscoder>(std::move(other)),
+        file(std::move(other.file)),
+        path(std::move(other.path)),
+        header(std::move(other.header)),
+        decoded_signals_batch(std::move(other.decoded_signals_batch)),
+        decoded_fd_signals_batch(std::move(other.decoded_fd_signals_batch)),
+        decoded_columns(std::move(other.decoded_columns)),
+        series(std::move(other.series)),
+        start_time(other.start_time),
+        end_time(other.end_time)
+    {
+    }
+
+    MotecTranscoder& MotecTranscoder::operator=(MotecTranscoder&& other) noexcept {
+        if (this != &other) {
+            if (file) flush_all_batches();
+
+            FileTranscoder<MotecTranscoder>::operator=(std::move(other));
+            file = std::move(other.file);
+            path = std::move(other.path);
+            header = std::move(other.header);
+            decoded_signals_batch = std::move(other.decoded_signals_batch);
+            decoded_fd_signals_batch = std::move(other.decoded_fd_signals_batch);
+            decoded_columns = std::move(other.decoded_columns);
+            series = std::move(other.series);
+            start_time = other.start_time;
+            end_time = other.end_time;
+        }
+        return *this;
+    }
+
+    std::optional<MotecTranscoder> MotecTranscoder::create(const std::string& path, const MotecHeader& header, size_t batch_size) {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) {
+            std::cerr << "Failed to open MoTeC log for writing: " << path << std::endl;
+            return std::nullopt;
+        }
+        return std::make_optional<MotecTranscoder>(MotecTranscoder(file, path, header, std::max<size_t>(batch_size, 1)));
+    }
+
+    // CANIO
+    void MotecTranscoder::receive_raw_message(std::pair<CANTime, CANFrame> sample) {
+        if (auto slot = decode_table.find(sample.second.can_id))
+            batch_decoded_signals(sample, decode_table.message(*slot));
+
+        if (decoded_signals_batch_count >= batch_size) flush_decoded_signals_batch();
+    }
+
+    void MotecTranscoder::receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample) {
+        clear_padding(sample.second);
+        if (auto slot = decode_table.find(sample.second.can_id))
+            batch_decoded_signals(sample, decode_table.message(*slot));
+
+        if (decoded_signals_batch_count >= batch_size) flush_decoded_signals_batch();
+    }
+
+    // signals are decoded from the frame again, so values for ids outside the DBC are not kept
+    void MotecTranscoder::receive_message(const CANMessage& message) {
+        receive_raw_message(message.sample);
+    }
+
+    // kept in memory only; the log header comes from the MotecHeader
+    void MotecTranscoder::receive_metadata(const CANDataStreamMetadata& stream_metadata) {
+        metadata = stream_metadata;
+    }
+
+    // channels are named after signals; message names have no place in the log
+    void MotecTranscoder::store_message_metadata(canid_t, const std::string&, size_t) {
+    }
+
+    // transcoder methods
+    void MotecTranscoder::batch_frame(std::pair<CANTime, CANFrame>) {
+    }
+
+    void MotecTranscoder::batch_frame(const std::pair<CANTime, CANFlexibleFrame>&) {
+    }
+
+    void MotecTranscoder::batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg) {
+        // a classic frame of a message read past byte 8 is decoded zero padded
+        if (msg.payload_size > CAN_MAX_DLEN)
+            decoded_fd_signals_batch.emplace_back(sample.first, widen_frame(sample.second));
+        else
+            decoded_signals_batch.push_back(sample);
+        decoded_signals_batch_count++;
+    }
+
+    void MotecTranscoder::batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>& sample, const DecodeMessage&) {
+        decoded_fd_signals_batch.push_back(sample);
+        decoded_signals_batch_count++;
+    }
+
+    void MotecTranscoder::flush_frames_batch() {
+    }
+
+    void MotecTranscoder::flush_decoded_signals_batch() {
+        if (decoded_signals_batch_count == 0) return;
+
+        decode_series(decoded_signals_batch);
+        decode_series(decoded_fd_signals_batch);
+        decoded_signals_batch_count = 0;
+    }
+
+    void MotecTranscoder::flush_all_batches() {
+        flush_decoded_signals_batch();
+        write_log();
+    }
+
+    template <typename Frame>
+    void MotecTranscoder::decode_series(std::vector<std::pair<CANTime, Frame>>& batch) {
+        // group frames by message so each signal decodes as one contiguous column
+        std::stable_sort(batch.begin(), batch.end(), [](const auto& a, const auto& b) {
+            return a.second.can_id < b.second.can_id;
+        });
+        series.resize(decode_table.message_count());
+
+        auto run_begin = batch.begin();
+        while (run_begin != batch.end()) {
+            canid_t can_id = run_begin->second.can_id;
+            auto run_end = std::find_if(run_begin, batch.end(), [can_id](const auto& s) {
+                return s.second.can_id != can_id;
+            });
+
+            if (auto slot = decode_table.find(can_id)) {
+                std::span<const std::pair<CANTime, Frame>> run(&*run_begin, run_end - run_begin);
+                decoded_columns.decode(decode_table, *slot, run);
+
+                Series& message = series[*slot];
+                message.values.resize(decoded_columns.columns());
+                for (size_t row = 0; row < run.size(); ++row) {
+                    const int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        run[row].first.time_since_epoch()).count();
+                    start_time = std::min(start_time.value_or(timestamp), timestamp);
+                    end_time = std::max(end_time, timestamp);
+                    message.time.push_back(timestamp);
+
+                    auto mux_value = decoded_columns.mux(row);
+                    for (size_t col = 0; col < decoded_columns.columns(); ++col) {
+                        std::vector<float>& column = message.values[col];
+                        if (decode_table.is_active(decoded_columns.signal(col), mux_value))
+                            column.push_back(static_cast<float>(decoded_columns.values(col)[row]));
+                        else
+                            column.push_back(column.empty() ? 0.0f : column.back());
+                    }
+                }
+            }
+
+            run_begin = run_end;
+        }
+
+        batch.clear();
+    }
+
+    void MotecTranscoder::write_log() {
+        if (!file || !start_time) return;
+
+        struct Channel {
+            uint32_t slot;
+            uint32_t column;
+            uint16_t rate;
+            uint32_t samples;
+        };
+
+        std::vector<Channel> channels;
+        const double duration = static_cast<double>(end_time - *start_time) * 1e-9;
+        for (uint32_t slot = 0; slot < series.size(); ++slot) {
+            const Series& message = series[slot];
+            if (message.time.empty()) continue;
+
+            const double span = static_cast<double>(message.time.back() - message.time.front()) * 1e-9;
+            const double rate = span > 0 ? std::round(static_cast<double>(message.time.size() - 1) / span) : 1.0;
+            const auto hz = static_cast<uint16_t>(std::clamp(rate, 1.0, 65535.0));
+            const auto samples = static_cast<uint32_t>(std::floor(duration * hz)) + 1;
+            for (uint32_t column = 0; column < message.values.size(); ++column)
+                channels.push_back({ slot, column, hz, samples });
+        }
+
+        const size_t event_at = header_size;
+        const size_t channels_at = event_at + event_size;
+        size_t data_at = channels_at + channels.size() * channel_size;
+        size_t total = data_at;
+        for (const Channel& channel : channels) total += channel.samples * dtype_size;
+        std::vector<uint8_t> out(total, 0);
+
+        // file header; the constants are what i2 writes and checks
+        const time_t start_seconds = static_cast<time_t>(*start_time / 1000000000);
+        std::tm start {};
+        gmtime_r(&start_seconds, &start);
+        char date[16], clock[16];
+        std::strftime(date, sizeof(date), "%d/%m/%Y", &start);
+        std::strftime(clock, sizeof(clock), "%H:%M:%S", &start);
+
+        put<uint32_t>(out, 0, 0x40);
+        put<uint32_t>(out, 8, static_cast<uint32_t>(channels_at));
+        put<uint32_t>(out, 12, static_cast<uint32_t>(data_at));
+        put<uint32_t>(out, 36, static_cast<uint32_t>(event_at));
+        put<uint16_t>(out, 64, 1);
+        put<uint16_t>(out, 66, 0x4240);
+        put<uint16_t>(out, 68, 0xf);
+        put<uint32_t>(out, 70, 0x1f44);
+        put_text(out, 74, 8, "ADL");
+        put<uint16_t>(out, 82, 420);
+        put<uint16_t>(out, 84, 0xadb0);
+        put<uint32_t>(out, 86, static_cast<uint32_t>(channels.size()));
+        put_text(out, 94, 16, date);
+        put_text(out, 126, 16, clock);
+        put_text(out, 158, 64, header.driver);
+        put_text(out, 222, 64, header.vehicle);
+        put_text(out, 350, 64, header.venue);
+        put<uint32_t>(out, 1502, 0xc81a4);
+        put_text(out, 1572, 64, header.comment);
+
+        // event: name, session, comment, venue pointer (none)
+        put_text(out, event_at, 64, header.venue);
+        put_text(out, event_at + 64, 64, header.session);
+        put_text(out, event_at + 128, 1024, header.comment);
+
+        // channel list, linked both ways, and the samples of each
+        for (size_t i = 0; i < channels.size(); ++i) {
+            const Channel& channel = channels[i];
+            const Series& message = series[channel.slot];
+            const uint32_t signal = decode_table.message(channel.slot).first_signal + channel.column;
+            const size_t at = channels_at + i * channel_size;
+
+            put<uint32_t>(out, at, i > 0 ? static_cast<uint32_t>(at - channel_size) : 0);
+            put<uint32_t>(out, at + 4, i + 1 < channels.size() ? static_cast<uint32_t>(at + channel_size) : 0);
+            put<uint32_t>(out, at + 8, static_cast<uint32_t>(data_at));
+            put<uint32_t>(out, at + 12, channel.samples);
+            put<uint16_t>(out, at + 16, static_cast<uint16_t>(0x2ee1 + i));
+            put<uint16_t>(out, at + 18, dtype_float);
+            put<uint16_t>(out, at + 20, dtype_size);
+            put<uint16_t>(out, at + 22, channel.rate);
+            // shift, multiplier, scale, decimal places: stored values are physical
+            put<int16_t>(out, at + 24, 0);
+            put<int16_t>(out, at + 26, 1);
+            put<int16_t>(out, at + 28, 1);
+            put<int16_t>(out, at + 30, 0);
+            put_text(out, at + 32, 32, decode_table.signal_name(signal));
+            put_text(out, at + 64, 8, decode_table.signal_name(signal));
+            put_text(out, at + 72, 12, decode_table.unit(signal));
+
+            // sample and hold onto the channel's rate; before the first frame, its value
+            const std::vector<float>& values = message.values[channel.column];
+            size_t row = 0;
+            for (uint32_t sample = 0; sample < channel.samples; ++sample) {
+                const int64_t time = *start_time + static_cast<int64_t>(std::llround(sample * 1e9 / channel.rate));
+                while (row + 1 < message.time.size() && message.time[row + 1] <= time) ++row;
+                put<float>(out, data_at, values[row]);
+                data_at += dtype_size;
+            }
+        }
+
+        // the log is replaced whole: rates and lengths change as frames arrive
+        if (fseek(file.get(), 0, SEEK_SET) != 0 ||
+            fwrite(out.data(), 1, out.size(), file.get()) != out.size() ||
+            fflush(file.get()) != 0 ||
+            ftruncate(fileno(file.get()), static_cast<off_t>(out.size())) != 0) {
+            std::cerr << "Failed to write MoTeC log to " << path << std::endl;
+        }
+    }
+
+    // readback
+
+    std::vector<CANMessage> MotecTranscoder::transmit_messages(canid_t can_id) {
+        return transmit_messages_in_range(can_id, CANTime::min(), CANTime::max());
+    }
+
+    std::vector<CANMessage> MotecTranscoder::transmit_messages_in_range(canid_t can_id, CANTime start, CANTime end) {
+        std::vector<CANMessage> messages;
+        flush_all_batches();
+
+        auto slot = decode_table.find(can_id);
+        if (!slot || !start_time) return messages;
+        const DecodeMessage& msg = decode_table.message(*slot);
+
+        FILE* in = fopen(path.c_str(), "rb");
+        if (!in) return messages;
+        std::vector<uint8_t> log;
+        uint8_t chunk[65536];
+        size_t read;
+        while ((read = fread(chunk, 1, sizeof(chunk), in)) > 0)
+            log.insert(log.end(), chunk, chunk + read);
+        fclose(in);
+
+        // the message's channels, in signal order
+        std::vector<size_t> channels(msg.signal_count, 0);
+        uint32_t rate = 0;
+        uint32_t samples = 0;
+        for (size_t at = get<uint32_t>(log, 8); at != 0 && at + channel_size <= log.size(); at = get<uint32_t>(log, at + 4)) {
+            std::string_view name = get_text(log, at + 32, 32);
+            for (uint32_t i = 0; i < msg.signal_count; ++i) {
+                if (channels[i] || name != channel_name(decode_table.signal_name(msg.first_signal + i))) continue;
+                const size_t data_at = get<uint32_t>(log, at + 8);
+                samples = get<uint32_t>(log, at + 12);
+                rate = get<uint16_t>(log, at + 22);
+                if (data_at + size_t(samples) * dtype_size > log.size()) return messages;
+                channels[i] = data_at;
+                break;
+            }
+        }
+        if (rate == 0 || std::count(channels.begin(), channels.end(), 0) > 0) return messages;
+
+        const std::string_view message_name = decode_table.message_name(*slot);
+        for (uint32_t sample = 0; sample < samples; ++sample) {
+            const CANTime time = CANTime(std::chrono::duration_cast<CANTime::duration>(std::chrono::nanoseconds(
+                *start_time + static_cast<int64_t>(std::llround(sample * 1e9 / rate)))));
+            if (time < start || time > end) continue;
+
+            CANMessage& message = messages.emplace_back();
+            message.sample.first = time;
+            message.sample.second.can_id = can_id;
+            message.set_message_name(message_name);
+            for (uint32_t i = 0; i < msg.signal_count; ++i) {
+                const uint32_t signal = msg.first_signal + i;
+                message.add_signal(decode_table.signal_name(signal),
+                                   get<float>(log, channels[i] + size_t(sample) * dtype_size),
+                                   decode_table.unit(signal));
+            }
+        }
+        return messages;
+    }
+
+    const CANDataStreamMetadata& MotecTranscoder::transmit_metadata() {
+        return metadata;
+    }
+
+}
@@ -1,28 +1,65 @@
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 
 #include "Candy/DBCInterpreters/SQLTranscoder.hpp"
 
+namespace {
+    // "INSERT INTO table (columns) VALUES (?, ...), ..." with `rows` placeholder tuples
+    std::string multi_row_insert_sql(std::string_view table, std::string_view columns, int column_count, size_t rows) {
+        std::string tuple = "(";
+        for (int i = 0; i < column_count; ++i)
+            tuple += i ? ", ?" : "?";
+        tuple += ")";
+
+        std::string sql = "INSERT INTO " + std::string(table) + " (" + std::string(columns) + ") VALUES ";
+        sql.reserve(sql.size() + rows * (tuple.size() + 2));
+        for (size_t i = 0; i < rows; ++i) {
+            if (i) sql += ", ";
+            sql += tuple;
+        }
+        return sql;
+    }
+
+    // `column` as "XX XX ..." like the text schema stores it, for BLOBs of up
+    // to CANFD_MAX_DLEN bytes; bytes past the end add spaces that rtrim drops
+    std::string spaced_hex_sql(std::string_view column) {
+        std::string hex = "hex(" + std::string(column) + ")";
+        std::string sql = "rtrim(";
+        for (int i = 0; i < CANFD_MAX_DLEN; ++i) {
+            if (i) sql += " || ' ' || ";
+            sql += "substr(" + hex + ", " + std::to_string(2 * i + 1) + ", 2)";
+        }
+        return sql + ")";
+    }
+}
+
 namespace Candy {
 
-    SQLTranscoder::SQLTranscoder(sqlite3* raw_db, const std::string& db_file_path, size_t batch_size) : 
+    SQLTranscoder::SQLTranscoder(sqlite3* raw_db, const std::string& db_file_path, size_t batch_size, SQLSchema schema) : 
         FileTranscoder<SQLTranscoder>(batch_size, 0, 0),
         db_path(db_file_path),
         db(raw_db, sqlite3_close),
+        schema(schema),
         decoded_signals_insert_stmt(nullptr),
-        frames_insert_stmt(nullptr)
+        frames_insert_stmt(nullptr),
+        decoded_signals_multi_insert_stmt(nullptr),
+        frames_multi_insert_stmt(nullptr)
     {
+        frames_batch.reserve(batch_size);
+        decoded_signals_batch.reserve(batch_size);
     }
 
-    std::optional<SQLTranscoder> SQLTranscoder::create(const std::string& db_file_path, size_t batch_size) {
+    std::optional<SQLTranscoder> SQLTranscoder::create(const std::string& db_file_path, size_t batch_size, SQLSchema schema) {
         sqlite3* raw_db = nullptr;
         if (sqlite3_open(db_file_path.c_str(), &raw_db) != SQLITE_OK) {
             std::cerr << "Failed to open SQLite database: " + db_file_path << std::endl;
             return std::nullopt;
         }
 
-        SQLTranscoder transcoder(raw_db, db_file_path, batch_size);
+        SQLTranscoder transcoder(raw_db, db_file_path, batch_size, schema);
 
         transcoder.execute_sql("PRAGMA journal_mode=WAL");
         transcoder.execute_sql("PRAGMA synchronous=NORMAL");
@@ -38,6 +75,11 @@ namespace Candy {
     }
 
     SQLTranscoder::~SQLTranscoder() {
+        if (db) {
+            flush_all_batches();
+            // deferred so ingest before the first query does not maintain them
+            build_indexes();
+        }
         finalize_statements();
     }
 
@@ -45,25 +87,62 @@ namespace Candy {
         : FileTranscoder<SQLTranscoder>(std::move(other)),
           db(std::move(other.db)),
           db_path(std::move(other.db_path)),
+          read_db(std::move(other.read_db)),
+          range_query_stmt(other.range_query_stmt),
+          indexes_built(other.indexes_built),
+          schema(other.schema),
+          signals_stored(other.signals_stored),
           decoded_signals_insert_stmt(other.decoded_signals_insert_stmt),
-          frames_insert_stmt(other.frames_insert_stmt)
+          frames_insert_stmt(other.frames_insert_stmt),
+          decoded_signals_multi_insert_stmt(other.decoded_signals_multi_insert_stmt),
+          frames_multi_insert_stmt(other.frames_multi_insert_stmt),
+          frames_batch(std::move(other.frames_batch)),
+          next_frame_id(other.next_frame_id),
+          decoded_signals_batch(std::move(other.decoded_signals_batch)),
+          decoded_fd_signals_batch(std::move(other.decoded_fd_signals_batch)),
+          decoded_columns(std::move(other.decoded_columns)),
+          decoded_rows(other.decoded_rows),
+          decoded_row_count(other.decoded_row_count)
     {
+        other.decoded_row_count = 0;
         other.decoded_signals_insert_stmt = nullptr;
         other.frames_insert_stmt = nullptr;
+        other.decoded_signals_multi_insert_stmt = nullptr;
+        other.frames_multi_insert_stmt = nullptr;
+        other.range_query_stmt = nullptr;
     }
 
     SQLTranscoder& SQLTranscoder::operator=(SQLTranscoder&& other) noexcept {
         if (this != &other) {
+            if (db) flush_all_batches();
             finalize_statements();
             
             FileTranscoder<SQLTranscoder>::operator=(std::move(other));
             db = std::move(other.db);
             db_path = std::move(other.db_path);
+            read_db = std::move(other.read_db);
+            range_query_stmt = other.range_query_stmt;
+            indexes_built = other.indexes_built;
+            schema = other.schema;
+            signals_stored = other.signals_stored;
             decoded_signals_insert_stmt = other.decoded_signals_insert_stmt;
             frames_insert_stmt = other.frames_insert_stmt;
+            decoded_signals_multi_insert_stmt = other.decoded_signals_multi_insert_stmt;
+            frames_multi_insert_stmt = other.frames_multi_insert_stmt;
+            frames_batch = std::move(other.frames_batch);
+            next_frame_id = other.next_frame_id;
+            decoded_signals_batch = std::move(other.decoded_signals_batch);
+            decoded_fd_signals_batch = std::move(other.decoded_fd_signals_batch);
+            decoded_columns = std::move(other.decoded_columns);
+            decoded_rows = other.decoded_rows;
+            decoded_row_count = other.decoded_row_count;
             
+            other.decoded_row_count = 0;
             other.decoded_signals_insert_stmt = nullptr;
             other.frames_insert_stmt = nullptr;
+            other.decoded_signals_multi_insert_stmt = nullptr;
+            other.frames_multi_insert_stmt = nullptr;
+            other.range_query_stmt = nullptr;
         }
         return *this;
     }
@@ -79,14 +158,28 @@ namespace Candy {
 
     // Private Methods
     bool SQLTranscoder::prepare_statements() {
-        const char* frames_sql = "INSERT INTO frames (timestamp, can_id, dlc, data, message_name) VALUES (?, ?, ?, ?, ?)";
-        if (sqlite3_prepare_v2(db.get(), frames_sql, -1, &frames_insert_stmt, nullptr) != SQLITE_OK) {
+        const bool normalized = schema == SQLSchema::normalized;
+        const char* frames_table = normalized ? "frame_data" : "frames";
+        const char* frames_columns = normalized
+            ? "id, timestamp_us, can_id, data"
+            : "id, timestamp, can_id, dlc, data, message_name";
+        const char* decoded_table = normalized ? "signal_data" : "decoded_frames";
+        const char* decoded_columns_list = normalized
+            ? "timestamp_us, frame_id, signal_id, signal_value, raw_value, mux_value"
+            : "timestamp, frame_id, can_id, message_name, signal_name, signal_value, raw_value, unit, mux_value";
+
+        std::string frames_sql = multi_row_insert_sql(frames_table, frames_columns, frame_params(), 1);
+        std::string frames_multi_sql = multi_row_insert_sql(frames_table, frames_columns, frame_params(), rows_per_insert);
+        if (sqlite3_prepare_v2(db.get(), frames_sql.c_str(), -1, &frames_insert_stmt, nullptr) != SQLITE_OK ||
+            sqlite3_prepare_v2(db.get(), frames_multi_sql.c_str(), -1, &frames_multi_insert_stmt, nullptr) != SQLITE_OK) {
             std::cerr << "Failed to prepare frames insert statement" << std::endl;
             return false;
         }
 
-        const char* decoded_sql = "INSERT INTO decoded_frames (timestamp, can_id, message_name, signal_name, signal_value, raw_value, unit, mux_value) VALUES (?, ?, ?, ?, ?, ?, ?, ?)";
-        if (sqlite3_prepare_v2(db.get(), decoded_sql, -1, &decoded_signals_insert_stmt, nullptr) != SQLITE_OK) {
+        std::string decoded_sql = multi_row_insert_sql(decoded_table, decoded_columns_list, decoded_params(), 1);
+        std::string decoded_multi_sql = multi_row_insert_sql(decoded_table, decoded_columns_list, decoded_params(), rows_per_insert);
+        if (sqlite3_prepare_v2(db.get(), decoded_sql.c_str(), -1, &decoded_signals_insert_stmt, nullptr) != SQLITE_OK ||
+            sqlite3_prepare_v2(db.get(), decoded_multi_sql.c_str(), -1, &decoded_signals_multi_insert_stmt, nullptr) != SQLITE_OK) {
             std::cerr << "Failed to prepare decoded signals insert statement" << std::endl;
             return false;
         }
@@ -96,88 +189,205 @@ namespace Candy {
     void SQLTranscoder::finalize_statements() {
         if (frames_insert_stmt) sqlite3_finalize(frames_insert_stmt);
         if (decoded_signals_insert_stmt) sqlite3_finalize(decoded_signals_insert_stmt);
+        if (frames_multi_insert_stmt) sqlite3_finalize(frames_multi_insert_stmt);
+        if (decoded_signals_multi_insert_stmt) sqlite3_finalize(decoded_signals_multi_insert_stmt);
+        if (range_query_stmt) sqlite3_finalize(range_query_stmt);
     }
 
     void SQLTranscoder::batch_frame(std::pair<CANTime, CANFrame> sample) {
-        auto msg_it = messages.find(sample.second.can_id);
-        std::string message_name = (msg_it != messages.end()) ? std::string(msg_it->second.get_name()) : "";
+        frames_batch.emplace_back(sample.first, widen_frame(sample.second));
+        frames_batch_count++;
+        next_frame_id++;
+    }
+
+    void SQLTranscoder::batch_frame(const std::pair<CANTime, CANFlexibleFrame>& sample) {
+        frames_batch.push_back(sample);
+        frames_batch_count++;
+        next_frame_id++;
+    }
+
+    void SQLTranscoder::step_insert(sqlite3_stmt* stmt) {
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            std::cerr << "Failed to insert batch: " << sqlite3_errmsg(db.get()) << std::endl;
+        }
+        sqlite3_reset(stmt);
+    }
+
+    void SQLTranscoder::insert_frames() {
+        const int64_t first_id = next_frame_id - static_cast<int64_t>(frames_batch.size());
+        size_t i = 0;
+        for (; i + rows_per_insert <= frames_batch.size(); i += rows_per_insert) {
+            for (size_t row = 0; row < rows_per_insert; ++row)
+                bind_frame(frames_multi_insert_stmt, row * frame_params() + 1, first_id + i + row, frames_batch[i + row]);
+            step_insert(frames_multi_insert_stmt);
+        }
+        for (; i < frames_batch.size(); ++i) {
+            bind_frame(frames_insert_stmt, 1, first_id + i, frames_batch[i]);
+            step_insert(frames_insert_stmt);
+        }
+        frames_batch.clear();
+    }
+
+    void SQLTranscoder::bind_frame(sqlite3_stmt* stmt, int first_param, int64_t frame_id, const std::pair<CANTime, CANFlexibleFrame>& sample) {
+        const auto& [timestamp, frame] = sample;
+        const uint8_t len = std::min<uint8_t>(frame.length, CANFD_MAX_DLEN);
+        const uint8_t* data = frame.data;
+
+        sqlite3_bind_int64(stmt, first_param++, frame_id);
+
+        if (schema == SQLSchema::normalized) {
+            auto timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(timestamp.time_since_epoch()).count();
+            sqlite3_bind_int64(stmt, first_param, timestamp_us);
+            sqlite3_bind_int(stmt, first_param + 1, frame.can_id);
+            sqlite3_bind_blob(stmt, first_param + 2, data, len, SQLITE_STATIC);
+            return;
+        }
+
+        std::string_view message_name = decode_table.find_message_name(frame.can_id);
 
         std::string hex_data;
-        hex_data.reserve(sample.second.len * 3); // "XX " per byte
-        for (int i = 0; i < sample.second.len; i++) {
+        hex_data.reserve(len * 3); // "XX " per byte
+        for (int i = 0; i < len; i++) {
             char hex_buf[4];
-            snprintf(hex_buf, sizeof(hex_buf), "%02X", static_cast<unsigned>(sample.second.data[i]));
+            snprintf(hex_buf, sizeof(hex_buf), "%02X", static_cast<unsigned>(data[i]));
             hex_data += hex_buf;
-            if (i < sample.second.len - 1) hex_data += " ";
+            if (i < len - 1) hex_data += " ";
+        }
+
+        auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(timestamp.time_since_epoch()).count();
+
+        sqlite3_bind_int64(stmt, first_param, timestamp_ms);
+        sqlite3_bind_int(stmt, first_param + 1, frame.can_id);
+        sqlite3_bind_int(stmt, first_param + 2, len);
+        sqlite3_bind_text(stmt, first_param + 3, hex_data.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, first_param + 4, message_name.data(), message_name.size(), SQLITE_STATIC);
+    }
+
+    void SQLTranscoder::batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg) {
+        // a classic frame of a message read past byte 8 is decoded zero padded
+        if (msg.payload_size > CAN_MAX_DLEN)
+            decoded_fd_signals_batch.push_back({ { sample.first, widen_frame(sample.second) }, next_frame_id - 1 });
+        else
+            decoded_signals_batch.push_back({ sample, next_frame_id - 1 });
+        decoded_signals_batch_count++;
+    }
+
+    void SQLTranscoder::batch_decoded_signals(const std::pair<CANTime, CANFlexibleFrame>& sample, const DecodeMessage&) {
+        decoded_fd_signals_batch.push_back({ sample, next_frame_id - 1 });
+        decoded_signals_batch_count++;
+    }
+
+    void SQLTranscoder::insert_decoded_signals() {
+        if (schema == SQLSchema::normalized && !signals_stored)
+            store_signals();
+
+        insert_decoded_signals(decoded_signals_batch);
+        insert_decoded_signals(decoded_fd_signals_batch);
+
+        for (size_t i = 0; i < decoded_row_count; ++i) {
+            bind_decoded_row(decoded_signals_insert_stmt, 1, decoded_rows[i]);
+            step_insert(decoded_signals_insert_stmt);
         }
+        decoded_row_count = 0;
+    }
 
-        auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(sample.first.time_since_epoch()).count();
+    void SQLTranscoder::push_decoded_row(const DecodedRow& row) {
+        decoded_rows[decoded_row_count++] = row;
+        if (decoded_row_count < rows_per_insert) return;
 
-        sqlite3_bind_int64(frames_insert_stmt, 1, timestamp_ms);
-        sqlite3_bind_int(frames_insert_stmt, 2, sample.second.can_id);
-        sqlite3_bind_int(frames_insert_stmt, 3, sample.second.len);
-        // hex_data is already a string now
-        sqlite3_bind_text(frames_insert_stmt, 4, hex_data.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(frames_insert_stmt, 5, message_name.c_str(), -1, SQLITE_TRANSIENT);
+        // rows pushed by receive_message fill up outside a batch's transaction
+        const bool own_transaction = sqlite3_get_autocommit(db.get());
+        if (own_transaction) execute_sql("BEGIN TRANSACTION");
+        for (size_t i = 0; i < rows_per_insert; ++i)
+            bind_decoded_row(decoded_signals_multi_insert_stmt, i * decoded_params() + 1, decoded_rows[i]);
+        step_insert(decoded_signals_multi_insert_stmt);
+        if (own_transaction) execute_sql("COMMIT");
+        decoded_row_count = 0;
+    }
 
-        if (sqlite3_step(frames_insert_stmt) != SQLITE_DONE) {
-            std::cerr << "Failed to batch frame insert" << std::endl;
+    void SQLTranscoder::bind_decoded_row(sqlite3_stmt* stmt, int first_param, const DecodedRow& row) {
+        if (schema == SQLSchema::normalized) {
+            auto timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(row.timestamp.time_since_epoch()).count();
+            sqlite3_bind_int64(stmt, first_param, timestamp_us);
+            sqlite3_bind_int64(stmt, first_param + 1, row.frame_id);
+            sqlite3_bind_int(stmt, first_param + 2, row.signal);
+            sqlite3_bind_double(stmt, first_param + 3, row.value);
+            sqlite3_bind_int64(stmt, first_param + 4, row.raw);
+            if (row.mux) sqlite3_bind_int64(stmt, first_param + 5, *row.mux);
+            else sqlite3_bind_null(stmt, first_param + 5);
             return;
         }
 
-        sqlite3_reset(frames_insert_stmt);
-        frames_batch_count++;
+        auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(row.timestamp.time_since_epoch()).count();
+        std::string_view message_name = decode_table.message_name(row.slot);
+        std::string_view signal_name = decode_table.signal_name(row.signal);
+        std::string_view unit = decode_table.unit(row.signal);
+
+        sqlite3_bind_int64(stmt, first_param++, timestamp_ms);
+        sqlite3_bind_int64(stmt, first_param, row.frame_id);
+        sqlite3_bind_int(stmt, first_param + 1, row.can_id);
+        sqlite3_bind_text(stmt, first_param + 2, message_name.data(), message_name.size(), SQLITE_STATIC);
+        sqlite3_bind_text(stmt, first_param + 3, signal_name.data(), signal_name.size(), SQLITE_STATIC);
+        sqlite3_bind_double(stmt, first_param + 4, row.value);
+        sqlite3_bind_int64(stmt, first_param + 5, row.raw);
+        sqlite3_bind_text(stmt, first_param + 6, unit.data(), unit.size(), SQLITE_STATIC);
+        if (row.mux) sqlite3_bind_int64(stmt, first_param + 7, *row.mux);
+        else sqlite3_bind_null(stmt, first_param + 7);
     }
 
-    void SQLTranscoder::batch_decoded_signals(std::pair<CANTime, CANFrame> sample, const MessageDefinition& msg_def) {
-        auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(sample.first.time_since_epoch()).count();
+    template <typename Frame>
+    void SQLTranscoder::insert_decoded_signals(std::vector<DecodedSample<Frame>>& batch) {
+        // group frames by message so each signal decodes as one contiguous column
+        std::sort(batch.begin(), batch.end(), [](const auto& a, const auto& b) {
+            if (a.sample.second.can_id != b.sample.second.can_id)
+                return a.sample.second.can_id < b.sample.second.can_id;
+            if (a.sample.first != b.sample.first)
+                return a.sample.first < b.sample.first;
+            return a.frame_id < b.frame_id;
+        });
 
-        std::optional<uint64_t> mux_value;
-        if (msg_def.multiplexer.has_value()) {
-            uint64_t raw_mux = (*msg_def.multiplexer->codec)(sample.second.data);
-            mux_value = raw_mux;
-        }
+        auto run_begin = batch.begin();
+        while (run_begin != batch.end()) {
+            canid_t can_id = run_begin->sample.second.can_id;
+            auto run_end = std::find_if(run_begin, batch.end(), [can_id](const auto& s) {
+                return s.sample.second.can_id != can_id;
+            });
 
-        for (size_t i = 0; i < msg_def.signal_count && i < msg_def.signals.size(); ++i) {
-            const auto& signal = msg_def.signals[i];
-            
-            // Skip signals with null pointers
-            if (!signal.codec || !signal.numeric_value) {
-                continue;
-            }
-            
-            if (signal.mux_val.has_value() && (!mux_value || mux_value.value() != signal.mux_val.value())) {
-                continue;
-            }
+            if (auto slot = decode_table.find(can_id)) {
+                std::span<const DecodedSample<Frame>> run(&*run_begin, run_end - run_begin);
+                decoded_columns.decode(decode_table, *slot, run.front().sample.second.data, sizeof(DecodedSample<Frame>), run.size());
 
-            uint64_t raw_value = (*signal.codec)(sample.second.data);
-            auto converted_value = signal.numeric_value->convert(raw_value, signal.value_type);
-            if (!converted_value.has_value()) continue;
-
-            sqlite3_bind_int64(decoded_signals_insert_stmt, 1, timestamp_ms);
-            sqlite3_bind_int(decoded_signals_insert_stmt, 2, sample.second.can_id);
-            sqlite3_bind_text(decoded_signals_insert_stmt, 3, msg_def.get_name().data(), -1, SQLITE_STATIC);
-            sqlite3_bind_text(decoded_signals_insert_stmt, 4, signal.get_name().data(), -1, SQLITE_STATIC);
-            sqlite3_bind_double(decoded_signals_insert_stmt, 5, converted_value.value());
-            sqlite3_bind_int64(decoded_signals_insert_stmt, 6, raw_value);
-            sqlite3_bind_text(decoded_signals_insert_stmt, 7, signal.get_unit().data(), -1, SQLITE_STATIC);
-            if (mux_value) sqlite3_bind_int64(decoded_signals_insert_stmt, 8, mux_value.value());
-            else sqlite3_bind_null(decoded_signals_insert_stmt, 8);
-
-            if (sqlite3_step(decoded_signals_insert_stmt) != SQLITE_DONE) {
-                std::cerr << "Failed to batch decoded signal insert" << std::endl;
-                return;
-            }
+                for (size_t row = 0; row < run.size(); ++row) {
+                    auto mux_value = decoded_columns.mux(row);
 
-            sqlite3_reset(decoded_signals_insert_stmt);
-            decoded_signals_batch_count++;
+                    for (size_t col = 0; col < decoded_columns.columns(); ++col) {
+                        const uint32_t signal = decoded_columns.signal(col);
+                        if (!decode_table.is_active(signal, mux_value)) continue;
+
+                        push_decoded_row({
+                            .timestamp = run[row].sample.first,
+                            .frame_id = run[row].frame_id,
+                            .can_id = can_id,
+                            .slot = *slot,
+                            .signal = signal,
+                            .value = decoded_columns.values(col)[row],
+                            .raw = static_cast<int64_t>(decoded_columns.raw(col)[row]),
+                            .mux = mux_value
+                        });
+                    }
+                }
+            }
 
+            run_begin = run_end;
         }
+
+        batch.clear();
     }
 
     void SQLTranscoder::flush_frames_batch() {
         if (frames_batch_count == 0) return;
         execute_sql("BEGIN TRANSACTION");
+        insert_frames();
         execute_sql("COMMIT");
         frames_batch_count = 0;
     }
@@ -185,6 +395,7 @@ namespace Candy {
     void SQLTranscoder::flush_decoded_signals_batch() {
         if (decoded_signals_batch_count == 0) return;
         execute_sql("BEGIN TRANSACTION");
+        insert_decoded_signals();
         execute_sql("COMMIT");
         decoded_signals_batch_count = 0;
     }
@@ -192,6 +403,8 @@ namespace Candy {
     void SQLTranscoder::flush_all_batches() {
         if (frames_batch_count > 0 || decoded_signals_batch_count > 0) {
             execute_sql("BEGIN TRANSACTION");
+            insert_frames();
+            insert_decoded_signals();
             execute_sql("COMMIT");
             frames_batch_count = 0;
             decoded_signals_batch_count = 0;
@@ -249,6 +462,7 @@ namespace Candy {
             CREATE TABLE IF NOT EXISTS decoded_frames (
                 id INTEGER PRIMARY KEY AUTOINCREMENT,
                 timestamp INTEGER,
+                frame_id INTEGER,
                 can_id INTEGER,
                 message_name TEXT,
                 signal_name TEXT,
@@ -259,10 +473,13 @@ namespace Candy {
             );
         )";
 
-        execute_sql("DROP TABLE IF EXISTS messages");
-        execute_sql("DROP TABLE IF EXISTS signals");
-        execute_sql("DROP TABLE IF EXISTS frames");
-        execute_sql("DROP TABLE IF EXISTS decoded_frames");
+        for (const char* name : {"frames", "decoded_frames", "frame_data", "signal_data", "messages", "signals"})
+            drop_relation(name);
+
+        if (schema == SQLSchema::normalized) {
+            create_normalized_tables();
+            return;
+        }
 
         execute_sql(create_signals_table);
         execute_sql(create_messages_table);
@@ -270,6 +487,128 @@ namespace Candy {
         execute_sql(create_decoded_frames_table);
     }
 
+    void SQLTranscoder::create_normalized_tables() {
+        // signals.id is the DecodeTable signal index
+        const char* create_signals_table = R"(
+            CREATE TABLE signals (
+                id INTEGER PRIMARY KEY,
+                can_id INTEGER,
+                message_name TEXT,
+                signal_name TEXT,
+                unit TEXT
+            );
+        )";
+
+        const char* create_messages_table = R"(
+            CREATE TABLE messages (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                message_id INTEGER,
+                message_name TEXT,
+                message_size INTEGER
+            );
+        )";
+
+        const char* create_frame_data_table = R"(
+            CREATE TABLE frame_data (
+                id INTEGER PRIMARY KEY,
+                timestamp_us INTEGER,
+                can_id INTEGER,
+                data BLOB
+            );
+        )";
+
+        const char* create_signal_data_table = R"(
+            CREATE TABLE signal_data (
+                timestamp_us INTEGER,
+                frame_id INTEGER,
+                signal_id INTEGER,
+                signal_value REAL,
+                raw_value INTEGER,
+                mux_value INTEGER
+            );
+        )";
+
+        const std::string create_frames_view = R"(
+            CREATE VIEW frames AS
+            SELECT f.id,
+                   f.timestamp_us / 1000 AS timestamp,
+                   f.can_id,
+                   length(f.data) AS dlc,
+                   )" + spaced_hex_sql("f.data") + R"( AS data,
+                   coalesce((SELECT m.message_name FROM messages m WHERE m.message_id = f.can_id LIMIT 1), '') AS message_name
+            FROM frame_data f;
+        )";
+
+        const char* create_decoded_frames_view = R"(
+            CREATE VIEW decoded_frames AS
+            SELECT d.rowid AS id,
+                   d.timestamp_us / 1000 AS timestamp,
+                   d.frame_id,
+                   s.can_id,
+                   s.message_name,
+                   s.signal_name,
+                   d.signal_value,
+                   d.raw_value,
+                   s.unit,
+                   d.mux_value
+            FROM signal_data d JOIN signals s ON s.id = d.signal_id;
+        )";
+
+        execute_sql(create_signals_table);
+        execute_sql(create_messages_table);
+        execute_sql(create_frame_data_table);
+        execute_sql(create_signal_data_table);
+        execute_sql(create_frames_view);
+        execute_sql(create_decoded_frames_view);
+    }
+
+    void SQLTranscoder::drop_relation(const char* name) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db.get(), "SELECT type FROM sqlite_master WHERE name = ?", -1, &stmt, nullptr) != SQLITE_OK)
+            return;
+
+        sqlite3_bind_text(stmt, 1, name, -1, SQLITE_STATIC);
+        std::string type;
+        if (sqlite3_step(stmt) == SQLITE_ROW)
+            type = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        sqlite3_finalize(stmt);
+
+        if (type == "table")
+            execute_sql("DROP TABLE " + std::string(name));
+        else if (type == "view")
+            execute_sql("DROP VIEW " + std::string(name));
+    }
+
+    void SQLTranscoder::store_signals() {
+        sqlite3_stmt* stmt;
+        const char* sql = "INSERT OR REPLACE INTO signals (id, can_id, message_name, signal_name, unit) VALUES (?, ?, ?, ?, ?)";
+        if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare signals insert statement" << std::endl;
+            return;
+        }
+
+        auto ids = decode_table.ids();
+        for (uint32_t slot = 0; slot < ids.size(); ++slot) {
+            const DecodeMessage& msg = decode_table.message(slot);
+            std::string_view message_name = decode_table.message_name(slot);
+
+            for (uint32_t signal = msg.first_signal; signal < msg.first_signal + msg.signal_count; ++signal) {
+                std::string_view signal_name = decode_table.signal_name(signal);
+                std::string_view unit = decode_table.unit(signal);
+
+                sqlite3_bind_int(stmt, 1, signal);
+                sqlite3_bind_int(stmt, 2, ids[slot]);
+                sqlite3_bind_text(stmt, 3, message_name.data(), message_name.size(), SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 4, signal_name.data(), signal_name.size(), SQLITE_STATIC);
+                sqlite3_bind_text(stmt, 5, unit.data(), unit.size(), SQLITE_STATIC);
+                step_insert(stmt);
+            }
+        }
+
+        sqlite3_finalize(stmt);
+        signals_stored = true;
+    }
+
     void SQLTranscoder::execute_sql(const std::string& sql) {
         char* err_msg = nullptr;
         if (sqlite3_exec(db.get(), sql.c_str(), nullptr, nullptr, &err_msg) != SQLITE_OK) {
@@ -293,11 +632,25 @@ namespace Candy {
     void SQLTranscoder::receive_raw_message(std::pair<CANTime, CANFrame> sample) {
         batch_frame(sample);
 
-        auto msg_it = messages.find(sample.second.can_id);
-        if (msg_it != messages.end()) {
-            batch_decoded_signals(sample, msg_it->second);
+        if (auto slot = decode_table.find(sample.second.can_id)) {
+            batch_decoded_signals(sample, decode_table.message(*slot));
+        }
+
+        flush_full_batches();
+    }
+
+    void SQLTranscoder::receive_raw_message(std::pair<CANTime, CANFlexibleFrame> sample) {
+        clear_padding(sample.second);
+        batch_frame(sample);
+
+        if (auto slot = decode_table.find(sample.second.can_id)) {
+            batch_decoded_signals(sample, decode_table.message(*slot));
         }
 
+        flush_full_batches();
+    }
+
+    void SQLTranscoder::flush_full_batches() {
         if (frames_batch_count >= batch_size) {
             flush_frames_batch();
         } 
@@ -311,11 +664,36 @@ namespace Candy {
             message.sample.first.time_since_epoch()).count();
         
         receive_raw_message(message.sample);
+        const int64_t frame_id = next_frame_id - 1;
         
         if (message.signal_count > 0) {
+            auto slot = decode_table.find(message.sample.second.can_id);
+
             for (size_t i = 0; i < message.signal_count && i < message.decoded_signals.size(); ++i) {
                 const auto& signal_entry = message.decoded_signals[i];
                 if (!signal_entry.is_valid) continue;
+
+                if (schema == SQLSchema::normalized) {
+                    // rows need a signals key, so signals outside the DBC are skipped
+                    if (!slot) break;
+                    const DecodeMessage& msg = decode_table.message(*slot);
+                    for (uint32_t signal = msg.first_signal; signal < msg.first_signal + msg.signal_count; ++signal) {
+                        if (decode_table.signal_name(signal) != signal_entry.get_name()) continue;
+                        push_decoded_row({
+                            .timestamp = message.sample.first,
+                            .frame_id = frame_id,
+                            .can_id = message.sample.second.can_id,
+                            .slot = *slot,
+                            .signal = signal,
+                            .value = signal_entry.value,
+                            .raw = 0,
+                            .mux = message.mux_value
+                        });
+                        decoded_signals_batch_count++;
+                        break;
+                    }
+                    continue;
+                }
                 
                 std::string signal_name = std::string(signal_entry.get_name());
                 double signal_value = signal_entry.value;
@@ -323,16 +701,17 @@ namespace Candy {
                 
                 // Directly insert into decoded_frames table
                 sqlite3_bind_int64(decoded_signals_insert_stmt, 1, timestamp_ms);
-                sqlite3_bind_int(decoded_signals_insert_stmt, 2, message.sample.second.can_id);
-                sqlite3_bind_text(decoded_signals_insert_stmt, 3, message.get_message_name().data(), -1, SQLITE_TRANSIENT);
-                sqlite3_bind_text(decoded_signals_insert_stmt, 4, signal_name.c_str(), -1, SQLITE_TRANSIENT);
-                sqlite3_bind_double(decoded_signals_insert_stmt, 5, signal_value);
-                sqlite3_bind_int64(decoded_signals_insert_stmt, 6, 0); // raw_value not available
-                sqlite3_bind_text(decoded_signals_insert_stmt, 7, unit.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_int64(decoded_signals_insert_stmt, 2, frame_id);
+                sqlite3_bind_int(decoded_signals_insert_stmt, 3, message.sample.second.can_id);
+                sqlite3_bind_text(decoded_signals_insert_stmt, 4, message.get_message_name().data(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(decoded_signals_insert_stmt, 5, signal_name.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_double(decoded_signals_insert_stmt, 6, signal_value);
+                sqlite3_bind_int64(decoded_signals_insert_stmt, 7, 0); // raw_value not available
+                sqlite3_bind_text(decoded_signals_insert_stmt, 8, unit.c_str(), -1, SQLITE_TRANSIENT);
                 if (message.mux_value) {
-                    sqlite3_bind_int64(decoded_signals_insert_stmt, 8, *message.mux_value);
+                    sqlite3_bind_int64(decoded_signals_insert_stmt, 9, *message.mux_value);
                 } else {
-                    sqlite3_bind_null(decoded_signals_insert_stmt, 8);
+                    sqlite3_bind_null(decoded_signals_insert_stmt, 9);
                 }
                 
                 if (sqlite3_step(decoded_signals_insert_stmt) != SQLITE_DONE) {
@@ -409,74 +788,136 @@ namespace Candy {
         canid_t can_id, CANTime start, CANTime end) {
         
         std::vector<CANMessage> messages;
-        
-        // Open database connection for transmiting
-        sqlite3* db;
-        if (sqlite3_open(db_path.c_str(), &db) != SQLITE_OK) {
-            std::cerr << "Failed to open database for transmiting" << std::endl;
-            return {};
+        flush_all_batches();
+        build_indexes();
+
+        if (!range_query_stmt && !prepare_range_query()) {
+            return messages;
         }
         
-        auto start_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            start.time_since_epoch()).count();
-        auto end_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            end.time_since_epoch()).count();
-        
-        // Query frames
-        std::string frames_sql = 
-            "SELECT timestamp, can_id, dlc, data, message_name FROM frames "
-            "WHERE can_id = ? AND timestamp >= ? AND timestamp <= ? "
-            "ORDER BY timestamp";
-        
-        sqlite3_stmt* stmt;
-        if (sqlite3_prepare_v2(db, frames_sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-            sqlite3_bind_int(stmt, 1, can_id);
-            sqlite3_bind_int64(stmt, 2, start_ms);
-            sqlite3_bind_int64(stmt, 3, end_ms);
-            
-            while (sqlite3_step(stmt) == SQLITE_ROW) {
-                CANMessage message;
-                
-                // Parse timestamp
-                auto timestamp_ms = sqlite3_column_int64(stmt, 0);
-                message.sample.first = std::chrono::system_clock::time_point(
-                    std::chrono::milliseconds(timestamp_ms));
-                
-                // Parse frame data
-                message.sample.second.can_id = sqlite3_column_int(stmt, 1);
-                message.sample.second.len = sqlite3_column_int(stmt, 2);
-                
-                // Parse hex data
-                const char* hex_data = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-                if (hex_data) {
-                    parse_hex_data(hex_data, message.sample.second.data, message.sample.second.len);
+        const bool normalized = schema == SQLSchema::normalized;
+        auto to_stored_time = [normalized](CANTime t) -> int64_t {
+            if (normalized)
+                return std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch()).count();
+            return std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count();
+        };
+
+        sqlite3_stmt* stmt = range_query_stmt;
+        sqlite3_bind_int(stmt, 1, can_id);
+        sqlite3_bind_int64(stmt, 2, to_stored_time(start));
+        sqlite3_bind_int64(stmt, 3, to_stored_time(end));
+
+        // one row per (frame, decoded signal), frames in time order
+        int64_t current_frame = -1;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            int64_t frame_id = sqlite3_column_int64(stmt, 0);
+
+            if (frame_id != current_frame) {
+                current_frame = frame_id;
+                CANMessage& message = messages.emplace_back();
+
+                auto stored_time = sqlite3_column_int64(stmt, 1);
+                message.sample.first = normalized
+                    ? CANTime(std::chrono::microseconds(stored_time))
+                    : CANTime(std::chrono::milliseconds(stored_time));
+                message.sample.second.can_id = can_id;
+
+                // CAN FD rows keep only their first 8 bytes in a CANMessage
+                if (normalized) {
+                    message.sample.second.len = std::min(sqlite3_column_bytes(stmt, 2), CAN_MAX_DLEN);
+                    if (const void* blob = sqlite3_column_blob(stmt, 2))
+                        std::memcpy(message.sample.second.data, blob, message.sample.second.len);
+                } else {
+                    message.sample.second.len = std::min(sqlite3_column_int(stmt, 3), CAN_MAX_DLEN);
+                    if (const char* hex_data = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)))
+                        parse_hex_data(hex_data, message.sample.second.data, message.sample.second.len);
                 }
-                
-                // Get message name
-                const char* msg_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-                if (msg_name) {
+
+                if (const char* msg_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4)))
                     message.set_message_name(msg_name);
-                }
-                
-                messages.push_back(std::move(message));
             }
-            
-            sqlite3_finalize(stmt);
+
+            // frames without decoded rows come back once with NULL signal columns
+            if (sqlite3_column_type(stmt, 6) == SQLITE_NULL) continue;
+
+            CANMessage& message = messages.back();
+            const char* signal_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+            const char* unit = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 7));
+            if (signal_name)
+                message.add_signal(signal_name, sqlite3_column_double(stmt, 6), unit ? unit : "");
+            if (sqlite3_column_type(stmt, 8) != SQLITE_NULL)
+                message.mux_value = sqlite3_column_int64(stmt, 8);
         }
-        
-        // Query decoded signals for these messages
-        load_decoded_signals_for_messages(db, messages);
-        
-        sqlite3_close(db);
+
+        sqlite3_reset(stmt);
         return messages;
     }
 
+    void SQLTranscoder::build_indexes() {
+        if (indexes_built) return;
+
+        if (schema == SQLSchema::normalized) {
+            execute_sql("CREATE INDEX IF NOT EXISTS frame_data_by_time ON frame_data (can_id, timestamp_us)");
+            // covers the range query's signal_data lookups
+            execute_sql("CREATE INDEX IF NOT EXISTS signal_data_by_frame ON signal_data (frame_id, signal_id, signal_value, mux_value)");
+        } else {
+            execute_sql("CREATE INDEX IF NOT EXISTS frames_by_time ON frames (can_id, timestamp)");
+            execute_sql("CREATE INDEX IF NOT EXISTS decoded_frames_by_frame ON decoded_frames (frame_id)");
+        }
+        indexes_built = true;
+    }
+
+    bool SQLTranscoder::open_read_db() {
+        if (read_db) return true;
+
+        sqlite3* raw_db = nullptr;
+        if (sqlite3_open_v2(db_path.c_str(), &raw_db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to open database for transmiting" << std::endl;
+            sqlite3_close(raw_db);
+            return false;
+        }
+        read_db.reset(raw_db);
+        return true;
+    }
+
+    bool SQLTranscoder::prepare_range_query() {
+        if (!open_read_db()) return false;
+
+        // columns: frame id, timestamp, data, dlc, message name, signal name, value, unit, mux
+        const char* text_sql = R"(
+            SELECT f.id, f.timestamp, f.data, f.dlc, f.message_name,
+                   d.signal_name, d.signal_value, d.unit, d.mux_value
+            FROM frames f
+            LEFT JOIN decoded_frames d ON d.frame_id = f.id
+            WHERE f.can_id = ?1 AND f.timestamp >= ?2 AND f.timestamp <= ?3
+            ORDER BY f.timestamp, f.id, d.id
+        )";
+
+        const char* normalized_sql = R"(
+            SELECT f.id, f.timestamp_us, f.data, length(f.data),
+                   (SELECT m.message_name FROM messages m WHERE m.message_id = f.can_id LIMIT 1),
+                   s.signal_name, d.signal_value, s.unit, d.mux_value
+            FROM frame_data f
+            LEFT JOIN signal_data d ON d.frame_id = f.id
+            LEFT JOIN signals s ON s.id = d.signal_id
+            WHERE f.can_id = ?1 AND f.timestamp_us >= ?2 AND f.timestamp_us <= ?3
+            ORDER BY f.timestamp_us, f.id, d.signal_id
+        )";
+
+        const char* sql = schema == SQLSchema::normalized ? normalized_sql : text_sql;
+        if (sqlite3_prepare_v2(read_db.get(), sql, -1, &range_query_stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare range query: " << sqlite3_errmsg(read_db.get()) << std::endl;
+            range_query_stmt = nullptr;
+            return false;
+        }
+        return true;
+    }
+
     const CANDataStreamMetadata& SQLTranscoder::transmit_metadata() {        
-        sqlite3* db;
-        if (sqlite3_open(db_path.c_str(), &db) != SQLITE_OK) {
-            std::cerr << "Failed to open database for transmiting metadata" << std::endl;
+        if (!open_read_db()) {
             return metadata;
         }
+        sqlite3* db = read_db.get();
         
         const char* meta_sql = "SELECT * FROM metadata LIMIT 1";
         sqlite3_stmt* stmt;
@@ -513,7 +954,6 @@ namespace Candy {
             sqlite3_finalize(stmt);
         }
         
-        sqlite3_close(db);
         return metadata;
     }
 
@@ -533,56 +973,6 @@ namespace Candy {
         )";
     }
 
-    void SQLTranscoder::load_decoded_signals_for_messages(sqlite3* db, std::vector<CANMessage>& messages) {
-        if (messages.empty()) return;
-        
-        // Build a map for quick lookup
-        std::unordered_map<std::string, size_t> message_lookup;
-        for (size_t i = 0; i < messages.size(); ++i) {
-            auto timestamp_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                messages[i].sample.first.time_since_epoch()).count();
-            std::string key = std::to_string(timestamp_ms) + "_" + std::to_string(messages[i].sample.second.can_id);
-            message_lookup[key] = i;
-        }
-        
-        // Query decoded signals
-        const char* signals_sql = 
-            "SELECT timestamp, can_id, signal_name, signal_value, unit, mux_value "
-            "FROM decoded_frames WHERE can_id = ? "
-            "ORDER BY timestamp";
-        
-        sqlite3_stmt* stmt;
-        if (sqlite3_prepare_v2(db, signals_sql, -1, &stmt, nullptr) == SQLITE_OK) {
-            sqlite3_bind_int(stmt, 1, messages[0].sample.second.can_id);
-            
-            while (sqlite3_step(stmt) == SQLITE_ROW) {
-                auto timestamp_ms = sqlite3_column_int64(stmt, 0);
-                auto can_id = sqlite3_column_int(stmt, 1);
-                
-                std::string key = std::to_string(timestamp_ms) + "_" + std::to_string(can_id);
-                auto it = message_lookup.find(key);
-                if (it != message_lookup.end()) {
-                    size_t msg_idx = it->second;
-                    
-                    const char* signal_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-                    double signal_value = sqlite3_column_double(stmt, 3);
-                    const char* unit = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-                    
-                    if (signal_name) {
-                        const char* unit_str = unit ? unit : "";
-                        messages[msg_idx].add_signal(signal_name, signal_value, unit_str);
-                    }
-                    
-                    if (sqlite3_column_type(stmt, 5) != SQLITE_NULL) {
-                        messages[msg_idx].mux_value = sqlite3_column_int64(stmt, 5);
-                    }
-                }
-            }
-            
-            sqlite3_finalize(stmt);
-        }
-    }
-
     void SQLTranscoder::parse_hex_data(const std::string& hex_str, uint8_t* data, size_t len) {
         size_t pos = 0;
         size_t i = 0;
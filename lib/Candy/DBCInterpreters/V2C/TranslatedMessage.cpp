@@ -1,10 +1,13 @@
 
 #include <algorithm>
-#include <bit>
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <variant>
 #include <vector>
 #include <cstdint>
 
+#include "Candy/Core/CANHelpers.hpp"
 #include "Candy/DBCInterpreters/V2C/SignalAssembly.hpp"
 
 #include "Candy/DBCInterpreters/V2C/TranslatedMessage.hpp"
@@ -12,15 +15,9 @@
 namespace Candy {
 
     template <typename Numeric>
-    uint64_t LastSignal<Numeric>::assemble(int64_t mux_val, uint64_t fd) {
-        if (!this->_sig.is_active(mux_val))
-            return 0;
-
-        uint64_t decoded = this->_sig.decode(fd);
-        Numeric val = *reinterpret_cast<const Numeric*>(&decoded);
+    Numeric LastSignal<Numeric>::update(Numeric val) {
         this->_val = val;
-        uint64_t raw = *reinterpret_cast<const uint64_t*>(&val);
-        return this->_sig.encode(raw);
+        return val;
     }
 
     template <typename Numeric>
@@ -29,24 +26,15 @@ namespace Candy {
     }
 
     template <typename Numeric>
-    uint64_t AverageSignal<Numeric>::assemble(int64_t mux_val, uint64_t fd) {
-        if (!this->_sig.is_active(mux_val))
-            return 0;
-
-        uint64_t decoded = this->_sig.decode(fd);
-        Numeric val = *reinterpret_cast<const Numeric*>(&decoded);
+    Numeric AverageSignal<Numeric>::update(Numeric val) {
         this->_val = (_num_samples == 0) ? val : this->_val + val;
         ++_num_samples;
 
-        Numeric result;
         if constexpr (std::is_integral_v<Numeric>) {
-            result = (this->_val < 0) ? (this->_val - _num_samples / 2) / _num_samples : (this->_val + _num_samples / 2) / _num_samples;
+            return (this->_val < 0) ? (this->_val - _num_samples / 2) / _num_samples : (this->_val + _num_samples / 2) / _num_samples;
         } else {
-            result = this->_val / _num_samples;
+            return this->_val / _num_samples;
         }
-        
-        uint64_t raw = *reinterpret_cast<const uint64_t*>(&result);
-        return this->_sig.encode(raw);
     }
 
     template <typename Numeric>
@@ -55,6 +43,100 @@ namespace Candy {
         _num_samples = 0;
     }
 
+    // a negative factor reverses the raw order
+    template <typename Numeric>
+    Numeric MinSignal<Numeric>::update(Numeric val) {
+        const bool lower = this->_sig.factor() < 0 ? val > this->_val : val < this->_val;
+        if (!_seen || lower)
+            this->_val = val;
+        _seen = true;
+        return this->_val;
+    }
+
+    template <typename Numeric>
+    void MinSignal<Numeric>::reset() {
+        _seen = false;
+    }
+
+    template <typename Numeric>
+    Numeric MaxSignal<Numeric>::update(Numeric val) {
+        const bool higher = this->_sig.factor() < 0 ? val < this->_val : val > this->_val;
+        if (!_seen || higher)
+            this->_val = val;
+        _seen = true;
+        return this->_val;
+    }
+
+    template <typename Numeric>
+    void MaxSignal<Numeric>::reset() {
+        _seen = false;
+    }
+
+    template <typename Numeric>
+    Numeric RmsSignal<Numeric>::update(Numeric val) {
+        const double physical = this->_sig.to_physical(static_cast<double>(val));
+        _sum_squares += physical * physical;
+        ++_num_samples;
+
+        this->_val = this->_sig.template from_physical<Numeric>(std::sqrt(_sum_squares / _num_samples));
+        return this->_val;
+    }
+
+    template <typename Numeric>
+    void RmsSignal<Numeric>::reset() {
+        _sum_squares = 0;
+        _num_samples = 0;
+    }
+
+    template <typename Numeric>
+    Numeric CountSignal<Numeric>::update(Numeric) {
+        ++_num_samples;
+        this->_val = this->_sig.template from_physical<Numeric>(static_cast<double>(_num_samples));
+        return this->_val;
+    }
+
+    template <typename Numeric>
+    void CountSignal<Numeric>::reset() {
+        _num_samples = 0;
+    }
+
+    template <typename Numeric>
+    Numeric FirstSignal<Numeric>::update(Numeric val) {
+        if (!_seen)
+            this->_val = val;
+        _seen = true;
+        return this->_val;
+    }
+
+    template <typename Numeric>
+    void FirstSignal<Numeric>::reset() {
+        _seen = false;
+    }
+
+    template <typename Numeric>
+    Numeric DeltaSignal<Numeric>::update(Numeric val) {
+        // _val holds the latest sample, which reset() turns into the next base
+        this->_val = val;
+        if (!_seen)
+            _base = val;
+        _seen = true;
+
+        // the physical change is (val - base) * factor, which encodes as
+        // val - base - offset / factor; integers subtract in two's complement,
+        // so rollover stays defined
+        const double offset_steps = this->_sig.offset() / this->_sig.factor();
+        if constexpr (std::is_integral_v<Numeric>)
+            return static_cast<Numeric>(static_cast<uint64_t>(val) - static_cast<uint64_t>(_base) -
+                                        static_cast<uint64_t>(std::llround(offset_steps)));
+        else
+            return static_cast<Numeric>(val - _base - offset_steps);
+    }
+
+    template <typename Numeric>
+    void DeltaSignal<Numeric>::reset() {
+        _base = this->_val;
+    }
+
     template struct AverageSignal<uint64_t>;
     template struct AverageSignal<int64_t>;
     template struct AverageSignal<double>;
@@ -65,6 +147,36 @@ namespace Candy {
     template struct LastSignal<double>;
     template struct LastSignal<float>;
 
+    template struct MinSignal<uint64_t>;
+    template struct MinSignal<int64_t>;
+    template struct MinSignal<double>;
+    template struct MinSignal<float>;
+
+    template struct MaxSignal<uint64_t>;
+    template struct MaxSignal<int64_t>;
+    template struct MaxSignal<double>;
+    template struct MaxSignal<float>;
+
+    template struct RmsSignal<uint64_t>;
+    template struct RmsSignal<int64_t>;
+    template struct RmsSignal<double>;
+    template struct RmsSignal<float>;
+
+    template struct CountSignal<uint64_t>;
+    template struct CountSignal<int64_t>;
+    template struct CountSignal<double>;
+    template struct CountSignal<float>;
+
+    template struct FirstSignal<uint64_t>;
+    template struct FirstSignal<int64_t>;
+    template struct FirstSignal<double>;
+    template struct FirstSignal<float>;
+
+    template struct DeltaSignal<uint64_t>;
+    template struct DeltaSignal<int64_t>;
+    template struct DeltaSignal<double>;
+    template struct DeltaSignal<float>;
+
     template <template <typename> typename AssemblerType>
     static SignalAssemblerVariant make_sig_agg(const TranslatedSignal& sig) {
         switch (sig.value_type()) {
@@ -103,27 +215,40 @@ namespace Candy {
     }
 
     void TranslatedMessage::assemble(std::pair<CANTime, CANFrame> sample) {
+        assemble({ sample.first, widen_frame(sample.second) });
+    }
+
+    void TranslatedMessage::assemble(const std::pair<CANTime, CANFlexibleFrame>& sample) {
         if (!transmission_group) return;
 
         if (!transmission_group->within_interval(_last_stamp))
             reset_sig_asms();
 
-        uint64_t clumped_val = 0;
-        uint64_t fd = std::bit_cast<uint64_t>(sample.second.data);
-        int64_t mux_val = _mux.has_value() ? _mux->decode(fd) : -1;
+        // classic frames are published as 8 bytes, CAN FD frames keep their length
+        const CANFlexibleFrame& frame = sample.second;
+        uint8_t len = (frame.flags & CANFD_FDF) ? std::min<uint8_t>(frame.length, CANFD_MAX_DLEN) : CAN_MAX_DLEN;
+
+        std::array<uint8_t, CANFD_MAX_DLEN> clumped {};
+        int64_t mux_val = _mux.has_value() ? _mux->decode(frame.data) : -1;
+
+        for (auto& fused : _fused_asms)
+            std::visit([&](auto& group) { group.assemble(mux_val, frame.data, clumped.data()); }, fused);
 
         for (auto& sc : _sig_asms)
-            clumped_val |= std::visit([&](auto& assembler) { return assembler.assemble(mux_val, fd); }, sc);
+            std::visit([&](auto& assembler) { assembler.assemble(mux_val, frame.data, clumped.data()); }, sc);
 
         if (_mux.has_value())
-            clumped_val |= _mux->encode(fd);
+            _mux->encode(mux_val, clumped.data());
 
-        transmission_group->add_clumped(sample.first, sample.second.can_id, mux_val, clumped_val);
+        transmission_group->add_clumped(sample.first, frame.can_id, mux_val, clumped, len);
 
         _last_stamp = sample.first;
     }
 
     void TranslatedMessage::make_sig_assemblers() {
+        _sig_asms.clear();
+        _fused_asms.clear();
+
         for (const TranslatedSignal& sig : _signals) {
             std::string_view atype = sig.agg_type();
 
@@ -135,11 +260,65 @@ namespace Candy {
                 SignalAssemblerVariant sasm = make_sig_agg<AverageSignal>(sig);
                 _sig_asms.emplace_back(std::move(sasm));
             }
-            else continue;
+            else if (atype == "MIN") {
+                _sig_asms.emplace_back(make_sig_agg<MinSignal>(sig));
+            }
+            else if (atype == "MAX") {
+                _sig_asms.emplace_back(make_sig_agg<MaxSignal>(sig));
+            }
+            else if (atype == "RMS") {
+                _sig_asms.emplace_back(make_sig_agg<RmsSignal>(sig));
+            }
+            else if (atype == "COUNT") {
+                _sig_asms.emplace_back(make_sig_agg<CountSignal>(sig));
+            }
+            else if (atype == "FIRST") {
+                _sig_asms.emplace_back(make_sig_agg<FirstSignal>(sig));
+            }
+            else if (atype == "DELTA") {
+                _sig_asms.emplace_back(make_sig_agg<DeltaSignal>(sig));
+            }
+            else {
+                fprintf(stderr, "Signal %s has unknown AggType %.*s, using LAST\n",
+                        sig.name().c_str(), static_cast<int>(atype.size()), atype.data());
+                _sig_asms.emplace_back(make_sig_agg<LastSignal>(sig));
+            }
+        }
+
+        fuse_sig_assemblers();
+    }
+
+    void TranslatedMessage::fuse_sig_assemblers() {
+        std::vector<SignalAssemblerVariant> unfused;
+
+        for (auto& sc : _sig_asms) {
+            std::visit([&](const auto& assembler) {
+                using Fused = FusedSignalAssembly<std::decay_t<decltype(assembler)>>;
+
+                if (assembler._sig.layout().wide) {
+                    unfused.push_back(sc);
+                    return;
+                }
+
+                auto mux_val = assembler._sig.mux_val();
+                auto it = std::find_if(_fused_asms.begin(), _fused_asms.end(), [&](const auto& fused) {
+                    auto group = std::get_if<Fused>(&fused);
+                    return group && group->mux_val() == mux_val;
+                });
+                if (it == _fused_asms.end())
+                    it = _fused_asms.emplace(_fused_asms.end(), std::in_place_type<Fused>, mux_val);
+
+                std::get<Fused>(*it).add(assembler);
+            }, sc);
         }
+
+        _sig_asms = std::move(unfused);
     }
 
     void TranslatedMessage::reset_sig_asms() {
+        for (auto& fused : _fused_asms)
+            std::visit([](auto& group) { group.reset(); }, fused);
+
         for (auto& sc : _sig_asms)
             std::visit([](auto& assembler) { assembler.reset(); }, sc);
     }
@@ -11,35 +11,41 @@ namespace Candy {
 		return duration_cast<milliseconds>(tp - CANTime(seconds(utc))).count();
 	}
 
-	void TransmissionGroup::try_publish(CANTime up_to, FramePacket& fp) {
+	void TransmissionGroup::try_publish(CANTime up_to, FramePacketEncoder& encoder, FramePacket& fp) {
 		if (_group_origin + _assemble_freq <= up_to) {
 			if (all_collected())
-				publish(up_to, fp);
+				publish(up_to, encoder, fp);
 			_group_origin = up_to;
 		}
 	}
 
-	void TransmissionGroup::publish(CANTime tp, FramePacket& fp) {
+	void TransmissionGroup::publish(CANTime tp, FramePacketEncoder& encoder, FramePacket& fp) {
 		// for messages with muxed signals, non-muxed signal values should be taken 
 		// from the frame with the latest timestamp, indicated by can::use_non_muxed(cf, true)
 
-		std::sort(_msg_clumps.begin(), _msg_clumps.end(), [](const auto& a, const auto& b) {
-			if (a.message_id != b.message_id) // primarily by message_ids
-				return a.message_id < b.message_id;
-			return a.stamp > b.stamp; // secondarily by timestamp, descending
-		});
+		int32_t millis = millis_diff(tp, fp.utc());
+		auto emit = [&](const stamped_msg& smsg, bool non_muxed) {
+			// classic messages go out as 8 byte frames, longer ones as CAN FD
+			CANFlexibleFrame ff {};
+			ff.can_id = smsg.message_id;
+			ff.length = std::max<uint8_t>(smsg.len, CAN_MAX_DLEN);
+			ff.flags = smsg.len > CAN_MAX_DLEN ? CANFD_FDF : 0;
+			use_non_muxed(ff, non_muxed);
+			std::memcpy(ff.data, smsg.mdata.data(), ff.length);
+			encoder.append(fp, millis, ff);
+		};
 
-		int64_t prev_id = 0;
-		for (const auto& smsg : _msg_clumps) {
-			CANFrame cf { 0 };
-			cf.can_id = smsg.message_id;
-			cf.len = CAN_MAX_DLEN;
-			use_non_muxed(cf, prev_id != cf.can_id);
-			prev_id = cf.can_id;
-			auto raw_data = smsg.mdata;
-			std::memcpy(cf.data, &raw_data, CAN_MAX_DLEN);
-			fp.append(millis_diff(tp, fp.utc()));
-			fp.append(cf);
+		// runs are in message_id order; the latest clump of each goes first
+		for (const auto& run : _runs) {
+			uint32_t latest = run.first;
+			for (uint32_t slot = run.first + 1; slot < run.first + run.count; ++slot)
+				if (_msg_clumps[slot].stamp > _msg_clumps[latest].stamp)
+					latest = slot;
+
+			emit(_msg_clumps[latest], true);
+			for (uint32_t slot = run.first; slot < run.first + run.count; ++slot)
+				if (slot != latest)
+					emit(_msg_clumps[slot], false);
 		}
 	}
 
@@ -56,20 +62,73 @@ namespace Candy {
 	// used only to assemble messages
 
 	void TransmissionGroup::assign(canid_t message_id, int64_t message_mux) {
-		_msg_clumps.push_back({ .message_id = message_id, .message_mux = message_mux });
+		_msg_clumps.push_back({ .stamp = {}, .message_id = message_id, .message_mux = message_mux, .mdata = {}, .len = CAN_MAX_DLEN });
 	}
 
-	bool TransmissionGroup::within_interval(CANTime stamp) const {
-		return stamp >= _group_origin && stamp < _group_origin + _assemble_freq;
+	void TransmissionGroup::time_begin(CANTime tp) {
+		_group_origin = tp;
+		index_slots();
 	}
 
-	void TransmissionGroup::add_clumped(CANTime stamp, canid_t message_id, int64_t message_mux, uint64_t cval) {
-		for (auto& smsg : _msg_clumps) {
-			if (smsg.message_id == message_id && smsg.message_mux == message_mux) {
-				smsg.stamp = stamp; smsg.mdata = cval;
-				break;
+	void TransmissionGroup::index_slots() {
+		std::sort(_msg_clumps.begin(), _msg_clumps.end(), [](const auto& a, const auto& b) {
+			if (a.message_id != b.message_id)
+				return a.message_id < b.message_id;
+			return a.message_mux < b.message_mux;
+		});
+		_msg_clumps.erase(std::unique(_msg_clumps.begin(), _msg_clumps.end(), [](const auto& a, const auto& b) {
+			return a.message_id == b.message_id && a.message_mux == b.message_mux;
+		}), _msg_clumps.end());
+
+		_runs.clear();
+		std::vector<std::pair<canid_t, uint32_t>> entries;
+		for (uint32_t slot = 0; slot < _msg_clumps.size(); ++slot) {
+			const auto& smsg = _msg_clumps[slot];
+			if (_runs.empty() || _msg_clumps[_runs.back().first].message_id != smsg.message_id) {
+				entries.emplace_back(smsg.message_id, static_cast<uint32_t>(_runs.size()));
+				_runs.push_back({ .first = slot, .count = 0, .first_mux = smsg.message_mux, .dense = true });
 			}
+
+			auto& run = _runs.back();
+			run.dense = run.dense && smsg.message_mux == run.first_mux + run.count;
+			++run.count;
 		}
+		_run_index.build(entries);
+	}
+
+	uint32_t TransmissionGroup::find_slot(canid_t message_id, int64_t message_mux) const {
+		uint32_t r = _run_index.find(message_id);
+		if (r == CANIdIndex::npos)
+			return CANIdIndex::npos;
+
+		const auto& run = _runs[r];
+		if (run.dense) {
+			if (message_mux < run.first_mux || message_mux >= run.first_mux + run.count)
+				return CANIdIndex::npos;
+			return run.first + static_cast<uint32_t>(message_mux - run.first_mux);
+		}
+
+		auto begin = _msg_clumps.begin() + run.first;
+		auto end = begin + run.count;
+		auto it = std::lower_bound(begin, end, message_mux, [](const auto& smsg, int64_t mux) { return smsg.message_mux < mux; });
+		if (it == end || it->message_mux != message_mux)
+			return CANIdIndex::npos;
+		return static_cast<uint32_t>(it - _msg_clumps.begin());
+	}
+
+	bool TransmissionGroup::within_interval(CANTime stamp) const {
+		return stamp >= _group_origin && stamp < _group_origin + _assemble_freq;
+	}
+
+	void TransmissionGroup::add_clumped(CANTime stamp, canid_t message_id, int64_t message_mux,
+		const std::array<uint8_t, CANFD_MAX_DLEN>& cval, uint8_t len)
+	{
+		uint32_t slot = find_slot(message_id, message_mux);
+		if (slot == CANIdIndex::npos)
+			return;
+
+		auto& smsg = _msg_clumps[slot];
+		smsg.stamp = stamp; smsg.mdata = cval; smsg.len = len;
 	}
 
 }
\ No newline at end of file
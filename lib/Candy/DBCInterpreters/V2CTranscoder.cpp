@@ -1,9 +1,28 @@
 #include <numeric>
 
+#include "Candy/Core/CANHelpers.hpp"
 #include "Candy/DBCInterpreters/V2CTranscoder.hpp"
 
 namespace Candy {
+bool V2CTranscoder::parse_dbc(std::string_view dbc_src) {
+	if (!DBCInterpreter<V2CTranscoder>::parse_dbc(dbc_src))
+		return false;
+
+	std::vector<std::pair<canid_t, uint32_t>> entries;
+	_dispatch_msgs.clear();
+	for (auto& [message_id, msg] : _msgs) {
+		entries.emplace_back(message_id, static_cast<uint32_t>(_dispatch_msgs.size()));
+		_dispatch_msgs.push_back(&msg);
+	}
+	_dispatch.build(entries);
+	return true;
+}
+
 FramePacket V2CTranscoder::transcode(std::pair<CANTime, CANFrame> sample) {
+	return transcode(std::pair<CANTime, CANFlexibleFrame>{ sample.first, widen_frame(sample.second) });
+}
+
+FramePacket V2CTranscoder::transcode(const std::pair<CANTime, CANFlexibleFrame>& sample) {
 	using namespace std::chrono;
 
 	setup_timers(sample.first);
@@ -20,14 +39,15 @@ FramePacket V2CTranscoder::transcode(std::pair<CANTime, CANFrame> sample) {
 	FramePacket rv {};
 
 	if (sample.first < frame_begin || sample.first >= frame_end) {
-		if (!frame_packet.is_empty())
+		if (!frame_packet.is_empty()) {
 			rv = std::move(frame_packet);
-		frame_packet.prepare(duration_cast<seconds>(sample.first.time_since_epoch()).count());
+			frame_packet = _packet_pool.acquire();
+		}
+		_encoder.begin(frame_packet, duration_cast<seconds>(sample.first.time_since_epoch()).count());
 	}
 
-	auto mi = _msgs.find(sample.second.can_id);
-	if (mi != _msgs.end()) {
-		mi->second.assemble(sample);
+	if (uint32_t slot = _dispatch.find(sample.second.can_id); slot != CANIdIndex::npos) {
+		_dispatch_msgs[slot]->assemble(sample);
 	}
 
 	return rv;
@@ -39,7 +59,8 @@ void V2CTranscoder::setup_timers(CANTime stamp) {
 	if (_last_update_tp != CANTime{})
 		return;
 
-	frame_packet.prepare(duration_cast<seconds>(stamp.time_since_epoch()).count());
+	frame_packet = _packet_pool.acquire();
+	_encoder.begin(frame_packet, duration_cast<seconds>(stamp.time_since_epoch()).count());
 	_last_update_tp = stamp;
 
 	for (auto& txg : transmission_groups)
@@ -48,10 +69,18 @@ void V2CTranscoder::setup_timers(CANTime stamp) {
 
 void V2CTranscoder::store_assembled(CANTime up_to) {
 	for (auto& txg : transmission_groups)
-		txg->try_publish(up_to, frame_packet);
+		txg->try_publish(up_to, _encoder, frame_packet);
 }
 
 
+std::vector<canid_t> V2CTranscoder::message_ids() const {
+	std::vector<canid_t> ids;
+	ids.reserve(_msgs.size());
+	for (const auto& [message_id, msg] : _msgs)
+		ids.push_back(message_id);
+	return ids;
+}
+
 TranslatedMessage* V2CTranscoder::find_message(canid_t message_id) {
 	auto msg_it = _msgs.find(message_id);
 	return msg_it == _msgs.end() ? nullptr : &(msg_it->second);
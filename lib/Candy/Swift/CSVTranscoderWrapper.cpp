@@ -109,9 +109,9 @@ namespace Candy {
         }
     }
 
-    void CSVTranscoderWrapper::batchDecodedSignals(std::pair<CANTime, CANFrame> sample, const MessageDefinition& msg_def) {
+    void CSVTranscoderWrapper::batchDecodedSignals(std::pair<CANTime, CANFrame> sample, const DecodeMessage& msg) {
         if (transcoder.has_value()) {
-            transcoder->batch_decoded_signals(sample, msg_def);
+            transcoder->batch_decoded_signals(sample, msg);
         }
     }
 
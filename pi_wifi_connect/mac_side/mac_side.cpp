@@ -3,35 +3,44 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <string>
-#include <unordered_set>
 
-using namespace std;
+#include <Candy/Candy.h>
 
-/* ---------------- Reliable recv ---------------- */
+using namespace std;
 
-bool recvAll(int sock, void* data, size_t len) {
-    char* ptr = static_cast<char*>(data);
-    while (len > 0) {
-        ssize_t r = recv(sock, ptr, len, 0);
-        if (r <= 0) return false;
-        ptr += r;
-        len -= r;
-    }
-    return true;
+size_t countFrames(const Candy::FramePacket& packet) {
+    size_t count = 0;
+    for (auto it = Candy::begin(packet); it != Candy::end(packet); ++it)
+        ++count;
+    return count;
 }
 
-/* ---------------- Extract seq from JSON ---------------- */
+/* ---------------- UDP ---------------- */
+
+int receiveUdp() {
+    auto receiver = Candy::UDPPacketReceiver::create(9000);
+    if (!receiver) return 1;
+    cout << "[MAC] Listening for the Pi on UDP " << receiver->port() << "\n";
 
-int extractSeq(const string& json) {
-    auto pos = json.find("\"seq\":");
-    if (pos == string::npos) return -1;
-    return stoi(json.substr(pos + 6));
+    while (true) {
+        auto packet = receiver->receive();
+        if (!packet) continue;
+
+        const auto& stats = receiver->stats();
+        cout << "[RECV] utc=" << packet->utc()
+             << " frames=" << countFrames(*packet)
+             << " bytes=" << packet->byte_size()
+             << " recovered=" << stats.recovered
+             << " lost=" << stats.lost << endl;
+    }
 }
 
 /* ---------------- Main ---------------- */
 
-int main() {
-    const char* server_ip = "10.42.0.1";
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--udp") return receiveUdp();
+
+    const char* server_ip = argc > 1 ? argv[1] : "10.42.0.1";
     int port = 9000;
 
     int sock = socket(AF_INET, SOCK_STREAM, 0);
@@ -52,52 +61,39 @@ int main() {
     }
     cout << "[MAC] Connected\n";
 
-    int expected = 0;
-    int received = 0;
-    unordered_set<int> seen;
+    Candy::PacketDeframer deframer;
+    uint8_t buffer[64 * 1024];
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
 
     while (true) {
-        // 1️⃣ Receive length
-        uint32_t len_net;
-        if (!recvAll(sock, &len_net, sizeof(len_net))) {
+        // 1️⃣ Receive whatever the stream has; packets may straddle reads
+        ssize_t r = recv(sock, buffer, sizeof(buffer), 0);
+        if (r <= 0) {
             cout << "[MAC] Connection closed\n";
             break;
         }
+        bytes += r;
+        deframer.feed({ buffer, static_cast<size_t>(r) });
 
-        uint32_t len = ntohl(len_net);
+        // 2️⃣ Hand every complete packet to FrameIterator
+        while (auto packet = deframer.next()) {
+            size_t count = countFrames(*packet);
+            frames += count;
 
-        // 2️⃣ Receive JSON payload
-        string json(len, '\0');
-        if (!recvAll(sock, &json[0], len)) {
-            cout << "[MAC] Payload receive failed\n";
-            break;
-        }
-
-        // 3️⃣ Process message
-        int seq = extractSeq(json);
-        received++;
-
-        if (seen.count(seq)) {
-            cout << "[DUP] seq=" << seq << endl;
-        } else {
-            seen.insert(seq);
+            cout << "[RECV] seq=" << *deframer.last_sequence()
+                 << " frames=" << count
+                 << " bytes=" << packet->byte_size() << endl;
         }
-
-        if (seq != expected) {
-            cout << "[LOSS] expected=" << expected
-                 << " got=" << seq << endl;
-            expected = seq + 1;
-        } else {
-            expected++;
-        }
-
-        cout << "[RECV] seq=" << seq
-             << " bytes=" << len << endl;
     }
 
+    const auto& stats = deframer.stats();
     cout << "\n=== STATS ===\n";
-    cout << "Received: " << received << endl;
-    cout << "Unique:   " << seen.size() << endl;
+    cout << "Packets:     " << stats.packets << endl;
+    cout << "Frames:      " << frames << endl;
+    cout << "Bytes:       " << bytes << endl;
+    cout << "Lost:        " << stats.lost << endl;
+    cout << "CRC errors:  " << stats.crc_errors << endl;
 
     close(sock);
     return 0;
@@ -1,11 +1,13 @@
-#include <fstream>
 #include <iostream>
-#include <vector>
+#include <string>
+#include <string_view>
 #include <sys/socket.h>
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <netinet/tcp.h> // Necessary for tcp_info
 
+#include <Candy/Candy.h>
+
 using namespace std;
 
 // Function to extract TCP statistics from the kernel
@@ -21,7 +23,7 @@ uint32_t getTotalRetransmits(int sock) {
 bool sendAll(int sock, const void* data, size_t len) {
     const char* ptr = (const char*)data;
     while (len > 0) {
-        ssize_t sent = send(sock, ptr, len, 0);
+        ssize_t sent = send(sock, ptr, len, MSG_NOSIGNAL);
         if (sent <= 0) return false;
         ptr += sent;
         len -= sent;
@@ -29,7 +31,66 @@ bool sendAll(int sock, const void* data, size_t len) {
     return true;
 }
 
-int main() {
+Candy::PacketCompression parseCompression(string_view name) {
+    if (name == "lz4") return Candy::PacketCompression::lz4;
+    if (name == "zstd") return Candy::PacketCompression::zstd;
+    return Candy::PacketCompression::none;
+}
+
+// Sends FramePackets as UDP datagrams; lost ones are resent on NACK while still fresh
+int streamUdp(Candy::SocketCANSource& source, Candy::V2CTranscoder& transcoder, const char* mac_ip,
+              Candy::PacketCompression compression) {
+    auto sender = Candy::UDPPacketSender::create(mac_ip, 9000, {}, compression);
+    if (!sender) return 1;
+    cout << "[PI] Streaming to " << mac_ip << " over UDP\n";
+
+    while (true) {
+        // a short timeout keeps NACKs answered while the bus is quiet
+        source.read([&](const pair<CANTime, CANFlexibleFrame>& sample) {
+            Candy::FramePacket packet = transcoder.transcode(sample);
+            if (packet.is_empty()) return;
+            sender->send(packet);
+            transcoder.recycle(std::move(packet));
+        }, 10);
+
+        if (sender->poll() > 0)
+            cout << "[PI] Retransmits: " << sender->stats().retransmits << endl;
+    }
+}
+
+// Reads the car's CAN bus, aggregates it through V2CTranscoder and sends
+// every FramePacket to the Mac as one PacketFramer frame, over TCP unless
+// --udp names the Mac.
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        cerr << "usage: " << argv[0] << " <can-interface> <dbc> [--udp <mac-ip>] [none|lz4|zstd]\n";
+        return 1;
+    }
+
+    const char* udp_peer = nullptr;
+    Candy::PacketCompression compression = Candy::PacketCompression::none;
+    for (int i = 3; i < argc; ++i) {
+        if (string_view(argv[i]) == "--udp" && i + 1 < argc) udp_peer = argv[++i];
+        else compression = parseCompression(argv[i]);
+    }
+
+    Candy::V2CTranscoder transcoder;
+    if (!transcoder.parse_dbc(Candy::transmit_file(argv[2]))) {
+        cerr << "[PI] Failed to parse " << argv[2] << "\n";
+        return 1;
+    }
+    // mac_side reads packets through FrameIterator, which decodes either format
+    transcoder.set_packet_format(Candy::FramePacketFormat::v2);
+
+    auto ids = transcoder.message_ids();
+    auto source = Candy::SocketCANSource::create(argv[1], ids);
+    if (!source) return 1;
+
+    if (udp_peer) return streamUdp(*source, transcoder, udp_peer, compression);
+
+    auto framer = Candy::PacketFramer::create(compression);
+    if (!framer) return 1;
+
     int server_fd = socket(AF_INET, SOCK_STREAM, 0);
 
     // Set socket option to reuse address (helps if you restart the app quickly)
@@ -53,36 +114,43 @@ int main() {
     if (client < 0) return 1;
     cout << "[PI] Connected\n";
 
-    uint32_t last_retrans = 0;
-
-    for (int seq = 0; seq < 1000; seq++) {
-        string filename = "../json/" + to_string(seq) + ".json";
-        ifstream file(filename);
-        if (!file) break;
+    // packets are small and latency matters more than segment count
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
 
-        string json((istreambuf_iterator<char>(file)),
-                     istreambuf_iterator<char>());
-
-        uint32_t len = htonl(json.size());
-
-        // Send Length Header
-        if (!sendAll(client, &len, sizeof(len))) break;
-        // Send JSON Body
-        if (!sendAll(client, json.data(), json.size())) break;
-
-        // Check for retransmits after the send
-        uint32_t current_retrans = getTotalRetransmits(client);
-
-        cout << "[PI] Sent seq " << seq;
-        if (current_retrans > last_retrans) {
-            cout << " [!] Retransmission detected! (Total: " << current_retrans << ")";
-            last_retrans = current_retrans;
-        }
-        cout << endl;
-
-        usleep(1000);
+    uint32_t last_retrans = 0;
+    bool connected = true;
+
+    while (connected) {
+        source->read([&](const pair<CANTime, CANFlexibleFrame>& sample) {
+            if (!connected) return;
+
+            Candy::FramePacket packet = transcoder.transcode(sample);
+            if (packet.is_empty()) return;
+
+            uint32_t seq = framer->next_sequence();
+            size_t packet_bytes = packet.byte_size();
+            auto frame = framer->frame(packet);
+            // the frame is a copy, so the buffer can go back for the next period
+            transcoder.recycle(std::move(packet));
+            if (frame.empty()) return;
+            if (!sendAll(client, frame.data(), frame.size())) {
+                connected = false;
+                return;
+            }
+
+            // Check for retransmits after the send
+            uint32_t current_retrans = getTotalRetransmits(client);
+
+            cout << "[PI] Sent seq " << seq << " (" << packet_bytes << " -> " << frame.size() << " bytes)";
+            if (current_retrans > last_retrans) {
+                cout << " [!] Retransmission detected! (Total: " << current_retrans << ")";
+                last_retrans = current_retrans;
+            }
+            cout << endl;
+        });
     }
 
+    cout << "[PI] Mac disconnected\n";
     close(client);
     close(server_fd);
     return 0;
@@ -0,0 +1,141 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Candy/Candy.h>
+
+using namespace std::chrono;
+
+struct Input {
+    CANTime stamp;
+    int16_t load;
+    uint16_t distance;
+    uint8_t status;
+    // Strut: temperature scaled by a negative factor and by an offset, a scaled travel counter
+    int16_t temp;
+    uint8_t travel;
+};
+
+// Strut's Temp_Max and Temp_Min are (-0.5, 100), Temp_Rms (0.25, -40),
+// Strokes (0.5, -10) and Travel (2, -6)
+double max_temp(int16_t raw) { return raw * -0.5 + 100; }
+double rms_temp(int16_t raw) { return raw * 0.25 - 40; }
+
+// what each aggregate should be over the inputs in [from, to), as raw values
+std::map<std::string, int64_t> expected(const std::vector<Input>& inputs, CANTime from, CANTime to) {
+    std::vector<Input> in;
+    std::optional<Input> base;
+    for (const auto& input : inputs) {
+        if (input.stamp < from) base = input;
+        else if (input.stamp < to) in.push_back(input);
+    }
+    if (in.empty()) return {};
+    if (!base) base = in.front();
+
+    int64_t lo = in[0].load, hi = in[0].load;
+    int16_t hottest = in[0].temp, coldest = in[0].temp;
+    double squares = 0, temp_squares = 0;
+    for (const auto& input : in) {
+        lo = std::min<int64_t>(lo, input.load);
+        hi = std::max<int64_t>(hi, input.load);
+        squares += double(input.load) * input.load;
+        if (max_temp(input.temp) > max_temp(hottest)) hottest = input.temp;
+        if (max_temp(input.temp) < max_temp(coldest)) coldest = input.temp;
+        temp_squares += rms_temp(input.temp) * rms_temp(input.temp);
+    }
+
+    // physical travel (last - base) * 2 encodes as raw last - base + 3
+    const double temp_rms = std::sqrt(temp_squares / in.size());
+    return {
+        { "Temp_Max", hottest },
+        { "Temp_Min", coldest },
+        { "Temp_Rms", std::llround((temp_rms + 40) / 0.25) },
+        { "Strokes", std::min<int64_t>(2 * in.size() + 20, 255) },
+        { "Travel", uint8_t(in.back().travel - base->travel + 3) },
+        { "Load_Min", lo },
+        { "Load_Max", hi },
+        { "Load_Rms", std::llround(std::sqrt(squares / in.size())) },
+        { "Load_First", in.front().load },
+        { "Distance", uint16_t(in.back().distance - base->distance) },
+        { "Samples", std::min<int64_t>(in.size(), 15) },
+        { "Status", in.back().status },
+    };
+}
+
+int main() {
+    std::cout << "=== Aggregation Test ===" << std::endl;
+
+    Candy::V2CTranscoder transcoder;
+    if (!transcoder.parse_dbc(Candy::transmit_file("test/aggregation.dbc")))
+        return 1;
+
+    std::vector<Input> inputs;
+    CANTime origin { seconds(1700000000) };
+    size_t checked = 0;
+
+    for (int ms = 0; ms < 3500; ++ms) {
+        // a noisy load with peaks, and an odometer that rolls over every ~94 ms
+        Input input {
+            origin + milliseconds(ms),
+            static_cast<int16_t>(1000 * std::sin(ms / 37.0) + (ms % 97 == 0 ? 5000 : 0)),
+            static_cast<uint16_t>(700 * ms),
+            static_cast<uint8_t>(ms / 10),
+            static_cast<int16_t>(300 * std::sin(ms / 23.0) + (ms % 89 == 0 ? -900 : 0)),
+            static_cast<uint8_t>(ms * 7)
+        };
+        inputs.push_back(input);
+
+        CANFrame load {};
+        load.can_id = 256;
+        load.len = 8;
+        for (int at = 0; at < 8; at += 2)
+            std::memcpy(load.data + at, &input.load, sizeof(input.load));
+
+        CANFrame odometer {};
+        odometer.can_id = 257;
+        odometer.len = 8;
+        std::memcpy(odometer.data, &input.distance, sizeof(input.distance));
+        odometer.data[3] = input.status;
+
+        CANFrame strut {};
+        strut.can_id = 258;
+        strut.len = 8;
+        for (int at = 0; at < 6; at += 2)
+            std::memcpy(strut.data + at, &input.temp, sizeof(input.temp));
+        strut.data[7] = input.travel;
+
+        for (const CANFrame& frame : { load, odometer, strut }) {
+            Candy::FramePacket packet = transcoder.transcode({ input.stamp, frame });
+            if (packet.is_empty()) continue;
+
+            for (auto it = Candy::begin(packet); it != Candy::end(packet); ++it) {
+                const auto& [ts, published] = *it;
+                auto want = expected(inputs, ts - 100ms, ts);
+
+                for (const auto& sig : transcoder.find_message(published.can_id)->signals(published.data)) {
+                    int64_t got = static_cast<int64_t>(sig.decode(published.data));
+                    if (!want.count(sig.name()) || want[sig.name()] != got) {
+                        std::cerr << sig.name() << " at " << duration_cast<milliseconds>(ts - origin).count()
+                                  << "ms: got " << got << ", expected " << want[sig.name()] << std::endl;
+                        return 1;
+                    }
+                    ++checked;
+                }
+            }
+        }
+    }
+
+    std::cout << "   " << checked << " aggregated values checked" << std::endl;
+    if (checked < 12 * 30) {
+        std::cerr << "Too few intervals published" << std::endl;
+        return 1;
+    }
+
+    std::cout << "   ✓ MIN, MAX, RMS, COUNT, FIRST and DELTA match, scaled and offset signals included" << std::endl;
+    return 0;
+}
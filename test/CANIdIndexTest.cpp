@@ -0,0 +1,77 @@
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <Candy/Candy.h>
+
+// every id in the map finds its slot, and nothing else is found
+bool check(const Candy::CANIdIndex& index, const std::unordered_map<canid_t, uint32_t>& expected, std::mt19937& gen) {
+    if (index.size() != expected.size()) {
+        std::cerr << "Index holds " << index.size() << " ids, expected " << expected.size() << std::endl;
+        return false;
+    }
+
+    for (const auto& [can_id, slot] : expected) {
+        if (index.find(can_id) != slot) {
+            std::cerr << "Id " << std::hex << can_id << std::dec << " found slot " << index.find(can_id) << ", expected " << slot << std::endl;
+            return false;
+        }
+    }
+
+    for (int i = 0; i < 100000; ++i) {
+        canid_t can_id = i % 2 ? (gen() & CAN_EFF_MASK) | CAN_EFF_FLAG : gen() & CAN_SFF_MASK;
+        if (!expected.count(can_id) && index.find(can_id) != Candy::CANIdIndex::npos) {
+            std::cerr << "Missing id " << std::hex << can_id << std::dec << " found slot " << index.find(can_id) << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== CAN Id Index Test ===" << std::endl;
+
+    std::mt19937 gen(11);
+    Candy::CANIdIndex index;
+    if (index.find(0x100) != Candy::CANIdIndex::npos || index.find(0x100 | CAN_EFF_FLAG) != Candy::CANIdIndex::npos) {
+        std::cerr << "Empty index found an id" << std::endl;
+        return 1;
+    }
+
+    // a J1939-style DBC grows from a few extended ids to thousands
+    for (size_t count : { 1, 2, 3, 17, 250, 4000 }) {
+        std::vector<std::pair<canid_t, uint32_t>> entries;
+        std::unordered_map<canid_t, uint32_t> expected;
+        for (uint32_t slot = 0; entries.size() < count; ++slot) {
+            canid_t can_id = slot % 4 == 0 ? gen() & CAN_SFF_MASK : (gen() & CAN_EFF_MASK) | CAN_EFF_FLAG;
+            if (expected.count(can_id)) continue;
+            entries.emplace_back(can_id, slot);
+            expected[can_id] = slot;
+        }
+
+        // the same low bits with and without CAN_EFF_FLAG are different ids
+        entries.emplace_back(0x123, 90000);
+        entries.emplace_back(0x123 | CAN_EFF_FLAG, 90001);
+        expected[0x123] = 90000;
+        expected[0x123 | CAN_EFF_FLAG] = 90001;
+
+        // a repeated id keeps its last slot
+        entries.emplace_back(entries.front().first, 90002);
+        expected[entries.front().first] = 90002;
+
+        index.build(entries);
+        if (!check(index, expected, gen))
+            return 1;
+        std::cout << "   " << expected.size() << " ids: every id found, no misses found" << std::endl;
+    }
+
+    index.clear();
+    if (index.size() != 0 || index.find(0x123) != Candy::CANIdIndex::npos || index.find(0x123 | CAN_EFF_FLAG) != Candy::CANIdIndex::npos) {
+        std::cerr << "Cleared index still finds ids" << std::endl;
+        return 1;
+    }
+
+    std::cout << "   ✓ standard and extended ids dispatch through the index" << std::endl;
+    return 0;
+}
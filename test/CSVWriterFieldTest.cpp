@@ -0,0 +1,202 @@
+#include <iostream>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <Candy/Candy.h>
+
+using Candy::CSVHeader;
+using Candy::CSVWriter;
+
+const CSVHeader<3> header { "fields.csv", { "a", "b", "c" } };
+const std::string dir = "./test_csv_writer_fields/";
+
+std::string file_text() {
+    std::ifstream file(dir + header.filename, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+std::string printf_fixed(double value, int precision) {
+    std::vector<char> buf(512);
+    snprintf(buf.data(), buf.size(), "%.*f", precision, value);
+    return buf.data();
+}
+
+// writes one field per row through write, comparing the file to expected
+template <typename Write>
+bool check_rows(const char* what, const std::vector<std::string>& expected, Write&& write) {
+    {
+        auto writer = CSVWriter<3>::create(dir, header);
+        if (!writer) return false;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            writer->start_row();
+            write(*writer, i);
+            writer->end_row();
+        }
+        if (!writer->close()) {
+            std::cerr << what << ": close failed" << std::endl;
+            return false;
+        }
+    }
+
+    std::string want;
+    for (const auto& row : expected) want += row + "\n";
+    std::string got = file_text();
+    if (got != want) {
+        std::cerr << what << " wrote:\n" << got.substr(0, 400) << "\nexpected:\n" << want.substr(0, 400) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool check_integers() {
+    return check_rows("field(Int)", {
+        "0", "-128", "127", "255", "-32768", "65535",
+        "-2147483648", "4294967295", "-9223372036854775808", "9223372036854775807", "18446744073709551615",
+    }, [](CSVWriter<3>& w, size_t i) {
+        switch (i) {
+            case 0: w.field(0); break;
+            case 1: w.field(std::numeric_limits<int8_t>::min()); break;
+            case 2: w.field(std::numeric_limits<int8_t>::max()); break;
+            case 3: w.field(std::numeric_limits<uint8_t>::max()); break;
+            case 4: w.field(std::numeric_limits<int16_t>::min()); break;
+            case 5: w.field(std::numeric_limits<uint16_t>::max()); break;
+            case 6: w.field(std::numeric_limits<int32_t>::min()); break;
+            case 7: w.field(std::numeric_limits<uint32_t>::max()); break;
+            case 8: w.field(std::numeric_limits<int64_t>::min()); break;
+            case 9: w.field(std::numeric_limits<int64_t>::max()); break;
+            case 10: w.field(std::numeric_limits<uint64_t>::max()); break;
+        }
+    });
+}
+
+bool check_doubles() {
+    // shortest round-trip text
+    if (!check_rows("field(double)", {
+            "0", "-0", "0.1", "-1.5", "1e+21", "1.7976931348623157e+308", "5e-324",
+        }, [](CSVWriter<3>& w, size_t i) {
+            const double values[] = { 0.0, -0.0, 0.1, -1.5, 1e21, DBL_MAX, std::numeric_limits<double>::denorm_min() };
+            w.field(values[i]);
+        })) {
+        return false;
+    }
+
+    // as printf("%.*f"), including the hundreds of digits of DBL_MAX
+    const std::pair<double, int> fixed[] = {
+        { 0.0, 6 }, { -0.0, 6 }, { 0.125, 2 }, { 2.5, 0 }, { -1.5, 2 }, { 1234.5678, 3 }, { -0.0001, 2 },
+        { 1e-7, 6 }, { 123456789.0, 0 }, { DBL_MAX, 6 }, { -DBL_MAX, 0 }, { 0.1, 17 },
+    };
+    std::vector<std::string> expected;
+    for (const auto& [value, precision] : fixed) expected.push_back(printf_fixed(value, precision));
+    return check_rows("field(double, precision)", expected, [&](CSVWriter<3>& w, size_t i) {
+        w.field(fixed[i].first, fixed[i].second);
+    });
+}
+
+bool check_times() {
+    using namespace std::chrono;
+    return check_rows("field(time_point)", { "0", "1700000000123", "-5", "1", "-1" }, [](CSVWriter<3>& w, size_t i) {
+        switch (i) {
+            case 0: w.field(system_clock::time_point {}); break;
+            case 1: w.field(system_clock::time_point { milliseconds(1700000000123) }); break;
+            case 2: w.field(system_clock::time_point { milliseconds(-5) }); break;
+            // whole milliseconds, truncated toward zero
+            case 3: w.field(time_point<system_clock, microseconds> { microseconds(1999) }); break;
+            case 4: w.field(time_point<system_clock, microseconds> { microseconds(-1999) }); break;
+        }
+    });
+}
+
+bool check_hex() {
+    std::vector<uint8_t> full(64);
+    std::string full_hex;
+    for (size_t i = 0; i < full.size(); ++i) {
+        full[i] = static_cast<uint8_t>(i * 37);
+        char buf[4];
+        snprintf(buf, sizeof(buf), i ? " %02X" : "%02X", full[i]);
+        full_hex += buf;
+    }
+
+    return check_rows("hex_field", { "", ",00", "0A FF 10", full_hex, "7,,00" }, [&](CSVWriter<3>& w, size_t i) {
+        const uint8_t bytes[] = { 0x0A, 0xFF, 0x10 };
+        switch (i) {
+            case 0: w.hex_field({}); break;
+            case 1: w.hex_field(std::span<const uint8_t>(bytes, 0)); w.hex_field(std::vector<uint8_t> { 0 }); break;
+            case 2: w.hex_field(bytes); break;
+            case 3: w.hex_field(full); break;
+            // an empty payload still takes its column
+            case 4: w.field(7); w.hex_field({}); w.hex_field(std::vector<uint8_t> { 0 }); break;
+        }
+    });
+}
+
+// rows that straddle the 64 KiB buffer, and a field larger than it
+bool check_buffer_boundaries() {
+    std::vector<std::string> expected;
+    const std::string big(70000, 'x');
+    const std::string quoted = "a \"quoted\", field";
+    for (int i = 0; i < 20000; ++i) {
+        std::string row = std::to_string(i * 7919 - 50000) + "," + printf_fixed(i / 3.0, 3) + ",0A FF";
+        if (i % 1000 == 999) row += ",\"a \"\"quoted\"\", field\"";
+        if (i == 12345) row += "," + big;
+        expected.push_back(row);
+    }
+
+    return check_rows("rows across the buffer", expected, [&](CSVWriter<3>& w, size_t i) {
+        const uint8_t bytes[] = { 0x0A, 0xFF };
+        w.field(static_cast<int64_t>(i) * 7919 - 50000);
+        w.field(i / 3.0, 3);
+        w.hex_field(bytes);
+        if (i % 1000 == 999) w.field(quoted);
+        if (i == 12345) w.field(big);
+    });
+}
+
+// a full device fails every write, and flush and close say so
+bool check_write_failure() {
+    if (!std::filesystem::exists("/dev/full"))
+        return true;
+
+    const CSVHeader<3> full_header { "full", { "a", "b", "c" } };
+    auto writer = CSVWriter<3>::create("/dev/", full_header);
+    if (!writer) return false;
+
+    // enough rows that a field's reserve() drains the buffer mid-row
+    for (int i = 0; i < 10000; ++i) {
+        writer->start_row();
+        writer->field(i);
+        writer->field(i * 0.5, 6);
+        writer->end_row();
+    }
+    if (writer->flush() || writer->flush() || writer->close()) {
+        std::cerr << "Writes to /dev/full were not reported" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== CSV Writer Field Test ===" << std::endl;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    if (!check_integers() || !check_doubles() || !check_times() || !check_hex())
+        return 1;
+    std::cout << "   ✓ integer, double, time and hex fields format exactly" << std::endl;
+
+    if (!check_buffer_boundaries())
+        return 1;
+    std::cout << "   ✓ rows across the buffer boundary and an oversized field" << std::endl;
+
+    if (!check_write_failure())
+        return 1;
+    std::cout << "   ✓ failed writes are latched and reported" << std::endl;
+    return 0;
+}
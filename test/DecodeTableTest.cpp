@@ -0,0 +1,146 @@
+#include <iostream>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Candy/Candy.h>
+
+// Intel and Motorola, signed and unsigned, a muxed extended id with a float
+// page, and a CAN FD message with a wide signal
+constexpr std::string_view dbc = R"(VERSION ""
+
+NS_ :
+
+BS_:
+
+BU_: ECU V2C
+
+BO_ 256 Engine: 8 ECU
+ SG_ Rpm : 0|16@1+ (0.25,0) [0|16383] "rpm" V2C
+ SG_ Coolant : 23|8@0- (1,-40) [-40|215] "C" V2C
+
+BO_ 2566848512 Ext_Mux: 8 ECU
+ SG_ Page M : 0|8@1+ (1,0) [0|255] "" V2C
+ SG_ Pressure m0 : 8|16@1- (0.5,1) [-16383|16384] "kPa" V2C
+ SG_ Flow m1 : 8|32@1+ (1,0) [0|1000] "l/min" V2C
+
+BO_ 768 Strain: 64 ECU
+ SG_ Gauge_Tail : 500|12@1+ (1,0) [0|4095] "ue" V2C
+ SG_ Gauge_Wide : 4|64@1+ (1,0) [0|0] "" V2C
+
+SIG_VALTYPE_ 2566848512 Flow : 1;
+)";
+
+struct Expected {
+    std::string name;
+    Candy::SignalCodec codec;
+    double factor;
+    double offset;
+    Candy::NumericValueType type;
+    std::optional<uint64_t> mux;
+    std::string unit;
+};
+
+bool same(double a, double b) {
+    return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+int main() {
+    using Candy::NumericValueType;
+    std::cout << "=== Decode Table Test ===" << std::endl;
+
+    auto transcoder = Candy::CSVTranscoder::create("./test_decode_table_output/");
+    if (!transcoder || !transcoder->parse_dbc(dbc))
+        return 1;
+    const Candy::DecodeTable& table = transcoder->table();
+
+    const canid_t ext_id = 0x18FF0000 | CAN_EFF_FLAG;
+    const std::pair<canid_t, std::vector<Expected>> messages[] = {
+        { 256, {
+            { "Rpm", { 0, 16, '1', '+' }, 0.25, 0, NumericValueType::u64, std::nullopt, "rpm" },
+            { "Coolant", { 23, 8, '0', '-' }, 1, -40, NumericValueType::i64, std::nullopt, "C" },
+        } },
+        { ext_id, {
+            { "Pressure", { 8, 16, '1', '-' }, 0.5, 1, NumericValueType::i64, 0, "kPa" },
+            { "Flow", { 8, 32, '1', '+' }, 1, 0, NumericValueType::f32, 1, "l/min" },
+        } },
+        { 768, {
+            { "Gauge_Tail", { 500, 12, '1', '+' }, 1, 0, NumericValueType::u64, std::nullopt, "ue" },
+            { "Gauge_Wide", { 4, 64, '1', '+' }, 1, 0, NumericValueType::u64, std::nullopt, "" },
+        } },
+    };
+
+    if (table.message_count() != 3 || table.find(0x7FF) || table.find(0x18FF0000) || table.find_message_name(0x7FF) != "") {
+        std::cerr << "Table has " << table.message_count() << " messages or finds ids not in the DBC" << std::endl;
+        return 1;
+    }
+
+    std::mt19937_64 gen(5);
+    Candy::ColumnBuffer columns;
+    size_t checked = 0;
+    for (const auto& [can_id, expected] : messages) {
+        auto slot = table.find(can_id);
+        if (!slot || table.ids()[*slot] != can_id) {
+            std::cerr << "Message " << can_id << " not found" << std::endl;
+            return 1;
+        }
+
+        const Candy::DecodeMessage& msg = table.message(*slot);
+        bool fd = can_id == 768;
+        if (msg.signal_count != expected.size() || msg.has_mux != (can_id == ext_id) ||
+            (msg.payload_size > CAN_MAX_DLEN) != fd) {
+            std::cerr << table.message_name(*slot) << ": " << msg.signal_count << " signals, payload " << int(msg.payload_size) << std::endl;
+            return 1;
+        }
+
+        for (size_t i = 0; i < expected.size(); ++i) {
+            uint32_t sig = msg.first_signal + static_cast<uint32_t>(i);
+            const auto& want = expected[i];
+            const auto& layout = table.layout(sig);
+            const auto& codec_layout = want.codec.layout();
+            if (table.signal_name(sig) != want.name || table.unit(sig) != want.unit ||
+                table.factor(sig) != want.factor || table.offset(sig) != want.offset ||
+                table.value_type(sig) != want.type || table.mux_val(sig) != want.mux ||
+                layout.mask != codec_layout.mask || layout.sign_bit != codec_layout.sign_bit ||
+                layout.byte_offset != codec_layout.byte_offset || layout.shift != codec_layout.shift ||
+                layout.big_endian != codec_layout.big_endian || layout.wide != codec_layout.wide) {
+                std::cerr << "Signal " << want.name << " compiled wrongly as " << table.signal_name(sig)
+                          << ", type " << static_cast<int>(table.value_type(sig)) << std::endl;
+                return 1;
+            }
+        }
+
+        // column decode agrees with the per-signal codec and NumericValue
+        std::vector<std::pair<CANTime, CANFlexibleFrame>> samples(37);
+        for (auto& [ts, frame] : samples) {
+            frame.can_id = can_id;
+            frame.length = fd ? CANFD_MAX_DLEN : CAN_MAX_DLEN;
+            for (auto& b : frame.data) b = static_cast<uint8_t>(gen());
+            frame.data[0] &= 1;
+        }
+        columns.decode(table, *slot, samples);
+
+        for (size_t row = 0; row < samples.size(); ++row) {
+            const uint8_t* data = samples[row].second.data;
+            for (size_t col = 0; col < columns.columns(); ++col) {
+                uint32_t sig = columns.signal(col);
+                if (!table.is_active(sig, columns.mux(row)))
+                    continue;
+
+                const auto& want = expected[col];
+                uint64_t raw = want.codec(data);
+                double value = *Candy::NumericValue(want.factor, want.offset).convert(raw, want.type);
+                if (columns.raw(col)[row] != raw || !same(columns.values(col)[row], value)) {
+                    std::cerr << want.name << " row " << row << ": " << columns.values(col)[row] << ", expected " << value << std::endl;
+                    return 1;
+                }
+                ++checked;
+            }
+        }
+    }
+
+    std::cout << "   " << checked << " column values match SignalCodec" << std::endl;
+    std::cout << "   ✓ DBC compiled into the decode table" << std::endl;
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sqlite3.h"
+
+#include <Candy/Candy.h>
+
+// a CAN FD strain message with a signal in its last bytes, and a classic one
+constexpr std::string_view dbc = R"(VERSION ""
+
+NS_ :
+
+BS_:
+
+BU_: ECU V2C
+
+BO_ 256 Engine: 8 ECU
+ SG_ Rpm : 0|16@1+ (1,0) [0|65535] "rpm" V2C
+
+BO_ 768 Strain: 64 ECU
+ SG_ Gauge_Head : 0|16@1+ (1,0) [0|65535] "ue" V2C
+ SG_ Gauge_Tail : 496|16@1+ (1,0) [0|65535] "ue" V2C
+)";
+
+using Sample = std::pair<CANTime, CANFlexibleFrame>;
+
+std::string hex(const uint8_t* data, size_t len) {
+    std::string out;
+    char buf[4];
+    for (size_t i = 0; i < len; ++i) {
+        snprintf(buf, sizeof(buf), i ? " %02X" : "%02X", data[i]);
+        out += buf;
+    }
+    return out;
+}
+
+uint64_t tail(const CANFlexibleFrame& frame) {
+    return frame.data[62] | (frame.data[63] << 8);
+}
+
+std::vector<Sample> make_samples() {
+    std::mt19937 gen(9);
+    std::vector<Sample> samples;
+    CANTime stamp { std::chrono::seconds(1700000000) };
+    // full, short and classic-sized FD payloads, between classic frames
+    for (uint8_t len : { 64, 48, 12, 64, 8, 64 }) {
+        Sample fd { stamp, {} };
+        fd.second.can_id = 768;
+        fd.second.flags = CANFD_FDF | CANFD_BRS;
+        fd.second.length = len;
+        for (int i = 0; i < len; ++i) fd.second.data[i] = static_cast<uint8_t>(gen());
+        samples.push_back(fd);
+        stamp += std::chrono::milliseconds(1);
+
+        Sample classic { stamp, {} };
+        classic.second.can_id = 256;
+        classic.second.length = CAN_MAX_DLEN;
+        for (int i = 0; i < CAN_MAX_DLEN; ++i) classic.second.data[i] = static_cast<uint8_t>(gen());
+        samples.push_back(classic);
+        stamp += std::chrono::milliseconds(1);
+    }
+    return samples;
+}
+
+bool check_csv(const std::vector<Sample>& samples) {
+    {
+        auto transcoder = Candy::CSVTranscoder::create("./test_fd_csv_output/");
+        if (!transcoder || !transcoder->parse_dbc(dbc))
+            return false;
+        for (const auto& sample : samples) {
+            if (sample.second.flags & CANFD_FDF) transcoder->receive_raw_message(sample);
+            else transcoder->receive_raw_message(std::pair { sample.first, Candy::narrow_frame(sample.second) });
+        }
+        transcoder->flush_all_batches();
+    }
+
+    std::ifstream frames("./test_fd_csv_output/frames.csv");
+    std::string line;
+    for (const auto& [ts, frame] : samples) {
+        std::string expected = std::to_string(frame.can_id) + "," + std::to_string(frame.length) + "," + hex(frame.data, frame.length) + ",";
+        if (!std::getline(frames, line) || line.find(expected) == std::string::npos) {
+            std::cerr << "CSV frame row '" << line << "' lacks '" << expected << "'" << std::endl;
+            return false;
+        }
+    }
+
+    // signals past byte 8 decode from the full payload, zero padded when it's short
+    std::ifstream decoded("./test_fd_csv_output/decoded_frames.csv");
+    size_t tails = 0;
+    while (std::getline(decoded, line)) {
+        if (line.find(",Gauge_Tail,") == std::string::npos) continue;
+        const auto& frame = samples[2 * tails].second;
+        std::string expected = "," + std::to_string(tail(frame)) + ",ue,";
+        if (line.find(expected) == std::string::npos) {
+            std::cerr << "CSV Gauge_Tail row '" << line << "' lacks raw " << tail(frame) << std::endl;
+            return false;
+        }
+        ++tails;
+    }
+    if (tails != samples.size() / 2) {
+        std::cerr << "CSV decoded " << tails << " Gauge_Tail rows" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool check_sql(const std::vector<Sample>& samples) {
+    const char* path = "./test_fd.db";
+    std::remove(path);
+    {
+        auto transcoder = Candy::SQLTranscoder::create(path);
+        if (!transcoder || !transcoder->parse_dbc(dbc))
+            return false;
+        for (const auto& sample : samples) {
+            if (sample.second.flags & CANFD_FDF) transcoder->receive_raw_message(sample);
+            else transcoder->receive_raw_message(std::pair { sample.first, Candy::narrow_frame(sample.second) });
+        }
+    }
+
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(path, &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK)
+        return false;
+
+    bool ok = true;
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_prepare_v2(db, "SELECT can_id, dlc, data FROM frames ORDER BY id", -1, &stmt, nullptr);
+    for (const auto& [ts, frame] : samples) {
+        if (sqlite3_step(stmt) != SQLITE_ROW ||
+            static_cast<canid_t>(sqlite3_column_int(stmt, 0)) != frame.can_id ||
+            sqlite3_column_int(stmt, 1) != frame.length ||
+            hex(frame.data, frame.length) != reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2))) {
+            std::cerr << "SQL frame row differs for a " << int(frame.length) << " byte frame" << std::endl;
+            ok = false;
+            break;
+        }
+    }
+    sqlite3_finalize(stmt);
+
+    sqlite3_prepare_v2(db, "SELECT raw_value FROM decoded_frames WHERE signal_name = 'Gauge_Tail' ORDER BY timestamp", -1, &stmt, nullptr);
+    for (size_t i = 0; ok && i < samples.size(); i += 2) {
+        if (sqlite3_step(stmt) != SQLITE_ROW || static_cast<uint64_t>(sqlite3_column_int64(stmt, 0)) != tail(samples[i].second)) {
+            std::cerr << "SQL Gauge_Tail row " << i / 2 << " differs" << std::endl;
+            ok = false;
+        }
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return ok;
+}
+
+bool check_frame_iterator(const std::vector<Sample>& samples) {
+    Candy::FramePacketEncoder encoder(Candy::FramePacketFormat::v1);
+    Candy::FramePacket packet;
+    encoder.begin(packet, 1700000000);
+    for (const auto& [ts, frame] : samples)
+        encoder.append(packet, static_cast<int32_t>((ts - samples.front().first) / std::chrono::milliseconds(1)), frame);
+
+    size_t i = 0;
+    for (auto it = Candy::begin(packet); it != Candy::end(packet); ++it, ++i) {
+        const auto& [ts, frame] = *it;
+        const auto& sent = samples[i].second;
+        bool fd = sent.flags & CANFD_FDF;
+        if (i >= samples.size() || ts != samples[i].first || frame.can_id != sent.can_id ||
+            frame.length != sent.length || bool(frame.flags & CANFD_FDF) != fd ||
+            std::memcmp(frame.data, sent.data, sent.length) != 0) {
+            std::cerr << "FramePacket record " << i << " decoded differently" << std::endl;
+            return false;
+        }
+    }
+    if (i != samples.size()) {
+        std::cerr << "FramePacket yielded " << i << " of " << samples.size() << " records" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== CAN FD Storage Test ===" << std::endl;
+    auto samples = make_samples();
+
+    if (!check_csv(samples)) return 1;
+    std::cout << "   ✓ CSV frames keep every payload byte, signals past byte 8 decode" << std::endl;
+
+    if (!check_sql(samples)) return 1;
+    std::cout << "   ✓ SQL frames keep every payload byte, signals past byte 8 decode" << std::endl;
+
+    if (!check_frame_iterator(samples)) return 1;
+    std::cout << "   ✓ FD and classic FramePacket records iterate in order" << std::endl;
+    return 0;
+}
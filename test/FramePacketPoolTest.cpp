@@ -0,0 +1,79 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include <Candy/Candy.h>
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    std::abort();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+int main() {
+    using namespace std::chrono;
+    std::cout << "=== FramePacket Pool Test ===" << std::endl;
+
+    Candy::V2CTranscoder transcoder;
+    if (!transcoder.parse_dbc(Candy::transmit_file("test/network.dbc")))
+        return 1;
+
+    std::vector<canid_t> ids = transcoder.message_ids();
+    CANTime stamp { seconds(1700000000) };
+    size_t packets = 0;
+    size_t frames = 0;
+
+    // one frame per millisecond, round robin over the DBC's messages
+    auto run = [&](milliseconds span) {
+        for (auto end = stamp + span; stamp < end; stamp += 1ms) {
+            CANFrame frame {};
+            frame.can_id = ids[frames++ % ids.size()];
+            frame.len = 8;
+            frame.data[0] = static_cast<uint8_t>(frames);
+
+            Candy::FramePacket packet = transcoder.transcode({ stamp, frame });
+            if (packet.is_empty()) continue;
+
+            ++packets;
+            transcoder.recycle(std::move(packet));
+        }
+    };
+
+    // the first publish periods fill the pool
+    run(10s);
+    size_t warm_packets = packets;
+    size_t warm_allocations = allocations;
+
+    run(60s);
+    size_t steady_allocations = allocations - warm_allocations;
+
+    const auto& stats = transcoder.packet_pool().stats();
+    std::cout << "   " << packets - warm_packets << " packets after warm-up, " << steady_allocations << " allocations; pool "
+              << stats.allocated << " allocated, " << stats.reused << " reused, " << stats.dropped << " dropped" << std::endl;
+
+    if (warm_packets == 0 || packets - warm_packets < 20 || steady_allocations != 0 || stats.reused == 0) {
+        std::cerr << "Steady-state transcoding allocated" << std::endl;
+        return 1;
+    }
+
+    // a consumer that keeps its packets still gets fresh buffers
+    Candy::FramePacketPool pool(1);
+    Candy::FramePacket a = pool.acquire();
+    Candy::FramePacket b = pool.acquire();
+    pool.recycle(std::move(a));
+    pool.recycle(std::move(b));
+    if (pool.stats().allocated != 2 || pool.stats().dropped != 1 || pool.available() != 1) {
+        std::cerr << "Pool capacity not enforced" << std::endl;
+        return 1;
+    }
+
+    std::cout << "   ✓ no heap allocations in steady state" << std::endl;
+    return 0;
+}
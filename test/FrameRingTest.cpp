@@ -0,0 +1,69 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+
+#include <Candy/Candy.h>
+
+// Receiver that checks frames arrive complete and in order.
+struct OrderCheck : Candy::CANReceivable<OrderCheck> {
+    uint32_t next = 0;
+    size_t out_of_order = 0;
+
+    void receive_message(const Candy::CANMessage&) {}
+    void receive_metadata(const Candy::CANDataStreamMetadata&) {}
+    void receive_raw_message(const std::pair<CANTime, CANFrame>& sample) {
+        uint32_t seq;
+        std::memcpy(&seq, sample.second.data, sizeof(seq));
+        if (seq < next) out_of_order++;
+        next = seq + 1;
+    }
+};
+
+int main() {
+    std::cout << "=== FrameRing Test ===" << std::endl;
+
+    constexpr uint32_t frame_count = 2'000'000;
+    Candy::FrameRing<CANFrame> ring(4096);
+    OrderCheck check;
+
+    std::atomic<bool> done = false;
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread producer([&] {
+        for (uint32_t seq = 0; seq < frame_count; ++seq) {
+            std::pair<CANTime, CANFrame> sample {};
+            sample.second = Candy::generate_frame();
+            std::memcpy(sample.second.data, &seq, sizeof(seq));
+            while (!ring.try_push(sample))
+                std::this_thread::yield();
+        }
+        done = true;
+    });
+
+    size_t consumed = 0;
+    while (!done || !ring.empty()) {
+        size_t n = ring.drain_to(check, 256);
+        if (n == 0) std::this_thread::yield();
+        consumed += n;
+    }
+    producer.join();
+
+    auto end = std::chrono::steady_clock::now();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+    std::cout << "   " << consumed << " frames through a " << ring.capacity() << " slot ring in " << ms << "ms, "
+              << ring.overflowed() << " full, " << check.out_of_order << " out of order" << std::endl;
+
+    // overflow is counted, never blocks
+    Candy::FrameRing<CANFrame> small(4);
+    std::pair<CANTime, CANFrame> sample {};
+    size_t accepted = 0;
+    for (int i = 0; i < 10; ++i)
+        accepted += small.try_push(sample);
+
+    bool ok = consumed == frame_count && check.out_of_order == 0 && check.next == frame_count &&
+              accepted == 4 && small.overflowed() == 6;
+    std::cout << (ok ? "   PASS" : "   FAIL") << std::endl;
+    return ok ? 0 : 1;
+}
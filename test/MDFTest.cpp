@@ -0,0 +1,55 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+
+#include <Candy/Candy.h>
+
+int main() {
+    std::cout << "=== MDF Transcoder Test ===" << std::endl;
+
+    auto transcoder_opt = Candy::MDFTranscoder::create("./test_session.mf4", 5000);
+    if (!transcoder_opt || !transcoder_opt->parse_dbc(Candy::transmit_file("test/network.dbc"))) {
+        std::cerr << "Failed to set up MDFTranscoder." << std::endl;
+        return 1;
+    }
+    auto transcoder = std::move(*transcoder_opt);
+    std::vector<canid_t> ids(transcoder.message_ids().begin(), transcoder.message_ids().end());
+
+    const int num_frames = 100000;
+    std::mt19937 gen(42);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_frames; ++i) {
+        std::pair<CANTime, CANFrame> sample {};
+        sample.first = CANTime(std::chrono::microseconds(1700000000000000ll + i * 250));
+        sample.second.can_id = ids[gen() % ids.size()];
+        sample.second.len = 8;
+        for (int j = 0; j < 8; ++j)
+            sample.second.data[j] = static_cast<uint8_t>(gen());
+        transcoder.receive_raw_message(sample);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "   wrote " << num_frames << " frames in " << elapsed.count() << "ms" << std::endl;
+
+    // frames come back from the CAN_DataFrame group with their exact timestamps
+    size_t total = 0;
+    for (canid_t id : ids) {
+        auto messages = transcoder.transmit_messages(id);
+        total += messages.size();
+        for (size_t i = 1; i < messages.size(); ++i) {
+            auto step = messages[i].sample.first - messages[i - 1].sample.first;
+            if (step <= CANTime::duration::zero() || step % std::chrono::microseconds(250) != CANTime::duration::zero() ||
+                messages[i].signal_count != messages[0].signal_count) {
+                std::cerr << "Message " << id << " row " << i << " read back wrong" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    if (total != num_frames) {
+        std::cerr << "Read back " << total << " frames, expected " << num_frames << std::endl;
+        return 1;
+    }
+
+    std::cout << "   ✓ " << total << " frames read back" << std::endl;
+    return 0;
+}
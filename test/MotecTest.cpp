@@ -1,5 +1,7 @@
 #include <iostream>
 #include <chrono>
+#include <cmath>
+#include <cstring>
 
 #include <Candy/Candy.h>
 
@@ -37,39 +39,51 @@ int main() {
     
     Candy::MotecGenerator generator("test/motec_test.csv");
 
-    bool parsed_csv = generator.parse_csv();
+    bool parsed_csv = generator.parse_dbc(Candy::transmit_file("test/motec.dbc")) && generator.parse_csv();
 
     if (!parsed_csv) {
         std::cerr << "Failed to parse Motec CSV file." << std::endl;
         return 1;
     }
+    std::cout << "   ✓ " << generator.bound_columns() << " channels bound, session " << generator.header().session
+              << " at " << generator.header().venue << std::endl;
 
+    auto motec = Candy::MotecTranscoder::create("./test_session.ld", generator.header());
+    if (!motec || !motec->parse_dbc(Candy::transmit_file("test/motec.dbc"))) {
+        std::cerr << "Failed to set up MotecTranscoder." << std::endl;
+        return 1;
+    }
 
-    /*
-    for (int i = 0; i < num_frames; ++i) {
-        // Generate realistic CAN frame
-        std::pair<CANTime, CANFrame> sample;
-        sample.second.can_id = can_id_dist(gen);
-        sample.second.len = 8;
-        
-        // Fill with random data
-        for (int j = 0; j < 8; ++j) {
-            sample.second.data[j] = data_dist(gen);
+    start = std::chrono::high_resolution_clock::now();
+    size_t frames = 0;
+    double last_distance = 0.0;
+    while (const auto* sample = generator.get_frame()) {
+        transcoder_ref.receive_raw_message(*sample);
+        motec->receive_raw_message(*sample);
+        if (sample->second.can_id == 257) {
+            uint32_t raw;
+            std::memcpy(&raw, sample->second.data, sizeof(raw));
+            last_distance = raw * 0.001;
         }
-        
-        Candy::CANTime timestamp = std::chrono::system_clock::now();
-
-        transcoder.transcode(sample);
+        ++frames;
     }
-    
-    // Final processing statistics
     end = std::chrono::high_resolution_clock::now();
     auto processing_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-    
-    std::cout << "\n   Frame generation completed in " << processing_time.count() << "ms" << std::endl;
-    std::cout << "   Average generation rate: " << (double)num_frames / (processing_time.count() / 1000.0) << " frames/sec" << std::endl;
-    
-    // Only use blocking flush at the very end
-    std::cout << "   Final flush (blocking)..." << std::endl;
-    */
-}
\ No newline at end of file
+    std::cout << "   ✓ " << frames << " frames in " << processing_time.count() << "ms" << std::endl;
+
+    if (frames == 0 || frames % generator.bound_columns() != 0 || last_distance != 55.0) {
+        std::cerr << "Read " << frames << " frames, last Distance " << last_distance << std::endl;
+        return 1;
+    }
+
+    // Test 3: the .ld log holds every row at the CSV's sample rate
+    std::cout << "\n3. Reading back the MoTeC log..." << std::endl;
+    auto distance = motec->transmit_messages(257);
+    if (distance.empty() || distance.back().signal_count != 1 ||
+        std::abs(distance.back().get_signal_value("Distance").value_or(0.0) - 55.0) > 1e-3) {
+        std::cerr << "Distance channel read back wrong" << std::endl;
+        return 1;
+    }
+    std::cout << "   ✓ " << distance.size() << " Distance samples read back" << std::endl;
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <Candy/Candy.h>
+
+// A V2C-style packet: utc header, then int32 millisecond offsets and frames.
+Candy::FramePacket make_packet(uint32_t index, std::mt19937& gen) {
+    Candy::FramePacket packet;
+    packet.prepare(1700000000 + index);
+    for (int32_t i = 0; i < 40; ++i) {
+        packet.append(i * 5);
+        if (i % 8 == 7) {
+            CANFlexibleFrame frame {};
+            frame.can_id = 0x200 + i;
+            frame.flags = CANFD_FDF;
+            frame.length = 32;
+            for (auto& byte : frame.data) byte = static_cast<uint8_t>(gen());
+            packet.append(frame);
+        } else {
+            CANFrame frame {};
+            frame.can_id = 0x100 + i;
+            frame.len = static_cast<uint8_t>(1 + gen() % 8);
+            for (auto& byte : frame.data) byte = static_cast<uint8_t>(gen());
+            packet.append(frame);
+        }
+    }
+    return packet;
+}
+
+bool same_frames(const Candy::FramePacket& a, const Candy::FramePacket& b) {
+    auto it = Candy::begin(a);
+    auto other = Candy::begin(b);
+    for (; it != Candy::end(a); ++it, ++other) {
+        if (other == Candy::end(b)) return false;
+        auto [time, frame] = *it;
+        auto [other_time, other_frame] = *other;
+        if (time != other_time || frame.can_id != other_frame.can_id || frame.length != other_frame.length ||
+            std::memcmp(frame.data, other_frame.data, frame.length) != 0) {
+            return false;
+        }
+    }
+    return other == Candy::end(b);
+}
+
+int main() {
+    std::cout << "=== Packet Framing Test ===" << std::endl;
+
+    auto framer = Candy::PacketFramer::create();
+    if (!framer) return 1;
+
+    constexpr uint32_t packet_count = 200;
+    std::mt19937 gen(7);
+    std::vector<Candy::FramePacket> sent;
+    std::vector<uint8_t> stream;
+
+    // packet 50 never arrives, packet 100 arrives corrupted, and line noise precedes packet 150
+    for (uint32_t i = 0; i < packet_count; ++i) {
+        Candy::FramePacket packet = make_packet(i, gen);
+        auto framed = framer->frame(packet);
+        if (i == 50) continue;
+        if (i == 150) stream.insert(stream.end(), { 'C', 'Y', 0x01, 0xFF, 'C', 0x00 });
+
+        size_t at = stream.size();
+        stream.insert(stream.end(), framed.begin(), framed.end());
+        if (i == 100) stream[at + Candy::packet_header_size + 30] ^= 0x5A;
+        sent.push_back(std::move(packet));
+    }
+
+    // fed in uneven pieces, as recv hands them over
+    Candy::PacketDeframer deframer;
+    std::vector<Candy::FramePacket> received;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t at = 0; at < stream.size();) {
+        size_t piece = std::min<size_t>(1 + gen() % 1500, stream.size() - at);
+        deframer.feed({ stream.data() + at, piece });
+        at += piece;
+        while (auto packet = deframer.next())
+            received.push_back(std::move(*packet));
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    const auto& stats = deframer.stats();
+    std::cout << "   " << stream.size() << " bytes in " << elapsed.count() << "us, " << stats.packets << " packets, "
+              << stats.lost << " lost, " << stats.crc_errors << " CRC errors" << std::endl;
+
+    if (stats.packets != packet_count - 2 || stats.lost != 2 || stats.crc_errors != 1 ||
+        deframer.last_sequence() != packet_count - 1) {
+        std::cerr << "Unexpected link statistics" << std::endl;
+        return 1;
+    }
+
+    // everything but the corrupted packet comes back frame for frame
+    size_t expected = 0;
+    for (const auto& packet : received) {
+        if (expected == 99) ++expected;
+        if (!same_frames(packet, sent[expected++])) {
+            std::cerr << "Packet " << expected - 1 << " came back different" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "   ✓ " << received.size() << " packets reassembled" << std::endl;
+
+    // an oversize packet is refused whole rather than sent truncated
+    const uint32_t sequence = framer->next_sequence();
+    std::vector<uint8_t> oversize(Candy::max_packet_size + 1);
+    if (!framer->frame(std::span<const uint8_t>(oversize)).empty() || framer->next_sequence() != sequence) {
+        std::cerr << "Oversize packet was framed" << std::endl;
+        return 1;
+    }
+    std::cout << "   ✓ oversize packet refused" << std::endl;
+
+    // a header claiming a 1 MiB body, past the deframer's bound, does not hold
+    // back the packets behind it
+    uint8_t forged[Candy::packet_header_size] = { 'C', 'Y', Candy::packet_version, 0 };
+    const uint32_t forged_size = 1024 * 1024;
+    std::memcpy(forged + 8, &forged_size, sizeof(forged_size));
+    std::memcpy(forged + 12, &forged_size, sizeof(forged_size));
+
+    Candy::PacketDeframer bounded(64 * 1024);
+    bounded.feed(forged);
+    size_t bounded_count = 0;
+    for (int i = 0; i < 3; ++i) {
+        bounded.feed(framer->frame(make_packet(i, gen)));
+        while (bounded.next()) ++bounded_count;
+    }
+    if (bounded_count != 3 || bounded.stats().skipped_bytes != sizeof(forged)) {
+        std::cerr << "Bounded deframer returned " << bounded_count << " of 3 packets" << std::endl;
+        return 1;
+    }
+    std::cout << "   ✓ header past the size bound skipped" << std::endl;
+    return 0;
+}
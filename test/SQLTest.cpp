@@ -1,11 +1,311 @@
 #include "Candy/Core/CANKernelTypes.hpp"
 #include <iostream>
 #include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <random>
 
+#include "sqlite3.h"
+
 #include <Candy/Candy.h>
 
+// five signal rows per frame, so a batch of frames spans several
+// 64-row inserts plus a remainder
+constexpr std::string_view batch_dbc = R"(VERSION ""
+
+NS_ :
+
+BS_:
+
+BU_: ECU V2C
+
+BO_ 256 Wide: 8 ECU
+ SG_ A : 0|8@1+ (1,0) [0|255] "" V2C
+ SG_ B : 8|8@1+ (1,0) [0|255] "" V2C
+ SG_ C : 16|8@1+ (1,0) [0|255] "" V2C
+ SG_ D : 24|8@1+ (1,0) [0|255] "" V2C
+ SG_ E : 32|8@1+ (1,0) [0|255] "" V2C
+
+BO_ 512 Paged: 8 ECU
+ SG_ Page M : 0|8@1+ (1,0) [0|255] "" V2C
+ SG_ Temp m0 : 8|16@1- (0.1,-40) [-40|200] "C" V2C
+ SG_ Volt m1 : 8|16@1+ (0.01,0) [0|600] "V" V2C
+)";
+
+void remove_db(const std::string& path) {
+    for (const char* suffix : { "", "-wal", "-shm" })
+        std::filesystem::remove(path + suffix);
+}
+
+int64_t query_int(sqlite3* db, const char* sql) {
+    sqlite3_stmt* stmt = nullptr;
+    int64_t value = -1;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK && sqlite3_step(stmt) == SQLITE_ROW)
+        value = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return value;
+}
+
+std::pair<CANTime, CANFrame> wide_sample(int i) {
+    std::pair<CANTime, CANFrame> sample { CANTime(std::chrono::milliseconds(1700000000000 + i)), {} };
+    sample.second.can_id = 256;
+    sample.second.len = CAN_MAX_DLEN;
+    for (int j = 0; j < 5; ++j) sample.second.data[j] = static_cast<uint8_t>(i + j);
+    return sample;
+}
+
+// a reader only ever sees whole committed batches, and the partial batch
+// left at destruction is written too
+bool check_batching() {
+    const std::string path = "./test_batch.db";
+    remove_db(path);
+
+    sqlite3* reader = nullptr;
+    {
+        auto transcoder = Candy::SQLTranscoder::create(path, 100);
+        if (!transcoder || !transcoder->parse_dbc(batch_dbc))
+            return false;
+        if (sqlite3_open_v2(path.c_str(), &reader, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK)
+            return false;
+
+        for (int i = 0; i < 150; ++i)
+            transcoder->receive_raw_message(wide_sample(i));
+        int64_t frames = query_int(reader, "SELECT count(*) FROM frames");
+        int64_t rows = query_int(reader, "SELECT count(*) FROM decoded_frames");
+        if (frames != 100 || rows != 500) {
+            std::cerr << "After one batch a reader saw " << frames << " frames, " << rows << " signal rows" << std::endl;
+            return false;
+        }
+
+        for (int i = 150; i < 1007; ++i)
+            transcoder->receive_raw_message(wide_sample(i));
+        frames = query_int(reader, "SELECT count(*) FROM frames");
+        rows = query_int(reader, "SELECT count(*) FROM decoded_frames");
+        if (frames != 1000 || rows != 5000) {
+            std::cerr << "After ten batches a reader saw " << frames << " frames, " << rows << " signal rows" << std::endl;
+            return false;
+        }
+    }
+
+    int64_t frames = query_int(reader, "SELECT count(*) FROM frames");
+    int64_t rows = query_int(reader, "SELECT count(*) FROM decoded_frames");
+    int64_t e_rows = query_int(reader, "SELECT count(*) FROM decoded_frames WHERE signal_name = 'E'");
+    // every row keeps its own frame's raw value, whichever insert it went through
+    int64_t wrong = query_int(reader, "SELECT count(*) FROM decoded_frames d JOIN frames f ON f.timestamp = d.timestamp "
+                                      "WHERE d.signal_name = 'C' AND d.raw_value != ((f.timestamp - 1700000000000 + 2) % 256)");
+    sqlite3_close(reader);
+    if (frames != 1007 || rows != 5035 || e_rows != 1007 || wrong != 0) {
+        std::cerr << "After destruction: " << frames << " frames, " << rows << " signal rows, "
+                  << e_rows << " E rows, " << wrong << " wrong raw values" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// rows pushed by receive_message stay pending until a flush, and follow a move
+bool check_move() {
+    const std::string path = "./test_move.db";
+    const std::string other_path = "./test_move_other.db";
+    remove_db(path);
+    remove_db(other_path);
+    {
+        auto transcoder = Candy::SQLTranscoder::create(path, 100, Candy::SQLSchema::normalized);
+        auto other = Candy::SQLTranscoder::create(other_path, 100, Candy::SQLSchema::normalized);
+        if (!transcoder || !other || !transcoder->parse_dbc(batch_dbc))
+            return false;
+
+        Candy::CANMessage message;
+        message.sample = wide_sample(0);
+        message.set_message_name("Wide");
+        message.add_signal("C", 1234.5);
+        transcoder->receive_message(message);
+
+        Candy::SQLTranscoder moved(std::move(*transcoder));
+        message.sample = wide_sample(1);
+        message.decoded_signals[0].value = 2345.5;
+        moved.receive_message(message);
+
+        *other = std::move(moved);
+    }
+
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK)
+        return false;
+    int64_t rows = query_int(db, "SELECT count(*) FROM decoded_frames WHERE signal_name = 'C' AND signal_value IN (1234.5, 2345.5)");
+    sqlite3_close(db);
+    if (rows != 2) {
+        std::cerr << "Moved transcoder wrote " << rows << " of 2 received signal rows" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// every column of every row as text, NULL as "NULL"
+std::vector<std::string> query_rows(sqlite3* db, const char* sql) {
+    std::vector<std::string> rows;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+        return rows;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        std::string row;
+        for (int col = 0; col < sqlite3_column_count(stmt); ++col) {
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+            row += text ? text : "NULL";
+            row += '|';
+        }
+        rows.push_back(row);
+    }
+    sqlite3_finalize(stmt);
+    return rows;
+}
+
+// the normalized views read back exactly what the text schema stores
+bool check_normalized() {
+    const std::string text_path = "./test_text_schema.db";
+    const std::string normalized_path = "./test_normalized.db";
+    remove_db(text_path);
+    remove_db(normalized_path);
+
+    std::vector<std::pair<CANTime, CANFrame>> samples;
+    for (int i = 0; i < 300; ++i) {
+        auto sample = wide_sample(i);
+        if (i % 3 == 1) {
+            sample.second.can_id = 512;
+            sample.second.data[0] = static_cast<uint8_t>(i % 2);
+        }
+        // an id outside the DBC, and a short frame
+        if (i % 3 == 2) {
+            sample.second.can_id = 0x7FF;
+            sample.second.len = static_cast<uint8_t>(i % 9);
+        }
+        samples.push_back(sample);
+    }
+
+    std::vector<Candy::CANMessage> text_readback, normalized_readback;
+    for (auto schema : { Candy::SQLSchema::text, Candy::SQLSchema::normalized }) {
+        bool normalized = schema == Candy::SQLSchema::normalized;
+        auto transcoder = Candy::SQLTranscoder::create(normalized ? normalized_path : text_path, 64, schema);
+        if (!transcoder || !transcoder->parse_dbc(batch_dbc))
+            return false;
+        for (const auto& sample : samples)
+            transcoder->receive_raw_message(sample);
+        (normalized ? normalized_readback : text_readback) = transcoder->transmit_messages(512);
+    }
+
+    sqlite3* text_db = nullptr;
+    sqlite3* normalized_db = nullptr;
+    sqlite3_open_v2(text_path.c_str(), &text_db, SQLITE_OPEN_READONLY, nullptr);
+    sqlite3_open_v2(normalized_path.c_str(), &normalized_db, SQLITE_OPEN_READONLY, nullptr);
+
+    bool ok = true;
+    for (const char* sql : {
+             "SELECT timestamp, can_id, dlc, data, message_name FROM frames ORDER BY id",
+             "SELECT timestamp, can_id, message_name, signal_name, signal_value, raw_value, unit, mux_value "
+             "FROM decoded_frames ORDER BY id" }) {
+        auto text_rows = query_rows(text_db, sql);
+        auto normalized_rows = query_rows(normalized_db, sql);
+        if (text_rows.empty() || text_rows != normalized_rows) {
+            size_t i = 0;
+            while (i < text_rows.size() && i < normalized_rows.size() && text_rows[i] == normalized_rows[i]) ++i;
+            std::cerr << "Normalized view differs at row " << i << " of " << sql << ": '"
+                      << (i < normalized_rows.size() ? normalized_rows[i] : "") << "' vs '"
+                      << (i < text_rows.size() ? text_rows[i] : "") << "'" << std::endl;
+            ok = false;
+        }
+    }
+    sqlite3_close(text_db);
+    sqlite3_close(normalized_db);
+    if (!ok) return false;
+
+    if (text_readback.size() != 100 || normalized_readback.size() != text_readback.size()) {
+        std::cerr << "Read back " << normalized_readback.size() << " normalized, " << text_readback.size() << " text messages" << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < text_readback.size(); ++i) {
+        const auto& a = text_readback[i];
+        const auto& b = normalized_readback[i];
+        if (a.sample.first != b.sample.first || a.sample.second.len != b.sample.second.len ||
+            std::memcmp(a.sample.second.data, b.sample.second.data, a.sample.second.len) != 0 ||
+            a.signal_count != 1 || b.signal_count != 1 || a.mux_value != b.mux_value ||
+            a.get_signal_value("Temp") != b.get_signal_value("Temp") ||
+            a.get_signal_value("Volt") != b.get_signal_value("Volt")) {
+            std::cerr << "Read back message " << i << " differs between the schemas" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// receive_message rows fill whole inserts outside any batch
+bool check_normalized_messages() {
+    const std::string path = "./test_normalized_messages.db";
+    remove_db(path);
+    {
+        auto transcoder = Candy::SQLTranscoder::create(path, 1000, Candy::SQLSchema::normalized);
+        if (!transcoder || !transcoder->parse_dbc(batch_dbc))
+            return false;
+
+        Candy::CANMessage message;
+        message.set_message_name("Wide");
+        message.add_signal("A", 0);
+        message.add_signal("B", 0);
+        for (int i = 0; i < 100; ++i) {
+            message.sample = wide_sample(i);
+            message.decoded_signals[0].value = 1000 + i;
+            message.decoded_signals[1].value = 2000 + i;
+            transcoder->receive_message(message);
+        }
+    }
+
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK)
+        return false;
+    int64_t rows = query_int(db, "SELECT count(*) FROM decoded_frames WHERE signal_value >= 1000");
+    int64_t sum = query_int(db, "SELECT sum(signal_value) FROM decoded_frames WHERE signal_name = 'B' AND signal_value >= 1000");
+    sqlite3_close(db);
+    if (rows != 200 || sum != 100 * 2000 + 99 * 100 / 2) {
+        std::cerr << "receive_message wrote " << rows << " of 200 signal rows" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// frames of one id in the same millisecond each read back their own signals
+bool check_same_millisecond() {
+    for (auto schema : { Candy::SQLSchema::text, Candy::SQLSchema::normalized }) {
+        const std::string path = "./test_same_ms.db";
+        remove_db(path);
+
+        auto transcoder = Candy::SQLTranscoder::create(path, 4, schema);
+        if (!transcoder || !transcoder->parse_dbc(batch_dbc))
+            return false;
+
+        const CANTime burst { std::chrono::milliseconds(1700000000000) };
+        for (int i = 0; i < 10; ++i) {
+            auto sample = wide_sample(10 * i);
+            sample.first = i < 7 ? burst : burst + std::chrono::milliseconds(1);
+            transcoder->receive_raw_message(sample);
+        }
+
+        auto messages = transcoder->transmit_messages_in_range(256, burst, burst);
+        if (messages.size() != 7) {
+            std::cerr << "Range query found " << messages.size() << " of 7 frames" << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < messages.size(); ++i) {
+            const auto& message = messages[i];
+            if (message.signal_count != 5 || message.sample.second.data[0] != 10 * i ||
+                message.get_signal_value("A") != message.sample.second.data[0] ||
+                message.get_signal_value("E") != message.sample.second.data[4]) {
+                std::cerr << "Frame " << i << " read back " << message.signal_count << " signals, A = "
+                          << message.get_signal_value("A").value_or(-1) << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 int main() {
     // Clean up any existing test database
     std::filesystem::remove("./test.db");
@@ -69,5 +369,20 @@ int main() {
     
     // Only use blocking flush at the very end
     std::cout << "   Final flush (blocking)..." << std::endl;
-        
-}
\ No newline at end of file
+
+    std::cout << "\n3. Batched inserts and transactions..." << std::endl;
+    if (!check_batching()) return 1;
+    std::cout << "   ✓ readers see whole batches; the partial batch is written at destruction" << std::endl;
+
+    std::cout << "\n4. Moving a transcoder..." << std::endl;
+    if (!check_move()) return 1;
+    std::cout << "   ✓ pending signal rows follow a move" << std::endl;
+
+    std::cout << "\n5. Normalized schema..." << std::endl;
+    if (!check_normalized() || !check_normalized_messages()) return 1;
+    std::cout << "   ✓ normalized views and readback match the text schema" << std::endl;
+
+    std::cout << "\n6. Range queries..." << std::endl;
+    if (!check_same_millisecond()) return 1;
+    std::cout << "   ✓ frames in the same millisecond keep their own signals" << std::endl;
+}
@@ -0,0 +1,88 @@
+#include <iostream>
+#include <chrono>
+#include <cstring>
+
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <Candy/Candy.h>
+
+// Needs a virtual CAN interface:
+//   sudo ip link add dev vcan0 type vcan && sudo ip link set vcan0 mtu 72 up
+
+static int open_writer(const char* interface_name) {
+    int fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+    if (fd < 0) return -1;
+
+    int enable = 1;
+    setsockopt(fd, SOL_CAN_BASE + CAN_RAW, 5 /* CAN_RAW_FD_FRAMES */, &enable, sizeof(enable));
+
+    SocketAddress addr {};
+    addr.familyAddress = AF_CAN;
+    addr.interfaceAddress = static_cast<int>(if_nametoindex(interface_name));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char** argv) {
+    const char* interface_name = argc > 1 ? argv[1] : "vcan0";
+
+    if (if_nametoindex(interface_name) == 0) {
+        std::cout << interface_name << " not present, skipping SocketCAN test" << std::endl;
+        return 0;
+    }
+
+    auto transcoder_opt = Candy::CSVTranscoder::create("./test_socketcan_output/", 1000);
+    if (!transcoder_opt) return 1;
+    auto& transcoder = *transcoder_opt;
+    if (!transcoder.parse_dbc(Candy::transmit_file("test/network.dbc"))) return 1;
+
+    auto source = Candy::SocketCANSource::create(interface_name, transcoder.message_ids());
+    if (!source) return 1;
+
+    int writer = open_writer(interface_name);
+    if (writer < 0) return 1;
+
+    constexpr int frame_count = 1000;
+    auto ids = transcoder.message_ids();
+
+    for (int i = 0; i < frame_count; i++) {
+        CANFrame frame = Candy::generate_frame();
+        frame.can_id = ids[i % ids.size()];
+        write(writer, &frame, sizeof(frame));
+    }
+
+    // not in the DBC, dropped by the kernel filter
+    CANFrame unknown {};
+    unknown.can_id = 0x7FF;
+    unknown.len = 8;
+    write(writer, &unknown, sizeof(unknown));
+
+    CANFlexibleFrame fd_frame {};
+    fd_frame.can_id = ids[0];
+    fd_frame.length = 64;
+    fd_frame.data[63] = 0xA5;
+    bool sent_fd = write(writer, &fd_frame, sizeof(fd_frame)) == sizeof(fd_frame);
+
+    auto start = std::chrono::steady_clock::now();
+
+    size_t received = 0, batches = 0;
+    while (size_t n = source->forward_to(transcoder, 100)) {
+        received += n;
+        batches++;
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    close(writer);
+
+    size_t expected = frame_count + (sent_fd ? 1 : 0);
+    std::cout << "Received " << received << "/" << expected << " frames in " << batches << " batches ("
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << "us), "
+              << source->dropped() << " dropped" << std::endl;
+
+    return received == expected ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <chrono>
+#include <set>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <Candy/Candy.h>
+
+Candy::FramePacket make_packet(uint32_t utc) {
+    Candy::FramePacket packet;
+    packet.prepare(utc);
+    for (int32_t j = 0; j < 20; ++j) {
+        CANFrame frame {};
+        frame.can_id = 0x100 + j;
+        frame.len = 8;
+        packet.append(j);
+        packet.append(frame);
+    }
+    return packet;
+}
+
+// a sender that restarts numbers from 0 again on a new port; its packets are
+// new data, not repeats, and a corrupt datagram from elsewhere changes nothing
+bool check_restart() {
+    auto receiver = Candy::UDPPacketReceiver::create(0);
+    if (!receiver) return false;
+
+    std::set<uint32_t> delivered;
+    auto collect = [&] {
+        while (auto packet = receiver->receive(50))
+            delivered.insert(packet->utc());
+    };
+
+    for (uint32_t run = 0; run < 2; ++run) {
+        auto sender = Candy::UDPPacketSender::create("127.0.0.1", receiver->port());
+        if (!sender) return false;
+        for (uint32_t i = 0; i < 50; ++i)
+            sender->send(make_packet(1000 * (run + 1) + i));
+        collect();
+
+        int stray = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in to {};
+        to.sin_family = AF_INET;
+        to.sin_port = htons(receiver->port());
+        to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        const uint8_t noise[] = { 'C', 'Y', Candy::packet_version, 0, 1, 2, 3 };
+        sendto(stray, noise, sizeof(noise), 0, reinterpret_cast<const sockaddr*>(&to), sizeof(to));
+        close(stray);
+        collect();
+    }
+
+    const auto& stats = receiver->stats();
+    if (delivered.size() != 100 || stats.packets != 100 || stats.duplicates != 0 || stats.restarts != 1 ||
+        stats.corrupt != 2 || stats.lost != 0) {
+        std::cerr << "Across a sender restart: " << delivered.size() << " delivered, " << stats.duplicates
+                  << " duplicates, " << stats.restarts << " restarts, " << stats.corrupt << " corrupt" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== UDP Link Test ===" << std::endl;
+
+    // one datagram in ten is lost each way, NACKs included
+    Candy::UDPLinkOptions options;
+    options.simulated_loss = 0.1;
+
+    options.simulated_loss_seed = 11;
+    auto receiver = Candy::UDPPacketReceiver::create(0, options);
+    if (!receiver) return 1;
+
+    options.simulated_loss_seed = 29;
+    auto sender = Candy::UDPPacketSender::create("127.0.0.1", receiver->port(), options);
+    if (!sender) return 1;
+
+    constexpr uint32_t packet_count = 500;
+    std::set<uint32_t> delivered;
+    size_t repeats = 0;
+    auto collect = [&](int timeout_ms) {
+        while (auto packet = receiver->receive(timeout_ms)) {
+            if (!delivered.insert(packet->utc()).second) ++repeats;
+            timeout_ms = 0;
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < packet_count; ++i) {
+        sender->send(make_packet(i));
+        sender->poll();
+        collect(1);
+    }
+
+    // let the last NACK rounds play out
+    auto settle = std::chrono::steady_clock::now() + 2 * options.deadline;
+    while (std::chrono::steady_clock::now() < settle) {
+        sender->poll();
+        collect(2);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    const auto& received = receiver->stats();
+    const auto& sent = sender->stats();
+    std::cout << "   " << delivered.size() << "/" << packet_count << " packets in " << elapsed.count() << "ms, "
+              << received.recovered << " recovered, " << received.lost << " lost, "
+              << sent.retransmits << " retransmits for " << sent.nacks << " NACKs" << std::endl;
+
+    if (repeats != 0 || received.recovered == 0 || delivered.size() < packet_count * 98 / 100 ||
+        received.packets != delivered.size()) {
+        std::cerr << "Loss recovery fell short" << std::endl;
+        return 1;
+    }
+
+    std::cout << "   ✓ loss recovered within the deadline" << std::endl;
+
+    if (!check_restart())
+        return 1;
+    std::cout << "   ✓ sender restart followed, stray datagrams ignored" << std::endl;
+    return 0;
+}
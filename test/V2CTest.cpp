@@ -1,6 +1,5 @@
 #include <iostream>
 #include <chrono>
-#include <bit>
 
 #include <Candy/Candy.h>
 
@@ -11,15 +10,14 @@ void print_frames(const Candy::FramePacket& fp, Candy::V2CTranscoder& transcoder
 
 	for (auto it = Candy::begin(fp); it != Candy::end(fp); ++it) {
 		const auto& [ts, frame] = *it;
-		auto frame_data = std::bit_cast<int64_t>(frame.data);
 		auto t = duration_cast<milliseconds>(ts.time_since_epoch()).count() / 1000.0;
 
 		std::cout << std::fixed
 			<< " CANFrame at t: " << t << "s, can_id: " << frame.can_id << std::endl;
 
 		auto msg = transcoder.find_message(frame.can_id);
-		for (const auto& sig : msg->signals(frame_data))
-			std::cout << "  " << sig.name() << ": " << (int64_t)sig.decode(frame_data) << std::endl;
+		for (const auto& sig : msg->signals(frame.data))
+			std::cout << "  " << sig.name() << ": " << (int64_t)sig.decode(frame.data) << std::endl;
 	}
 }
 
@@ -0,0 +1,56 @@
+# Build-time codec generation for a fixed DBC.
+#
+#   candy_generate_codecs(<target> DBC <file.dbc> [NAMESPACE <ns>] [OUTPUT <header name>])
+#
+# Runs candy_codegen on the DBC and makes the generated header available to
+# <target> as #include "<header name>" (default: <dbc name>_codecs.hpp).
+#
+# candy_codegen runs on the build machine. When cross-compiling (e.g. for the
+# Pi), point CANDY_CODEGEN_EXECUTABLE at a host build of it, or set
+# CMAKE_CROSSCOMPILING_EMULATOR so the target build can run.
+
+set(CANDY_CODEGEN_EXECUTABLE "" CACHE FILEPATH "Host candy_codegen to use instead of building one")
+
+if(CANDY_CODEGEN_EXECUTABLE)
+    add_executable(candy_codegen IMPORTED GLOBAL)
+    set_target_properties(candy_codegen PROPERTIES IMPORTED_LOCATION "${CANDY_CODEGEN_EXECUTABLE}")
+else()
+    add_executable(candy_codegen "${CMAKE_SOURCE_DIR}/utils/Codegen/candy_codegen.cpp")
+    target_link_libraries(candy_codegen PRIVATE candy)
+endif()
+
+function(candy_generate_codecs TARGET)
+    cmake_parse_arguments(ARG "" "DBC;NAMESPACE;OUTPUT" "" ${ARGN})
+
+    if(NOT ARG_DBC)
+        message(FATAL_ERROR "candy_generate_codecs: DBC is required")
+    endif()
+    if(CMAKE_CROSSCOMPILING AND NOT CANDY_CODEGEN_EXECUTABLE AND NOT CMAKE_CROSSCOMPILING_EMULATOR)
+        message(FATAL_ERROR "candy_generate_codecs: cross-compiling needs CANDY_CODEGEN_EXECUTABLE set to a host candy_codegen")
+    endif()
+
+    get_filename_component(_dbc "${ARG_DBC}" ABSOLUTE)
+    get_filename_component(_dbc_name "${ARG_DBC}" NAME_WE)
+
+    if(NOT ARG_NAMESPACE)
+        string(MAKE_C_IDENTIFIER "${_dbc_name}" ARG_NAMESPACE)
+    endif()
+    if(NOT ARG_OUTPUT)
+        set(ARG_OUTPUT "${_dbc_name}_codecs.hpp")
+    endif()
+
+    set(_gen_dir "${CMAKE_CURRENT_BINARY_DIR}/candy_codegen/${TARGET}")
+    set(_header "${_gen_dir}/${ARG_OUTPUT}")
+
+    add_custom_command(
+        OUTPUT "${_header}"
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${_gen_dir}"
+        COMMAND candy_codegen "${_dbc}" "${_header}" "${ARG_NAMESPACE}"
+        DEPENDS candy_codegen "${_dbc}"
+        COMMENT "Generating signal codecs from ${_dbc_name}"
+        VERBATIM
+    )
+
+    target_sources(${TARGET} PRIVATE "${_header}")
+    target_include_directories(${TARGET} PRIVATE "${_gen_dir}")
+endfunction()
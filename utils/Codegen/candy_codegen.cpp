@@ -0,0 +1,49 @@
+// candy_codegen <dbc> <output.hpp> [namespace]
+// Emits StaticSignalCodec instances and a switch-on-can_id decode for one DBC.
+
+#include <cstdio>
+#include <string>
+
+#include "Candy/Core/CANHelpers.hpp"
+#include "Candy/DBCInterpreters/CodecGenerator.hpp"
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <dbc> <output.hpp> [namespace]\n", argv[0]);
+        return 1;
+    }
+
+    std::string dbc_path = argv[1];
+    std::string out_path = argv[2];
+    std::string name_space = argc > 3 ? argv[3] : "candy_dbc";
+
+    std::string dbc = Candy::transmit_file(dbc_path);
+    if (dbc.empty()) {
+        fprintf(stderr, "candy_codegen: cannot read %s\n", dbc_path.c_str());
+        return 1;
+    }
+
+    Candy::CodecGenerator generator;
+    if (!generator.parse_dbc(dbc)) {
+        fprintf(stderr, "candy_codegen: failed to parse %s\n", dbc_path.c_str());
+        return 1;
+    }
+
+    std::string source_name = dbc_path.substr(dbc_path.find_last_of("/\\") + 1);
+    std::string header = generator.generate(name_space, source_name);
+
+    // leave an unchanged header alone so dependents don't rebuild
+    if (Candy::transmit_file(out_path) == header)
+        return 0;
+
+    FILE* out = fopen(out_path.c_str(), "wb");
+    if (!out) {
+        fprintf(stderr, "candy_codegen: cannot write %s\n", out_path.c_str());
+        return 1;
+    }
+    fwrite(header.data(), 1, header.size(), out);
+    fclose(out);
+
+    printf("candy_codegen: %zu messages from %s\n", generator.message_count(), source_name.c_str());
+    return 0;
+}